@@ -1318,6 +1318,11 @@ import hpdcache_pkg::*;
     begin : gen_mem_data_wbuf_width_assertion
         $fatal(1, "write buffer data width shall be l.e. to mem interface data width");
     end
+    if (HPDcacheCfg.u.refillCriticalWordFirst &&
+        !((HPDcacheCfg.clWidth / HPDcacheCfg.u.memDataWidth) inside {1, 2, 4, 8, 16}))
+    begin : gen_refill_wrap_len_assertion
+        $fatal(1, "critical-word-first refills shall be wrapping bursts of 2, 4, 8 or 16 beats");
+    end
     if (HPDcacheCfg.u.wbEn &&
         (2**(HPDcacheCfg.u.memIdWidth - 1) < (HPDcacheCfg.u.flushEntries + 1)))
     begin : gen_mem_id_flush_width_assertion
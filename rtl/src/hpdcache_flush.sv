@@ -316,7 +316,8 @@ import hpdcache_pkg::*;
         mem_req_id: hpdcache_mem_id_t'(flush_dir_free_ptr),
         mem_req_command: HPDCACHE_MEM_WRITE,
         mem_req_atomic: HPDCACHE_MEM_ATOMIC_ADD, /* NOP */
-        mem_req_cacheable: 1'b1
+        mem_req_cacheable: 1'b1,
+        mem_req_wrap: 1'b0
     };
     hpdcache_fifo_reg #(
         .FIFO_DEPTH     (2),
@@ -152,6 +152,21 @@ import hpdcache_pkg::*;
     localparam hpdcache_uint REFILL_LAST_CHUNK_WORD = HPDcacheCfg.u.clWords -
                                                       HPDcacheCfg.u.accessWords;
 
+    //  With critical-word-first refills, the memory returns the cacheline starting from the
+    //  chunk containing the requested word. The chunk is the biggest of the memory data and the
+    //  cache access widths. This is only possible if there are at least two chunks per line
+    localparam hpdcache_uint REFILL_MEM_WORDS = HPDcacheCfg.u.memDataWidth /
+                                                HPDcacheCfg.u.wordWidth;
+    localparam hpdcache_uint REFILL_WRAP_WORDS = (REFILL_MEM_WORDS > HPDcacheCfg.u.accessWords) ?
+                                                 REFILL_MEM_WORDS : HPDcacheCfg.u.accessWords;
+    localparam bit REFILL_CWF = HPDcacheCfg.u.refillCriticalWordFirst &&
+                                (HPDcacheCfg.u.clWords > REFILL_WRAP_WORDS);
+
+    //  Nb of beats of the first chunk written in the cache (critical-word-first refills)
+    localparam hpdcache_uint REFILL_FIRST_CHUNK_BEATS =
+            (HPDcacheCfg.accessWidth > HPDcacheCfg.u.memDataWidth) ?
+            (HPDcacheCfg.accessWidth / HPDcacheCfg.u.memDataWidth) : 1;
+
     typedef enum logic {
         MISS_REQ_IDLE = 1'b0,
         MISS_REQ_SEND = 1'b1
@@ -182,6 +197,7 @@ import hpdcache_pkg::*;
     miss_req_fsm_e           miss_req_fsm_q, miss_req_fsm_d;
     mshr_way_t               mshr_alloc_way_q, mshr_alloc_way_d;
     hpdcache_nline_t         mshr_alloc_nline_q;
+    hpdcache_word_t          mshr_alloc_word_q;
 
     refill_fsm_e             refill_fsm_q, refill_fsm_d;
     hpdcache_set_t           refill_set_q;
@@ -190,6 +206,7 @@ import hpdcache_pkg::*;
     hpdcache_req_sid_t       refill_sid_q;
     hpdcache_req_tid_t       refill_tid_q;
     hpdcache_word_t          refill_cnt_q, refill_cnt_d;
+    hpdcache_word_t          refill_word;
     logic                    refill_need_rsp_q;
     logic                    refill_is_prefetch_q;
     logic                    refill_wback_q;
@@ -206,10 +223,16 @@ import hpdcache_pkg::*;
     mem_resp_metadata_t      refill_fifo_resp_meta_wdata, refill_fifo_resp_meta_rdata;
     logic                    refill_fifo_resp_meta_w, refill_fifo_resp_meta_wok;
     logic                    refill_fifo_resp_meta_r, refill_fifo_resp_meta_rok;
+    logic                    refill_fifo_resp_meta_beat;
+    logic                    mem_resp_error_q, mem_resp_error;
 
     logic                    refill_fifo_resp_data_w, refill_fifo_resp_data_wok;
     hpdcache_refill_data_t   refill_fifo_resp_data_rdata;
-    logic                    refill_fifo_resp_data_r;
+    logic                    refill_fifo_resp_data_r, refill_fifo_resp_data_rok;
+    logic                    refill_chunk_rok;
+
+    logic                    refill_fifo_resp_err_r;
+    logic                    refill_late_error, refill_late_error_rok;
 
     logic                    refill_core_rsp_valid;
     hpdcache_req_data_t      refill_core_rsp_rdata;
@@ -281,12 +304,20 @@ import hpdcache_pkg::*;
     localparam hpdcache_uint REFILL_REQ_SIZE = $clog2(HPDcacheCfg.u.memDataWidth / 8);
     localparam hpdcache_uint REFILL_REQ_LEN = HPDcacheCfg.clWidth / HPDcacheCfg.u.memDataWidth;
 
-    assign mem_req_o.mem_req_addr = {mshr_alloc_nline_q, {HPDcacheCfg.clOffsetWidth{1'b0}} };
+    if (REFILL_CWF) begin : gen_mem_req_addr_cwf
+        //  wrapping burst starting at the chunk containing the requested word
+        assign mem_req_o.mem_req_addr = {mshr_alloc_nline_q,
+                mshr_alloc_word_q & ~hpdcache_word_t'(REFILL_WRAP_WORDS - 1),
+                {HPDcacheCfg.wordByteIdxWidth{1'b0}} };
+    end else begin : gen_mem_req_addr
+        assign mem_req_o.mem_req_addr = {mshr_alloc_nline_q, {HPDcacheCfg.clOffsetWidth{1'b0}} };
+    end
     assign mem_req_o.mem_req_len = hpdcache_mem_len_t'(REFILL_REQ_LEN-1);
     assign mem_req_o.mem_req_size = hpdcache_mem_size_t'(REFILL_REQ_SIZE);
     assign mem_req_o.mem_req_command = HPDCACHE_MEM_READ;
     assign mem_req_o.mem_req_atomic = HPDCACHE_MEM_ATOMIC_ADD;
     assign mem_req_o.mem_req_cacheable = 1'b1;
+    assign mem_req_o.mem_req_wrap = REFILL_CWF;
 
     if ((HPDcacheCfg.u.mshrSets > 1) && (HPDcacheCfg.u.mshrWays > 1))
     begin : gen_mem_id_mshr_sets_and_ways_gt_1
@@ -306,6 +337,7 @@ import hpdcache_pkg::*;
         if (mshr_alloc) begin
             mshr_alloc_way_q <= mshr_alloc_way_d;
             mshr_alloc_nline_q <= mshr_alloc_nline_i;
+            mshr_alloc_word_q <= mshr_alloc_word_i;
         end
     end
 
@@ -322,8 +354,27 @@ import hpdcache_pkg::*;
     //  Refill FSM
     //  {{{
 
-    //      ask permission to the refill arbiter if there is a pending refill
-    assign refill_req_valid_o  = refill_fsm_q == REFILL_IDLE ? refill_fifo_resp_meta_rok : 1'b0;
+    //      ask permission to the refill arbiter if there is a pending refill. With
+    //      critical-word-first refills, the metadata is written with the first chunk of the
+    //      response: wait for this chunk
+    assign refill_req_valid_o  = refill_fsm_q == REFILL_IDLE ? refill_fifo_resp_meta_rok &
+            (refill_fifo_resp_meta_rdata.is_inval | refill_chunk_rok) : 1'b0;
+
+    //      the data chunks of a critical-word-first refill may arrive while the refill is
+    //      ongoing. Otherwise, all the chunks are already in the FIFO when the refill starts
+    assign refill_chunk_rok = REFILL_CWF ? refill_fifo_resp_data_rok : 1'b1;
+
+    //      word of the cacheline written by the current chunk of the refill. With
+    //      critical-word-first refills, the first chunk is the one of the requested word
+    if (REFILL_CWF) begin : gen_refill_word_cwf
+        hpdcache_word_t refill_first_word;
+
+        assign refill_first_word = (refill_cnt_q == 0) ? mshr_ack_word : refill_core_rsp_word_q;
+        assign refill_word = (refill_first_word & ~hpdcache_word_t'(REFILL_WRAP_WORDS - 1)) +
+                             refill_cnt_q;
+    end else begin : gen_refill_word
+        assign refill_word = refill_cnt_q;
+    end
 
     always_comb
     begin : miss_resp_fsm_comb
@@ -351,6 +402,7 @@ import hpdcache_pkg::*;
 
         refill_fifo_resp_meta_r = 1'b0;
         refill_fifo_resp_data_r = 1'b0;
+        refill_fifo_resp_err_r  = 1'b0;
 
         mshr_ack_cs             = 1'b0;
         mshr_ack                = 1'b0;
@@ -394,88 +446,99 @@ import hpdcache_pkg::*;
             REFILL_WRITE: begin
                 automatic logic is_prefetch;
                 automatic hpdcache_uint core_rsp_word;
+                automatic hpdcache_uint refill_chunk;
+                automatic logic refill_last_chunk;
 
-                //  Respond to the core (when needed)
-                if (refill_cnt_q == 0) begin
-                    core_rsp_word = hpdcache_uint'(mshr_ack_word)/HPDcacheCfg.u.accessWords;
-
-                    if (hpdcache_uint'(core_rsp_word) == 0) begin
-                        refill_core_rsp_valid = mshr_ack_need_rsp;
-                        refill_dirty_valid = mshr_ack_dirty;
-                    end
+                refill_last_chunk = (hpdcache_uint'(refill_cnt_q) == REFILL_LAST_CHUNK_WORD);
 
-                    refill_core_rsp_sid = mshr_ack_src_id;
-                    refill_core_rsp_tid = mshr_ack_req_id;
-                    refill_core_rsp_error = refill_is_error_o;
-                    refill_core_rsp_word = hpdcache_word_t'(
-                        hpdcache_uint'(mshr_ack_word)/HPDcacheCfg.u.reqWords);
+                //  Wait for the next chunk of a critical-word-first refill (and for the error of
+                //  the whole response with the last one)
+                if (!refill_chunk_rok || (refill_last_chunk && !refill_late_error_rok)) begin
+                    refill_set_o = refill_set_q;
+                    refill_way = refill_way_q;
                 end else begin
-                    automatic hpdcache_uint refill_cnt;
-
-                    core_rsp_word = hpdcache_uint'(refill_core_rsp_word_q)/
-                                                   HPDcacheCfg.u.accessWords;
-                    refill_cnt = hpdcache_uint'(refill_cnt_q)/HPDcacheCfg.u.accessWords;
+                    refill_chunk = hpdcache_uint'(refill_word)/HPDcacheCfg.u.accessWords;
 
-                    if (core_rsp_word == refill_cnt) begin
-                        refill_core_rsp_valid = refill_need_rsp_q;
-                        refill_dirty_valid = refill_dirty_q;
-                    end
+                    //  Respond to the core (when needed)
+                    if (refill_cnt_q == 0) begin
+                        core_rsp_word = hpdcache_uint'(mshr_ack_word)/HPDcacheCfg.u.accessWords;
 
-                    refill_core_rsp_sid = refill_sid_q;
-                    refill_core_rsp_tid = refill_tid_q;
-                    refill_core_rsp_error = refill_is_error_o;
-                    refill_core_rsp_word = hpdcache_word_t'(
-                        hpdcache_uint'(refill_core_rsp_word_q)/HPDcacheCfg.u.reqWords);
-                end
+                        if (core_rsp_word == refill_chunk) begin
+                            refill_core_rsp_valid = mshr_ack_need_rsp;
+                            refill_dirty_valid = mshr_ack_dirty;
+                        end
 
-                //  Write the the data in the cache data array
-                if (refill_cnt_q == 0) begin
-                    refill_set_o = mshr_ack_cache_set;
-                    refill_way = mshr_ack_cache_way;
-                    is_prefetch = mshr_ack_is_prefetch;
-                    refill_dirty = mshr_ack_dirty;
-                    refill_dirty_wdata = mshr_ack_wdata;
-                    refill_dirty_be = mshr_ack_be;
-                end else begin
-                    refill_set_o = refill_set_q;
-                    refill_way = refill_way_q;
-                    is_prefetch = refill_is_prefetch_q;
-                    refill_dirty = refill_dirty_q;
-                    refill_dirty_wdata = refill_dirty_wdata_q;
-                    refill_dirty_be = refill_dirty_be_q;
-                end
-                refill_write_data_o = ~refill_is_error_o;
+                        refill_core_rsp_sid = mshr_ack_src_id;
+                        refill_core_rsp_tid = mshr_ack_req_id;
+                        refill_core_rsp_error = refill_is_error_o;
+                        refill_core_rsp_word = hpdcache_word_t'(
+                            hpdcache_uint'(mshr_ack_word)/HPDcacheCfg.u.reqWords);
+                    end else begin
+                        core_rsp_word = hpdcache_uint'(refill_core_rsp_word_q)/
+                                                       HPDcacheCfg.u.accessWords;
 
-                //  Consume chunk of data from the FIFO buffer in the memory interface
-                refill_fifo_resp_data_r = 1'b1;
+                        if (core_rsp_word == refill_chunk) begin
+                            refill_core_rsp_valid = refill_need_rsp_q;
+                            refill_dirty_valid = refill_dirty_q;
+                        end
 
-                //  Update directory on the last chunk of data
-                refill_cnt_d = refill_cnt_q + hpdcache_word_t'(HPDcacheCfg.u.accessWords);
+                        refill_core_rsp_sid = refill_sid_q;
+                        refill_core_rsp_tid = refill_tid_q;
+                        refill_core_rsp_error = refill_is_error_o;
+                        refill_core_rsp_word = hpdcache_word_t'(
+                            hpdcache_uint'(refill_core_rsp_word_q)/HPDcacheCfg.u.reqWords);
+                    end
 
-                if (hpdcache_uint'(refill_cnt_q) == REFILL_LAST_CHUNK_WORD) begin
-                    if (REFILL_LAST_CHUNK_WORD == 0) begin
-                        //  Special case: if the cache-line data can be written in a single cycle,
-                        //  wait an additional cycle to write the directory. This allows to prevent
-                        //  a RAM-to-RAM timing path between the MSHR and the DIR.
-                        refill_fsm_d = REFILL_WRITE_DIR;
+                    //  Write the the data in the cache data array
+                    if (refill_cnt_q == 0) begin
+                        refill_set_o = mshr_ack_cache_set;
+                        refill_way = mshr_ack_cache_way;
+                        is_prefetch = mshr_ack_is_prefetch;
+                        refill_dirty = mshr_ack_dirty;
+                        refill_dirty_wdata = mshr_ack_wdata;
+                        refill_dirty_be = mshr_ack_be;
                     end else begin
-                        //  Write the new entry in the cache directory
-                        refill_write_dir_o = 1'b1;
+                        refill_set_o = refill_set_q;
+                        refill_way = refill_way_q;
+                        is_prefetch = refill_is_prefetch_q;
+                        refill_dirty = refill_dirty_q;
+                        refill_dirty_wdata = refill_dirty_wdata_q;
+                        refill_dirty_be = refill_dirty_be_q;
+                    end
+                    refill_write_data_o = ~refill_is_error_o;
 
-                        //  Update the victim selection. Only in the following cases:
-                        //  - There is no error in response AND
-                        //  - It is a prefetch and the cfg_prefetch_updt_sel_victim_i is set OR
-                        //  - It is a read miss.
-                        refill_updt_sel_victim_o  =  ~refill_is_error_o &
-                                                    (~is_prefetch | cfg_prefetch_updt_sel_victim_i);
+                    //  Consume chunk of data from the FIFO buffer in the memory interface
+                    refill_fifo_resp_data_r = 1'b1;
 
-                        //  Update dependency flags in the retry table
-                        refill_updt_rtab_o  = 1'b1;
+                    //  Update directory on the last chunk of data
+                    refill_cnt_d = refill_cnt_q + hpdcache_word_t'(HPDcacheCfg.u.accessWords);
+
+                    if (refill_last_chunk) begin
+                        if (REFILL_LAST_CHUNK_WORD == 0) begin
+                            //  Special case: if the cache-line data can be written in a single
+                            //  cycle, wait an additional cycle to write the directory. This allows
+                            //  to prevent a RAM-to-RAM timing path between the MSHR and the DIR.
+                            refill_fsm_d = REFILL_WRITE_DIR;
+                        end else begin
+                            //  Write the new entry in the cache directory
+                            refill_write_dir_o = 1'b1;
 
-                        //  consume the response from the network
-                        refill_fifo_resp_meta_r = 1'b1;
+                            //  Update the victim selection. Only in the following cases:
+                            //  - There is no error in response AND
+                            //  - It is a prefetch and the cfg_prefetch_updt_sel_victim_i is set OR
+                            //  - It is a read miss.
+                            refill_updt_sel_victim_o  =  ~refill_is_error_o &
+                                    (~is_prefetch | cfg_prefetch_updt_sel_victim_i);
 
-                        refill_fsm_d = REFILL_IDLE;
+                            //  Update dependency flags in the retry table
+                            refill_updt_rtab_o  = 1'b1;
+
+                            //  consume the response from the network
+                            refill_fifo_resp_meta_r = 1'b1;
+                            refill_fifo_resp_err_r  = 1'b1;
+
+                            refill_fsm_d = REFILL_IDLE;
+                        end
                     end
                 end
             end
@@ -529,11 +592,16 @@ import hpdcache_pkg::*;
         endcase
     end
 
-    assign refill_is_error_o = (refill_fifo_resp_meta_rdata.r_error == HPDCACHE_MEM_RESP_NOK);
+    //  The error of a critical-word-first refill is the error of the beats of its first chunk
+    //  (METADATA fifo), or of the whole response once its last beat is received (ERROR fifo).
+    //  Thus an error on a later beat prevents the installation of the cacheline, and is reported
+    //  to the core if its response has not been sent yet
+    assign refill_is_error_o = (refill_fifo_resp_meta_rdata.r_error == HPDCACHE_MEM_RESP_NOK) |
+                               refill_late_error;
 
     assign refill_busy_o  = (refill_fsm_q != REFILL_IDLE);
     assign refill_nline_o = {refill_tag_q, refill_set_q};
-    assign refill_word_o  = refill_cnt_q;
+    assign refill_word_o  = refill_word;
 
     assign inval_nline_o = refill_fifo_resp_meta_rdata.inval_nline;
 
@@ -608,10 +676,24 @@ import hpdcache_pkg::*;
         assign refill_core_rsp_rdata = refill_data_o;
     end
 
-    /* FIXME: when multiple chunks, in case of error, the error bit is not
-     *        necessarily set on all chunks */
+    //  The error bit is not necessarily set on all the beats of a refill response. Keep the
+    //  error of the previous beats, and report it with the beat writing the METADATA fifo
+    //  (and with the last one in the ERROR fifo for critical-word-first refills)
+    always_ff @(posedge clk_i or negedge rst_ni)
+    begin : mem_resp_error_ff
+        if (!rst_ni) begin
+            mem_resp_error_q <= 1'b0;
+        end else if (mem_resp_valid_i && mem_resp_ready_o && !mem_resp_inval_i) begin
+            mem_resp_error_q <= ~mem_resp_i.mem_resp_r_last & mem_resp_error;
+        end
+    end
+
+    assign mem_resp_error = mem_resp_error_q |
+            (mem_resp_i.mem_resp_r_error == HPDCACHE_MEM_RESP_NOK);
+
     assign refill_fifo_resp_meta_wdata = '{
-        r_error    : mem_resp_i.mem_resp_r_error,
+        r_error    : (mem_resp_error & ~mem_resp_inval_i) ? HPDCACHE_MEM_RESP_NOK :
+                                                            mem_resp_i.mem_resp_r_error,
         r_id       : mem_resp_i.mem_resp_r_id,
         is_inval   : mem_resp_inval_i,
         inval_nline: mem_resp_inval_nline_i
@@ -647,7 +729,7 @@ import hpdcache_pkg::*;
         .wlast_i(mem_resp_i.mem_resp_r_last),
 
         .r_i    (refill_fifo_resp_data_r),
-        .rok_o  (/* unused */),
+        .rok_o  (refill_fifo_resp_data_rok),
         .rdata_o(refill_fifo_resp_data_rdata),
         .rlast_o(/* unused */)
     );
@@ -696,14 +778,65 @@ import hpdcache_pkg::*;
         assign refill_data_o = hpdcache_refill_data_t'(clean_data);
     end
 
+    //      The METADATA of a refill response is written with its last beat, or with the last
+    //      beat of its first chunk for critical-word-first refills (the refill starts before the
+    //      last beat). The error of the whole response is then known with its last beat: it is
+    //      written in the ERROR fifo. This fifo cannot be full as it has as many entries as the
+    //      METADATA fifo, and an entry of the METADATA fifo is only consumed with its error
+    if (REFILL_CWF) begin : gen_refill_meta_first_chunk
+        hpdcache_mem_len_t mem_resp_beat_q;
+        logic              refill_fifo_resp_err_w;
+        logic              refill_fifo_resp_err_rok;
+        logic              refill_fifo_resp_err_rdata;
+
+        always_ff @(posedge clk_i or negedge rst_ni)
+        begin : mem_resp_beat_ff
+            if (!rst_ni) begin
+                mem_resp_beat_q <= '0;
+            end else if (mem_resp_valid_i && mem_resp_ready_o && !mem_resp_inval_i) begin
+                mem_resp_beat_q <= mem_resp_i.mem_resp_r_last ? '0 : mem_resp_beat_q + 1;
+            end
+        end
+
+        assign refill_fifo_resp_meta_beat =
+                (mem_resp_beat_q == hpdcache_mem_len_t'(REFILL_FIRST_CHUNK_BEATS - 1));
+
+        assign refill_fifo_resp_err_w = mem_resp_valid_i & mem_resp_ready_o & ~mem_resp_inval_i &
+                                        mem_resp_i.mem_resp_r_last;
+
+        hpdcache_fifo_reg #(
+            .FIFO_DEPTH  (HPDcacheCfg.u.refillFifoDepth),
+            .fifo_data_t (logic)
+        ) i_r_error_fifo (
+            .clk_i,
+            .rst_ni,
+
+            .w_i    (refill_fifo_resp_err_w),
+            .wok_o  (/* unused */),
+            .wdata_i(mem_resp_error),
+
+            .r_i    (refill_fifo_resp_err_r),
+            .rok_o  (refill_fifo_resp_err_rok),
+            .rdata_o(refill_fifo_resp_err_rdata)
+        );
+
+        assign refill_late_error_rok = refill_fifo_resp_err_rok;
+        assign refill_late_error = (refill_fsm_q == REFILL_WRITE) & refill_fifo_resp_err_rok &
+                                   refill_fifo_resp_err_rdata;
+    end else begin : gen_refill_meta_last_beat
+        assign refill_fifo_resp_meta_beat = mem_resp_i.mem_resp_r_last;
+        assign refill_late_error_rok = 1'b1;
+        assign refill_late_error = 1'b0;
+    end
+
     //      The DATA fifo is only used for refill responses
     assign refill_fifo_resp_data_w = mem_resp_valid_i &
-            ((refill_fifo_resp_meta_wok | ~mem_resp_i.mem_resp_r_last) &
+            ((refill_fifo_resp_meta_wok | ~refill_fifo_resp_meta_beat) &
             ~mem_resp_inval_i);
 
     //      The METADATA fifo is used for both refill responses and invalidations
     assign refill_fifo_resp_meta_w = mem_resp_valid_i &
-            ((refill_fifo_resp_data_wok & mem_resp_i.mem_resp_r_last) |
+            ((refill_fifo_resp_data_wok & refill_fifo_resp_meta_beat) |
             mem_resp_inval_i);
 
     always_comb
@@ -713,7 +846,7 @@ import hpdcache_pkg::*;
             if (mem_resp_inval_i) begin
                 mem_resp_ready_o = refill_fifo_resp_meta_wok;
             end else begin
-                mem_resp_ready_o = (refill_fifo_resp_meta_wok | ~mem_resp_i.mem_resp_r_last) &
+                mem_resp_ready_o = (refill_fifo_resp_meta_wok | ~refill_fifo_resp_meta_beat) &
                                     refill_fifo_resp_data_wok;
             end
         end
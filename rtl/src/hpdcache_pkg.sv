@@ -417,6 +417,9 @@ package hpdcache_pkg;
         int unsigned cbufEntries;
         //  Use feedthrough FIFOs from the refill handler to the core
         bit refillCoreRspFeedthrough;
+        //  Refill cachelines with a wrapping burst starting at the chunk of the requested word,
+        //  and respond to the core when this chunk is written into the cache
+        bit refillCriticalWordFirst;
         //  Depth of the refill FIFO
         int refillFifoDepth;
         //  Write-Buffer number of entries in the directory
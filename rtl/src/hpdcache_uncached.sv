@@ -645,6 +645,7 @@ import hpdcache_pkg::*;
         mem_req_read_o.mem_req_size      = req_size_q;
         mem_req_read_o.mem_req_id        = mem_read_id_i;
         mem_req_read_o.mem_req_cacheable = 1'b0;
+        mem_req_read_o.mem_req_wrap      = 1'b0;
         mem_req_read_o.mem_req_command   = HPDCACHE_MEM_READ;
         mem_req_read_o.mem_req_atomic    = HPDCACHE_MEM_ATOMIC_ADD;
 
@@ -674,6 +675,7 @@ import hpdcache_pkg::*;
         mem_req_write_o.mem_req_size      = req_size_q;
         mem_req_write_o.mem_req_id        = mem_write_id_i;
         mem_req_write_o.mem_req_cacheable = 1'b0;
+        mem_req_write_o.mem_req_wrap      = 1'b0;
         unique case (1'b1)
             req_op_q.is_amo_sc: begin
                 mem_req_write_o.mem_req_command = HPDCACHE_MEM_ATOMIC;
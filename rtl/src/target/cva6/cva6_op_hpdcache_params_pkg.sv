@@ -195,6 +195,13 @@ package hpdcache_params_pkg;
     `endif
     localparam bit PARAM_REFILL_CORE_RSP_FEEDTHROUGH = `CONF_HPDCACHE_REFILL_CORE_RSP_FEEDTHROUGH;
 
+    //  HPDcache critical-word-first refills. The CVA6 subsystem shall set the
+    //  refillCriticalWordFirst member of its hpdcache_user_cfg_t with this parameter
+    `ifndef CONF_HPDCACHE_REFILL_CRITICAL_WORD_FIRST
+        `define CONF_HPDCACHE_REFILL_CRITICAL_WORD_FIRST 1'b0
+    `endif
+    localparam bit PARAM_REFILL_CRITICAL_WORD_FIRST = `CONF_HPDCACHE_REFILL_CRITICAL_WORD_FIRST;
+
     //  HPDcache depth of the refill FIFO
     `ifndef CONF_HPDCACHE_REFILL_FIFO_DEPTH
         `define CONF_HPDCACHE_REFILL_FIFO_DEPTH 32'd2
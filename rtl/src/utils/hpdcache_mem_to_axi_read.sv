@@ -51,6 +51,7 @@ import hpdcache_pkg::*;
 
     logic                lock;
     axi_pkg::cache_t     cache;
+    axi_pkg::burst_t     burst;
     hpdcache_mem_error_e resp;
 
     assign  lock  = (req_i.mem_req_command == HPDCACHE_MEM_ATOMIC) &&
@@ -62,6 +63,10 @@ import hpdcache_pkg::*;
                     axi_pkg::CACHE_RD_ALLOC   |
                     axi_pkg::CACHE_WR_ALLOC   : axi_pkg::CACHE_MODIFIABLE;
 
+    //  Wrapping bursts (i.e. critical-word-first refills). The HPDcache checks that these
+    //  have a legal length for AXI (2, 4, 8 or 16 beats)
+    assign  burst = req_i.mem_req_wrap ? axi_pkg::BURST_WRAP : axi_pkg::BURST_INCR;
+
     always_comb
     begin : resp_decode_comb
         case (axi_r_i.resp)
@@ -77,7 +82,7 @@ import hpdcache_pkg::*;
             axi_ar_o.addr     = req_i.mem_req_addr,
             axi_ar_o.len      = req_i.mem_req_len,
             axi_ar_o.size     = req_i.mem_req_size,
-            axi_ar_o.burst    = axi_pkg::BURST_INCR,
+            axi_ar_o.burst    = burst,
             axi_ar_o.lock     = lock,
             axi_ar_o.cache    = cache,
             axi_ar_o.prot     = '0,
@@ -38,6 +38,7 @@ module hpdcache_wrapper
       mshrUseRegbank: 1,
       cbufEntries: 4,
       refillCoreRspFeedthrough: 1'b1,
+      refillCriticalWordFirst: 1'b0,
       refillFifoDepth: 2,
       wbufDirEntries: 16,
       wbufDataEntries: 8,
@@ -0,0 +1,22 @@
+##
+#  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+#
+#  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+##
+##
+#  Date       : October, 2026
+#  Description: Link rules of the testbench microbenchmarks and self-checks.
+#               This file is loaded together with the Makefile generated by
+#               Verilator in the build directory, so the programs reuse the
+#               objects of the verilated model.
+##
+VPATH += $(TB_DIR)/bench
+
+hpdcache_test_mem_resp_model_bench: hpdcache_test_mem_resp_model_bench.o \
+        $(VK_GLOBAL_OBJS) $(VM_PREFIX)__ALL.a $(VM_HIER_LIBS)
+	$(LINK) $(LDFLAGS) $^ $(LOADLIBES) $(LDLIBS) $(LIBS) $(SC_LIBS) -o $@
+
+#  testbench without SystemC (HARNESS=cc) only
+hpdcache_test_mem_last_check: hpdcache_test_mem_last_check.o \
+        $(VK_GLOBAL_OBJS) $(VM_PREFIX)__ALL.a $(VM_HIER_LIBS)
+	$(LINK) $(LDFLAGS) $^ $(LOADLIBES) $(LDLIBS) $(LIBS) -o $@
@@ -0,0 +1,162 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Standalone microbenchmark (no SystemC) of the backing store of
+ *               the memory response model. It replays the access pattern of
+ *               the refills of readOperation on the paged mem_model, and on
+ *               the former backing store (one std::map node per word) as the
+ *               baseline
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mem_model.h"
+
+//  Former backing store of the memory model: one node per 64-bit word, and
+//  random initial values drawn on the first access of each word
+class map_mem_model
+{
+public:
+    uint64_t readMemory(uint64_t word_addr)
+    {
+        auto it = mem_m.find(word_addr);
+        if (it != mem_m.end()) return it->second;
+        const uint64_t value = ((uint64_t)rand() << 32) | (uint64_t)rand();
+        mem_m.insert(std::make_pair(word_addr, value));
+        return value;
+    }
+
+    void readMemory(uint64_t word_addr, uint64_t* buf, size_t n)
+    {
+        for (size_t i = 0; i < n; i++) buf[i] = readMemory(word_addr + i);
+    }
+
+    void writeMemory(uint64_t word_addr, uint64_t data, uint64_t mask)
+    {
+        auto it = mem_m.find(word_addr);
+        if (it == mem_m.end()) {
+            const uint64_t value = ((uint64_t)rand() << 32) | (uint64_t)rand();
+            it = mem_m.insert(std::make_pair(word_addr, value)).first;
+        }
+        it->second = (it->second & ~mask) | (data & mask);
+    }
+
+private:
+    std::map<uint64_t, uint64_t> mem_m;
+};
+
+struct bench_config_t
+{
+    uint64_t refills;
+    uint64_t footprint;
+    unsigned words;
+    uint64_t seed;
+};
+
+//  Refills of a cacheline at random addresses of the footprint (one read of
+//  the whole line per refill, as readOperation), and a write of one word after
+//  one refill out of 8
+template<typename M>
+static void
+run(const char* name, M& m, const bench_config_t& cfg)
+{
+    const uint64_t lines = cfg.footprint / (cfg.words * 8);
+    std::vector<uint64_t> buf(cfg.words);
+    uint64_t checksum = 0;
+
+    srand(cfg.seed);
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < cfg.refills; i++) {
+        const uint64_t line = (((uint64_t)rand() << 31) | (uint64_t)rand()) % lines;
+        const uint64_t word_addr = line * cfg.words;
+
+        m.readMemory(word_addr, buf.data(), cfg.words);
+        for (uint64_t w : buf) checksum += w;
+        if ((i % 8) == 0) m.writeMemory(word_addr, i, ~0ULL);
+    }
+    const double secs =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%-8s: %10.3f s  %12.0f refills/s  (checksum 0x%016llx)\n",
+           name,
+           secs,
+           cfg.refills / secs,
+           (unsigned long long)checksum);
+}
+
+static void
+usage(const char* argv)
+{
+    printf("usage: %s [options]\n"
+           "  -h               print this message\n"
+           "  -n <n>           nb of cacheline refills (default 1000000)\n"
+           "  -f <bytes>       size of the address range (default 1 GiB)\n"
+           "  -w <n>           nb of 64-bit words per cacheline (default 8)\n"
+           "  -r <n>           random seed (default 0)\n"
+           "  -m <model>       map, paged or both (default both)\n",
+           argv);
+}
+
+int
+main(int argc, char** argv)
+{
+    bench_config_t cfg = { 1000000, 1ULL << 30, 8, 0 };
+    std::string model = "both";
+    int c;
+
+    while ((c = getopt(argc, argv, "hn:f:w:r:m:")) != -1) {
+        switch (c) {
+            case 'n':
+                cfg.refills = strtoull(optarg, NULL, 0);
+                break;
+            case 'f':
+                cfg.footprint = strtoull(optarg, NULL, 0);
+                break;
+            case 'w':
+                cfg.words = strtoul(optarg, NULL, 0);
+                break;
+            case 'r':
+                cfg.seed = strtoull(optarg, NULL, 0);
+                break;
+            case 'm':
+                model = optarg;
+                break;
+            default:
+                usage(argv[0]);
+                return (c == 'h') ? 0 : 1;
+        }
+    }
+
+    if ((cfg.words == 0) || (cfg.footprint < cfg.words * 8)) {
+        printf("error: the footprint shall hold at least one cacheline\n");
+        return 1;
+    }
+
+    printf("%llu refills of %u words, footprint of %llu bytes, seed %llu\n",
+           (unsigned long long)cfg.refills,
+           cfg.words,
+           (unsigned long long)cfg.footprint,
+           (unsigned long long)cfg.seed);
+
+    if ((model == "map") || (model == "both")) {
+        map_mem_model m;
+        run("map", m, cfg);
+    }
+    if ((model == "paged") || (model == "both")) {
+        mem_model m("mem_model");
+        m.setSeed(cfg.seed);
+        run("paged", m, cfg);
+    }
+    return 0;
+}
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
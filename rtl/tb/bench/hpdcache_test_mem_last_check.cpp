@@ -0,0 +1,123 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Self-check of the memory model and of the scoreboard of the
+ *               testbench without SystemC. It drives write bursts on the
+ *               memory interface of the model (the cache is not evaluated),
+ *               and checks that the scoreboard reports a misplaced last flag
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <verilated.h>
+
+#include "Vhpdcache_wrapper.h"
+#include "logger.h"
+
+#include "hpdcache_test_cc_mem_model.h"
+#include "hpdcache_test_cc_ports.h"
+#include "hpdcache_test_cc_scoreboard.h"
+#include "hpdcache_test_defs.h"
+
+struct check_case_t
+{
+    const char* name;
+    int last_flit; //  flit with the last flag (-1: none)
+    size_t nb_errors; //  expected nb of scoreboard errors
+};
+
+static const unsigned MAX_CYCLES = 1000;
+
+//  Write a burst of two flits at address 0, with the last flag on the given
+//  flit. Return the nb of errors reported by the scoreboard
+static size_t
+run_case(Vhpdcache_wrapper* top, const check_case_t& c)
+{
+    const unsigned DATA_BYTES = HPDCACHE_MEM_DATA_WIDTH / 8;
+    const unsigned LEN = 1;
+    uint8_t data[DATA_BYTES];
+    uint8_t be[DATA_BYTES / 8];
+
+    unsigned size = 0;
+    while ((1U << size) < DATA_BYTES) size++;
+
+    hpdcache_test_cc_mem_model mem(top, 0);
+    hpdcache_test_cc_scoreboard sb(top);
+    mem.set_listener(&sb);
+
+    top->mem_req_read_valid_o = 0;
+    top->mem_resp_read_ready_o = 1;
+    top->mem_resp_write_ready_o = 1;
+
+    top->mem_req_write_valid_o = 1;
+    top->mem_req_write_addr_o = 0;
+    top->mem_req_write_len_o = LEN;
+    top->mem_req_write_size_o = size;
+    top->mem_req_write_id_o = 0;
+    top->mem_req_write_command_o = hpdcache_test_cc_mem_req::HPDCACHE_MEM_WRITE;
+    top->mem_req_write_atomic_o = 0;
+    top->mem_req_write_cacheable_o = 1;
+
+    memset(be, 0xff, sizeof(be));
+    hpdcache_test_cc_ports::set_bytes(top->mem_req_write_be_o, 0, be, sizeof(be));
+
+    unsigned flit = 0;
+    for (unsigned cycle = 0; cycle < MAX_CYCLES; cycle++) {
+        top->mem_req_write_data_valid_o = (flit <= LEN);
+        top->mem_req_write_last_o = ((int)flit == c.last_flit);
+        memset(data, flit, sizeof(data));
+        hpdcache_test_cc_ports::set_bytes(top->mem_req_write_data_o, 0, data, sizeof(data));
+
+        mem.negedge();
+        mem.sample();
+        sb.sample();
+
+        //  handshakes on the rising edge
+        if (top->mem_req_write_valid_o && top->mem_req_write_ready_i) {
+            top->mem_req_write_valid_o = 0;
+        }
+        if (top->mem_req_write_data_valid_o && top->mem_req_write_data_ready_i) {
+            flit++;
+        }
+        mem.posedge();
+    }
+
+    if (!sb.no_inflight()) {
+        std::cout << "error: the write request of the case \"" << c.name << "\" is not completed"
+                  << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    return sb.get_nb_error();
+}
+
+int
+main(int argc, char** argv)
+{
+    VerilatedContext ctx;
+    ctx.commandArgs(argc, argv);
+    Vhpdcache_wrapper top(&ctx, "i_top");
+
+    const check_case_t cases[] = {
+        { "last flag on the last flit", 1, 0 },
+        { "last flag on the first flit", 0, 1 },
+        { "no last flag", -1, 1 },
+    };
+
+    Logger::set_log_level(0);
+
+    int ret = EXIT_SUCCESS;
+    for (const check_case_t& c : cases) {
+        const size_t nb_errors = run_case(&top, c);
+        const bool pass = (nb_errors == c.nb_errors);
+        std::cout << (pass ? "PASS" : "FAIL") << ": " << c.name << " (" << nb_errors
+                  << " scoreboard errors, expected " << c.nb_errors << ")" << std::endl;
+        if (!pass) ret = EXIT_FAILURE;
+    }
+    return ret;
+}
@@ -0,0 +1,296 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Microbenchmark of the refill throughput of the memory response
+ *               model (hpdcache_test_mem_resp_model::readOperation)
+ */
+#include <chrono>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <systemc>
+
+#include <verilated.h>
+
+#include "hpdcache_test_defs.h"
+#include "hpdcache_test_transaction.h"
+#include "hpdcache_test_mem_resp_model.h"
+
+using namespace sc_core;
+using namespace sc_dt;
+
+static constexpr unsigned MEM_BYTES = HPDCACHE_MEM_DATA_WIDTH / 8;
+static constexpr unsigned CL_BYTES = (HPDCACHE_CL_WORDS * HPDCACHE_WORD_WIDTH) / 8;
+static constexpr unsigned REFILL_BEATS = (CL_BYTES > MEM_BYTES) ? (CL_BYTES / MEM_BYTES) : 1;
+
+//  Sends cacheline read requests (refills) to random addresses of the given
+//  footprint, and consumes all the responses without backpressure
+class mem_read_bench_driver : public sc_module
+{
+public:
+    sc_in<bool> clk_i;
+
+    sc_out<bool> mem_req_read_valid_o;
+    sc_in<bool> mem_req_read_ready_i;
+    sc_out<sc_bv<HPDCACHE_MEM_ADDR_WIDTH>> mem_req_read_addr_o;
+    sc_out<sc_bv<8>> mem_req_read_len_o;
+    sc_out<sc_bv<3>> mem_req_read_size_o;
+    sc_out<sc_bv<HPDCACHE_MEM_ID_WIDTH>> mem_req_read_id_o;
+    sc_out<sc_bv<2>> mem_req_read_command_o;
+    sc_out<sc_bv<4>> mem_req_read_atomic_o;
+    sc_out<bool> mem_req_read_cacheable_o;
+    sc_out<bool> mem_req_read_wrap_o;
+
+    sc_fifo_in<hpdcache_test_transaction_mem_read_req> sb_mem_read_req_i;
+    sc_fifo_in<hpdcache_test_transaction_mem_read_resp> sb_mem_read_resp_i;
+
+    uint64_t nb_refills;
+    uint64_t footprint;
+    uint64_t nb_beats;
+    uint64_t nb_cycles;
+
+    mem_read_bench_driver(sc_module_name nm)
+      : sc_module(nm)
+      , nb_refills(1000000)
+      , footprint(1ULL << 30)
+      , nb_beats(0)
+      , nb_cycles(0)
+    {
+        SC_THREAD(request_process);
+        sensitive << clk_i.pos();
+
+        SC_THREAD(sb_request_process);
+
+        SC_THREAD(sb_response_process);
+
+        SC_METHOD(count_cycles);
+        sensitive << clk_i.pos();
+    }
+
+private:
+#if SC_VERSION_MAJOR < 3
+    SC_HAS_PROCESS(mem_read_bench_driver);
+#endif
+
+    void request_process()
+    {
+        const uint64_t nlines = footprint / CL_BYTES;
+        unsigned size = 0;
+        while ((1U << size) < MEM_BYTES) size++;
+
+        mem_req_read_valid_o.write(false);
+        wait();
+
+        for (uint64_t n = 0; n < nb_refills; n++) {
+            const uint64_t nline = ((uint64_t(rand()) << 31) | uint64_t(rand())) % nlines;
+
+            mem_req_read_valid_o.write(true);
+            mem_req_read_addr_o.write(nline * CL_BYTES);
+            mem_req_read_len_o.write(REFILL_BEATS - 1);
+            mem_req_read_size_o.write(size);
+            mem_req_read_id_o.write(n % (1 << HPDCACHE_MEM_ID_WIDTH));
+            mem_req_read_command_o.write(hpdcache_test_transaction_mem_req::HPDCACHE_MEM_READ);
+            mem_req_read_atomic_o.write(0);
+            mem_req_read_cacheable_o.write(true);
+            mem_req_read_wrap_o.write(false);
+            do wait();
+            while (!mem_req_read_ready_i.read());
+        }
+        mem_req_read_valid_o.write(false);
+    }
+
+    void sb_request_process()
+    {
+        for (;;) sb_mem_read_req_i.read();
+    }
+
+    void sb_response_process()
+    {
+        for (;;) {
+            sb_mem_read_resp_i.read();
+            if (++nb_beats == nb_refills * REFILL_BEATS) sc_stop();
+        }
+    }
+
+    void count_cycles() { nb_cycles++; }
+};
+
+int
+sc_main(int argc, char** argv)
+{
+    uint64_t nb_refills = 1000000;
+    uint64_t footprint = 1ULL << 30;
+    unsigned long seed = 1234;
+
+    for (;;) {
+        static struct option long_options[] = { { "refills", required_argument, 0, 'n' },
+                                                { "footprint", required_argument, 0, 'f' },
+                                                { "seed", required_argument, 0, 'r' },
+                                                { 0, 0, 0, 0 } };
+        int option_index = 0;
+        int c = getopt_long(argc, argv, "n:f:r:", long_options, &option_index);
+        if (c == -1) break;
+
+        switch (c) {
+            case 'n':
+                nb_refills = strtoull(optarg, NULL, 0);
+                break;
+            case 'f':
+                footprint = strtoull(optarg, NULL, 0);
+                break;
+            case 'r':
+                seed = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                std::cout << "usage: " << argv[0]
+                          << " [-n <nb refills>] [-f <footprint bytes>] [-r <seed>]" << std::endl;
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (footprint < CL_BYTES) {
+        std::cout << "error: the footprint shall be at least one cacheline" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    srand(seed);
+    scv_random::set_global_seed(seed);
+    sc_core::sc_report_handler::set_verbosity_level(sc_core::SC_NONE);
+
+    sc_clock clk("clk", 1, SC_NS);
+    sc_signal<bool> rst_n;
+
+    sc_signal<bool> mem_req_read_ready;
+    sc_signal<bool> mem_req_read_valid;
+    sc_signal<sc_bv<HPDCACHE_MEM_ADDR_WIDTH>> mem_req_read_addr;
+    sc_signal<sc_bv<8>> mem_req_read_len;
+    sc_signal<sc_bv<3>> mem_req_read_size;
+    sc_signal<sc_bv<HPDCACHE_MEM_ID_WIDTH>> mem_req_read_id;
+    sc_signal<sc_bv<2>> mem_req_read_command;
+    sc_signal<sc_bv<4>> mem_req_read_atomic;
+    sc_signal<bool> mem_req_read_cacheable;
+    sc_signal<bool> mem_req_read_wrap;
+    sc_signal<bool> mem_resp_read_ready;
+    sc_signal<bool> mem_resp_read_valid;
+    sc_signal<sc_bv<2>> mem_resp_read_error;
+    sc_signal<sc_bv<HPDCACHE_MEM_ID_WIDTH>> mem_resp_read_id;
+    sc_signal<sc_bv<HPDCACHE_MEM_DATA_WIDTH>> mem_resp_read_data;
+    sc_signal<bool> mem_resp_read_last;
+    sc_signal<bool> mem_req_write_ready;
+    sc_signal<bool> mem_req_write_valid;
+    sc_signal<sc_bv<HPDCACHE_MEM_ADDR_WIDTH>> mem_req_write_addr;
+    sc_signal<sc_bv<8>> mem_req_write_len;
+    sc_signal<sc_bv<3>> mem_req_write_size;
+    sc_signal<sc_bv<HPDCACHE_MEM_ID_WIDTH>> mem_req_write_id;
+    sc_signal<sc_bv<2>> mem_req_write_command;
+    sc_signal<sc_bv<4>> mem_req_write_atomic;
+    sc_signal<bool> mem_req_write_cacheable;
+    sc_signal<bool> mem_req_write_data_ready;
+    sc_signal<bool> mem_req_write_data_valid;
+    sc_signal<sc_bv<HPDCACHE_MEM_DATA_WIDTH>> mem_req_write_data;
+    sc_signal<sc_bv<HPDCACHE_MEM_DATA_WIDTH / 8>> mem_req_write_be;
+    sc_signal<bool> mem_req_write_last;
+    sc_signal<bool> mem_resp_write_ready;
+    sc_signal<bool> mem_resp_write_valid;
+    sc_signal<bool> mem_resp_write_is_atomic;
+    sc_signal<sc_bv<2>> mem_resp_write_error;
+    sc_signal<sc_bv<HPDCACHE_MEM_ID_WIDTH>> mem_resp_write_id;
+
+    sc_fifo<hpdcache_test_transaction_mem_read_req> sb_mem_read_req;
+    sc_fifo<hpdcache_test_transaction_mem_read_resp> sb_mem_read_resp;
+    sc_fifo<hpdcache_test_transaction_mem_write_req> sb_mem_write_req;
+    sc_fifo<hpdcache_test_transaction_mem_write_resp> sb_mem_write_resp;
+
+    hpdcache_test_mem_resp_model mem("i_mem");
+    mem_read_bench_driver drv("i_drv");
+
+    //  No random delays: measure the cost of the model itself
+    scv_bag<pair<int, int>> no_delay;
+    no_delay.push(pair<int, int>(0, 0), 1);
+    mem.set_ra_ready_delay_distribution(no_delay);
+    mem.set_rd_valid_delay_distribution(no_delay);
+    mem.set_mem_seed(seed);
+
+    mem.clk_i(clk);
+    mem.rst_ni(rst_n);
+    mem.mem_req_read_ready_o(mem_req_read_ready);
+    mem.mem_req_read_valid_i(mem_req_read_valid);
+    mem.mem_req_read_addr_i(mem_req_read_addr);
+    mem.mem_req_read_len_i(mem_req_read_len);
+    mem.mem_req_read_size_i(mem_req_read_size);
+    mem.mem_req_read_id_i(mem_req_read_id);
+    mem.mem_req_read_command_i(mem_req_read_command);
+    mem.mem_req_read_atomic_i(mem_req_read_atomic);
+    mem.mem_req_read_cacheable_i(mem_req_read_cacheable);
+    mem.mem_req_read_wrap_i(mem_req_read_wrap);
+    mem.mem_resp_read_ready_i(mem_resp_read_ready);
+    mem.mem_resp_read_valid_o(mem_resp_read_valid);
+    mem.mem_resp_read_error_o(mem_resp_read_error);
+    mem.mem_resp_read_id_o(mem_resp_read_id);
+    mem.mem_resp_read_data_o(mem_resp_read_data);
+    mem.mem_resp_read_last_o(mem_resp_read_last);
+    mem.mem_req_write_ready_o(mem_req_write_ready);
+    mem.mem_req_write_valid_i(mem_req_write_valid);
+    mem.mem_req_write_addr_i(mem_req_write_addr);
+    mem.mem_req_write_len_i(mem_req_write_len);
+    mem.mem_req_write_size_i(mem_req_write_size);
+    mem.mem_req_write_id_i(mem_req_write_id);
+    mem.mem_req_write_command_i(mem_req_write_command);
+    mem.mem_req_write_atomic_i(mem_req_write_atomic);
+    mem.mem_req_write_cacheable_i(mem_req_write_cacheable);
+    mem.mem_req_write_data_ready_o(mem_req_write_data_ready);
+    mem.mem_req_write_data_valid_i(mem_req_write_data_valid);
+    mem.mem_req_write_data_i(mem_req_write_data);
+    mem.mem_req_write_be_i(mem_req_write_be);
+    mem.mem_req_write_last_i(mem_req_write_last);
+    mem.mem_resp_write_ready_i(mem_resp_write_ready);
+    mem.mem_resp_write_valid_o(mem_resp_write_valid);
+    mem.mem_resp_write_is_atomic_o(mem_resp_write_is_atomic);
+    mem.mem_resp_write_error_o(mem_resp_write_error);
+    mem.mem_resp_write_id_o(mem_resp_write_id);
+    mem.sb_mem_read_req_o(sb_mem_read_req);
+    mem.sb_mem_read_resp_o(sb_mem_read_resp);
+    mem.sb_mem_write_req_o(sb_mem_write_req);
+    mem.sb_mem_write_resp_o(sb_mem_write_resp);
+
+    drv.nb_refills = nb_refills;
+    drv.footprint = footprint;
+    drv.clk_i(clk);
+    drv.mem_req_read_valid_o(mem_req_read_valid);
+    drv.mem_req_read_ready_i(mem_req_read_ready);
+    drv.mem_req_read_addr_o(mem_req_read_addr);
+    drv.mem_req_read_len_o(mem_req_read_len);
+    drv.mem_req_read_size_o(mem_req_read_size);
+    drv.mem_req_read_id_o(mem_req_read_id);
+    drv.mem_req_read_command_o(mem_req_read_command);
+    drv.mem_req_read_atomic_o(mem_req_read_atomic);
+    drv.mem_req_read_cacheable_o(mem_req_read_cacheable);
+    drv.mem_req_read_wrap_o(mem_req_read_wrap);
+    drv.sb_mem_read_req_i(sb_mem_read_req);
+    drv.sb_mem_read_resp_i(sb_mem_read_resp);
+
+    rst_n.write(true);
+    mem_resp_read_ready.write(true);
+    mem_resp_write_ready.write(true);
+
+    std::cout << "Refills    : " << nb_refills << " x " << REFILL_BEATS << " beat(s) of "
+              << MEM_BYTES << " bytes" << std::endl
+              << "Footprint  : " << footprint << " bytes" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    sc_start();
+    auto end = std::chrono::steady_clock::now();
+
+    const double sec = std::chrono::duration<double>(end - start).count();
+    std::cout << std::fixed << std::setprecision(3) << "Wall time  : " << sec << " s" << std::endl
+              << "Cycles     : " << drv.nb_cycles << std::endl
+              << "Refills/s  : " << std::setprecision(0) << nb_refills / sec << std::endl
+              << "Beats/s    : " << drv.nb_beats / sec << std::endl;
+
+    return 0;
+}
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
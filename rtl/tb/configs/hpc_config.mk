@@ -30,6 +30,7 @@ CONF_HPDCACHE_MSHR_RAM_WBYTEENABLE=0
 CONF_HPDCACHE_MSHR_USE_REGBANK=0
 CONF_HPDCACHE_CBUF_ENTRIES=4
 CONF_HPDCACHE_REFILL_CORE_RSP_FEEDTHROUGH=1
+CONF_HPDCACHE_REFILL_CRITICAL_WORD_FIRST=0
 CONF_HPDCACHE_REFILL_FIFO_DEPTH=2
 CONF_HPDCACHE_WBUF_DIR_ENTRIES=16
 CONF_HPDCACHE_WBUF_DATA_ENTRIES=8
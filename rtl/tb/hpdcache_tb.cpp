@@ -16,17 +16,27 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <systemc>
+#include <vector>
 
 #include <verilated.h>
+#if HPDCACHE_TEST_CHECKPOINT
+#include <verilated_save.h>
+#endif
 #if VM_TRACE
 #include <verilated_vcd_sc.h>
+
+#include "hpdcache_test_flight_recorder.h"
 #endif
 
 #include "Vhpdcache_wrapper.h"
 #include "logger.h"
 
 #include "hpdcache_test_agent.h"
+#if CONF_HPDCACHE_TEST_MULTIREQ
+#include "hpdcache_test_core_ports.h"
+#endif
 #include "hpdcache_test_defs.h"
 #include "hpdcache_test_mem_resp_model.h"
 #include "hpdcache_test_scoreboard.h"
@@ -43,26 +53,51 @@ public:
     uint64_t max_cycles;
     uint64_t max_trans;
     size_t error_limit;
+    bool pipelined;
+    unsigned nrequesters;
+    uint64_t seed;
     bool trace_on;
     std::string trace_name;
     std::string file_name;
+    int trace_roi;
+    uint64_t trace_skip;
+    std::string latency_file;
+    uint64_t perf_period;
+    std::string perf_file;
+    std::string span_file;
+    uint64_t flight_cycles;
+    std::string checkpoint_save;
+    std::string checkpoint_restore;
+    std::string mem_timing;
+    std::string mem_limits;
+    std::string mem_order;
 
 private:
     std::string covname;
     std::shared_ptr<VerilatedVcdSc> tf;
-    std::shared_ptr<hpdcache_test_sequence> seq;
+#if VM_TRACE
+    std::shared_ptr<hpdcache_test_flight_recorder> fr;
+#endif
+    std::string seq_name;
+    std::vector<std::shared_ptr<hpdcache_test_sequence>> seqs;
 
 public:
     hpdcache_test()
       : max_cycles(1ULL << 30)
       , max_trans(100)
       , error_limit(0)
+      , pipelined(false)
+      , nrequesters(1)
+      , seed(0)
+      , trace_roi(-1)
+      , trace_skip(0)
+      , perf_period(0)
+      , flight_cycles(0)
       , covname("")
       , tf(nullptr)
-      , seq(nullptr)
     {
         top = std::make_shared<Vhpdcache_wrapper>("i_top");
-        hpdcache_test_agent_i = std::make_shared<hpdcache_test_agent>("i_agent");
+        agents.push_back(std::make_shared<hpdcache_test_agent>("i_agent"));
         hpdcache_test_mem_resp_model_i = std::make_shared<hpdcache_test_mem_resp_model>("i_mem");
         hpdcache_test_scoreboard_i = std::make_shared<hpdcache_test_scoreboard>("i_scoreboard");
     }
@@ -71,17 +106,82 @@ public:
     {
         std::cout << "Building the testbench..." << std::endl;
 
+        if (seqs.empty()) {
+            std::cout << "error: no sequence specified" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        if ((nrequesters < 1) || (nrequesters > NREQUESTERS)) {
+            std::cout << "error: the number of requesters shall be between 1 and " << NREQUESTERS
+                      << std::endl;
+            exit(EXIT_FAILURE);
+        }
+#if !CONF_HPDCACHE_TEST_MULTIREQ
+        if (nrequesters > 1) {
+            std::cout << "error: multiple requesters need a build with CONF_HPDCACHE_TEST_MULTIREQ=1"
+                      << std::endl;
+            exit(EXIT_FAILURE);
+        }
+#endif
+        if ((nrequesters > 1) && (seq_name == "from_trace")) {
+            std::cout << "error: the from_trace sequence supports a single requester" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        if (seq_name == "from_trace") {
+            std::static_pointer_cast<hpdcache_test_from_trace_seq>(seqs[0])->set_region(trace_roi,
+                                                                                       trace_skip);
+        } else if ((trace_roi >= 0) || (trace_skip > 0)) {
+            std::cout << "error: trace-roi and trace-skip need the from_trace sequence" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+#if !HPDCACHE_TEST_CHECKPOINT
+        if (!checkpoint_save.empty() || !checkpoint_restore.empty()) {
+            std::cout << "error: checkpoints need a build with CHECKPOINT=1" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+#endif
+
         top->clk_i(clk_i);
         top->rst_ni(rst_ni);
         top->wbuf_flush_i(wbuf_flush);
-        top->core_req_valid_i(core_req_valid);
-        top->core_req_ready_o(core_req_ready);
-        top->core_req_i(core_req);
-        top->core_req_abort_i(core_req_abort);
-        top->core_req_tag_i(core_req_tag);
-        top->core_req_pma_i(core_req_pma);
-        top->core_rsp_valid_o(core_rsp_valid);
-        top->core_rsp_o(core_rsp);
+#if CONF_HPDCACHE_TEST_MULTIREQ
+        core_ports = std::make_shared<hpdcache_test_core_ports>("i_core_ports");
+        top->core_req_valid_i(core_req_valid_all);
+        top->core_req_ready_o(core_req_ready_all);
+        top->core_req_i(core_req_all);
+        top->core_req_abort_i(core_req_abort_all);
+        top->core_req_tag_i(core_req_tag_all);
+        top->core_req_pma_i(core_req_pma_all);
+        top->core_rsp_valid_o(core_rsp_valid_all);
+        top->core_rsp_o(core_rsp_all);
+
+        core_ports->cache_req_valid_o(core_req_valid_all);
+        core_ports->cache_req_ready_i(core_req_ready_all);
+        core_ports->cache_req_o(core_req_all);
+        core_ports->cache_req_abort_o(core_req_abort_all);
+        core_ports->cache_req_tag_o(core_req_tag_all);
+        core_ports->cache_req_pma_o(core_req_pma_all);
+        core_ports->cache_rsp_valid_i(core_rsp_valid_all);
+        core_ports->cache_rsp_i(core_rsp_all);
+        for (int i = 0; i < NREQUESTERS; i++) {
+            core_ports->core_req_valid_i[i](core_req_valid[i]);
+            core_ports->core_req_ready_o[i](core_req_ready[i]);
+            core_ports->core_req_i[i](core_req[i]);
+            core_ports->core_req_abort_i[i](core_req_abort[i]);
+            core_ports->core_req_tag_i[i](core_req_tag[i]);
+            core_ports->core_req_pma_i[i](core_req_pma[i]);
+            core_ports->core_rsp_valid_o[i](core_rsp_valid[i]);
+            core_ports->core_rsp_o[i](core_rsp[i]);
+        }
+#else
+        top->core_req_valid_i(core_req_valid[0]);
+        top->core_req_ready_o(core_req_ready[0]);
+        top->core_req_i(core_req[0]);
+        top->core_req_abort_i(core_req_abort[0]);
+        top->core_req_tag_i(core_req_tag[0]);
+        top->core_req_pma_i(core_req_pma[0]);
+        top->core_rsp_valid_o(core_rsp_valid[0]);
+        top->core_rsp_o(core_rsp[0]);
+#endif
         top->mem_req_read_ready_i(mem_req_read_ready);
         top->mem_req_read_valid_o(mem_req_read_valid);
         top->mem_req_read_addr_o(mem_req_read_addr);
@@ -91,6 +191,7 @@ public:
         top->mem_req_read_command_o(mem_req_read_command);
         top->mem_req_read_atomic_o(mem_req_read_atomic);
         top->mem_req_read_cacheable_o(mem_req_read_cacheable);
+        top->mem_req_read_wrap_o(mem_req_read_wrap);
         top->mem_resp_read_ready_o(mem_resp_read_ready);
         top->mem_resp_read_valid_i(mem_resp_read_valid);
         top->mem_resp_read_error_i(mem_resp_read_error);
@@ -146,20 +247,64 @@ public:
         top->cfg_scrub_period_i(cfg_scrub_period);
         top->cfg_scrub_restart_i(cfg_scrub_restart);
 
-        hpdcache_test_agent_i->clk_i(clk_i);
-        hpdcache_test_agent_i->rst_ni(rst_ni);
-        hpdcache_test_agent_i->core_req_valid_o(core_req_valid);
-        hpdcache_test_agent_i->core_req_ready_i(core_req_ready);
-        hpdcache_test_agent_i->core_req_o(core_req);
-        hpdcache_test_agent_i->core_req_tag_o(core_req_tag);
-        hpdcache_test_agent_i->core_req_pma_o(core_req_pma);
-        hpdcache_test_agent_i->core_req_abort_o(core_req_abort);
-        hpdcache_test_agent_i->core_rsp_valid_i(core_rsp_valid);
-        hpdcache_test_agent_i->core_rsp_i(core_rsp);
-        hpdcache_test_agent_i->sb_core_req_o(sb_core_req);
-        hpdcache_test_agent_i->sb_core_resp_o(sb_core_resp);
-        hpdcache_test_agent_i->no_inflight_requests_i(no_inflight_requests);
+        //  One agent (and sequence) per requester. The agent i drives the
+        //  requester port i, and its sequence uses i as source ID
+        for (unsigned i = 1; i < nrequesters; i++) {
+            std::stringstream agent_name, seq_inst_name;
+            agent_name << "i_agent_" << i;
+            seq_inst_name << seq_name << "_" << i;
+            agents.push_back(std::make_shared<hpdcache_test_agent>(agent_name.str().c_str()));
+            seqs.push_back(make_sequence(seq_name, seq_inst_name.str()));
+        }
+        for (unsigned i = 0; i < nrequesters; i++) {
+            agents[i]->clk_i(clk_i);
+            agents[i]->rst_ni(rst_ni);
+            agents[i]->core_req_valid_o(core_req_valid[i]);
+            agents[i]->core_req_ready_i(core_req_ready[i]);
+            agents[i]->core_req_o(core_req[i]);
+            agents[i]->core_req_tag_o(core_req_tag[i]);
+            agents[i]->core_req_pma_o(core_req_pma[i]);
+            agents[i]->core_req_abort_o(core_req_abort[i]);
+            agents[i]->core_rsp_valid_i(core_rsp_valid[i]);
+            agents[i]->core_rsp_i(core_rsp[i]);
+            agents[i]->sb_core_req_o(sb_core_req[i]);
+            agents[i]->sb_core_resp_o(sb_core_resp[i]);
+            agents[i]->no_inflight_requests_i(no_inflight_requests);
+            agents[i]->set_pipelined(pipelined);
+        }
 
+        hpdcache_test_mem_resp_model_i->set_mem_seed(seed);
+        if (!mem_timing.empty() && (mem_timing != "random")) {
+            hpdcache_test_mem_timing::config_t cfg;
+            std::string err;
+            if (!hpdcache_test_mem_timing::parse(mem_timing, cfg, err)) {
+                std::cout << "error: " << err << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            std::cout << "info: setting memory timing model to " << mem_timing << std::endl;
+            hpdcache_test_mem_resp_model_i->set_timing(cfg);
+        }
+        if (!mem_limits.empty()) {
+            hpdcache_test_mem_resp_model::limits_t limits;
+            std::string err;
+            if (!hpdcache_test_mem_resp_model::parse_limits(mem_limits, limits, err)) {
+                std::cout << "error: " << err << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            std::cout << "info: setting memory limits to " << mem_limits << std::endl;
+            hpdcache_test_mem_resp_model_i->set_limits(limits);
+        }
+        if (!mem_order.empty()) {
+            hpdcache_test_mem_resp_model::order_e order;
+            unsigned hash_cycles;
+            std::string err;
+            if (!hpdcache_test_mem_resp_model::parse_order(mem_order, order, hash_cycles, err)) {
+                std::cout << "error: " << err << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            std::cout << "info: setting memory response order to " << mem_order << std::endl;
+            hpdcache_test_mem_resp_model_i->set_order(order, hash_cycles, seed);
+        }
         hpdcache_test_mem_resp_model_i->clk_i(clk_i);
         hpdcache_test_mem_resp_model_i->rst_ni(rst_ni);
         hpdcache_test_mem_resp_model_i->mem_req_read_ready_o(mem_req_read_ready);
@@ -171,6 +316,7 @@ public:
         hpdcache_test_mem_resp_model_i->mem_req_read_command_i(mem_req_read_command);
         hpdcache_test_mem_resp_model_i->mem_req_read_atomic_i(mem_req_read_atomic);
         hpdcache_test_mem_resp_model_i->mem_req_read_cacheable_i(mem_req_read_cacheable);
+        hpdcache_test_mem_resp_model_i->mem_req_read_wrap_i(mem_req_read_wrap);
         hpdcache_test_mem_resp_model_i->mem_resp_read_ready_i(mem_resp_read_ready);
         hpdcache_test_mem_resp_model_i->mem_resp_read_valid_o(mem_resp_read_valid);
         hpdcache_test_mem_resp_model_i->mem_resp_read_error_o(mem_resp_read_error);
@@ -202,8 +348,10 @@ public:
         hpdcache_test_mem_resp_model_i->sb_mem_write_resp_o(sb_mem_write_resp);
 
         hpdcache_test_scoreboard_i->clk_i(clk_i);
-        hpdcache_test_scoreboard_i->core_req_i(sb_core_req);
-        hpdcache_test_scoreboard_i->core_resp_i(sb_core_resp);
+        for (unsigned i = 0; i < nrequesters; i++) {
+            hpdcache_test_scoreboard_i->core_req_i(sb_core_req[i]);
+            hpdcache_test_scoreboard_i->core_resp_i(sb_core_resp[i]);
+        }
         hpdcache_test_scoreboard_i->mem_read_req_i(sb_mem_read_req);
         hpdcache_test_scoreboard_i->mem_read_resp_i(sb_mem_read_resp);
         hpdcache_test_scoreboard_i->mem_write_req_i(sb_mem_write_req);
@@ -226,12 +374,25 @@ public:
         hpdcache_test_scoreboard_i->evt_stall_i(evt_stall);
         hpdcache_test_scoreboard_i->no_inflight_requests_o(no_inflight_requests);
 
-        seq->set_max_transactions(this->max_trans);
-        seq->set_mem_resp_model(hpdcache_test_mem_resp_model_i);
-        hpdcache_test_agent_i->add_sequence(seq);
-        hpdcache_test_scoreboard_i->set_sequence(seq);
+        for (unsigned i = 0; i < nrequesters; i++) {
+            seqs[i]->set_sid(i);
+            seqs[i]->set_run_ahead(pipelined);
+            seqs[i]->set_max_transactions(this->max_trans);
+            seqs[i]->set_mem_resp_model(hpdcache_test_mem_resp_model_i);
+            agents[i]->add_sequence(seqs[i]);
+            hpdcache_test_scoreboard_i->set_sequence(seqs[i], i);
+        }
         hpdcache_test_scoreboard_i->set_mem_resp_model(hpdcache_test_mem_resp_model_i);
         hpdcache_test_scoreboard_i->set_error_limit(error_limit);
+        if (!latency_file.empty()) {
+            hpdcache_test_scoreboard_i->set_latency_file(latency_file);
+        }
+        if (perf_period > 0) {
+            hpdcache_test_scoreboard_i->set_perf_sampling(perf_period, perf_file);
+        }
+        if (!span_file.empty()) {
+            hpdcache_test_scoreboard_i->set_chrome_trace_file(span_file);
+        }
     }
 
     void simulate()
@@ -240,7 +401,18 @@ public:
         uint64_t cycles;
 
         std::cout << "Starting the simulation..." << std::endl;
-        std::cout << *seq << std::endl;
+        for (const auto& seq : seqs) {
+            std::cout << *seq;
+        }
+        std::cout << std::endl;
+
+#if HPDCACHE_TEST_CHECKPOINT
+        //  The state of the testbench is restored before the start of the
+        //  simulation (it may change the position in the trace), and the state
+        //  of the model after the reset sequence
+        VerilatedRestore ckpt;
+        if (!checkpoint_restore.empty()) restore_tb_state(ckpt);
+#endif
 
         cycles = 0;
         start = std::chrono::system_clock::now();
@@ -267,31 +439,62 @@ public:
         for (cycles = 0; cycles < 5; ++cycles) {
             clk_i = 0;
             sc_start(500, sc_core::SC_PS);
+            flight_record();
             clk_i = 1;
             sc_start(500, sc_core::SC_PS);
+            flight_record();
         }
         Verilated::assertOn(true);
         rst_ni = 0;
         for (cycles = 0; cycles < 5; ++cycles) {
             clk_i = 0;
             sc_start(500, sc_core::SC_PS);
+            flight_record();
             clk_i = 1;
             sc_start(500, sc_core::SC_PS);
+            flight_record();
         }
         rst_ni = 1;
+#if HPDCACHE_TEST_CHECKPOINT
+        if (!checkpoint_restore.empty()) {
+            ckpt >> *top;
+            ckpt.close();
+        }
+#endif
         for (; cycles < max_cycles; ++cycles) {
             clk_i = 0;
             sc_start(500, sc_core::SC_PS);
+            flight_record();
             if (Verilated::gotFinish()) break;
             clk_i = 1;
             sc_start(500, sc_core::SC_PS);
+            flight_record();
             if (Verilated::gotFinish()) break;
         }
+#if HPDCACHE_TEST_CHECKPOINT
+        if (!checkpoint_save.empty()) {
+            if (cycles < max_cycles) {
+                save_checkpoint(cycles);
+            } else {
+                std::cout << "error: timeout before the checkpoint" << std::endl;
+            }
+        }
+#endif
         end = std::chrono::system_clock::now();
+
+#if VM_TRACE
+        if ((fr != nullptr) && (cycles >= max_cycles)) {
+            fr->flush("timeout");
+        } else if ((fr != nullptr) && !no_inflight_requests.read()) {
+            //  the RTL ended the simulation ($finish or $fatal) while there
+            //  were still pending transactions
+            fr->flush("finish");
+        }
+#endif
         std::cout << "Finishing the simulation..." << std::endl;
 
 #ifdef CREATE_FILE
-        instance_trace_writter()->close_file();
+        instance_trace_writer()->close_file();
 #endif
 
         int ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
@@ -303,30 +506,54 @@ public:
 
     void set_sequence(std::string seq_name)
     {
-        if (seq != nullptr) {
+        if (!seqs.empty()) {
             std::cout << "error: only one sequence supported" << std::endl;
             exit(EXIT_FAILURE);
         }
 
+        //  The sequences of the other requesters (if any) are created when
+        //  building the testbench
+        this->seq_name = seq_name;
+        seqs.push_back(make_sequence(seq_name, seq_name));
+    }
+
+    std::shared_ptr<hpdcache_test_sequence> make_sequence(const std::string& seq_name,
+                                                          const std::string& inst_name)
+    {
+        const char* nm = inst_name.c_str();
+
         if (seq_name == "random") {
-            seq = std::make_shared<hpdcache_test_random_seq>("random");
+            return std::make_shared<hpdcache_test_random_seq>(nm);
         } else if (seq_name == "read") {
-            seq = std::make_shared<hpdcache_test_read_seq>("read");
+            return std::make_shared<hpdcache_test_read_seq>(nm);
         } else if (seq_name == "write") {
-            seq = std::make_shared<hpdcache_test_write_seq>("write");
+            return std::make_shared<hpdcache_test_write_seq>(nm);
         } else if (seq_name == "unique_set") {
-            seq = std::make_shared<hpdcache_test_unique_set_seq>("unique_set");
+            return std::make_shared<hpdcache_test_unique_set_seq>(nm);
         } else if (seq_name == "from_trace") {
-            seq = std::make_shared<hpdcache_test_from_trace_seq>("from_trace", file_name);
-        } else {
-            std::cout << "error: sequence " << seq_name << " not found" << std::endl;
-            exit(EXIT_FAILURE);
+            return std::make_shared<hpdcache_test_from_trace_seq>(nm, file_name);
         }
+
+        std::cout << "error: sequence " << seq_name << " not found" << std::endl;
+        exit(EXIT_FAILURE);
     }
 
     void trace(const std::string tracename)
     {
 #if VM_TRACE
+        if (flight_cycles > 0) {
+            std::cout << "Recording the waves of the last " << flight_cycles
+                      << " cycles (dumped into " << tracename << " on error or timeout)"
+                      << std::endl;
+            fr = std::make_shared<hpdcache_test_flight_recorder>(tracename, flight_cycles);
+            Verilated::traceEverOn(true);
+            top->trace(fr->get_vcd(), 99); // Trace 99 levels of hierarchy
+            fr->open();
+            hpdcache_test_scoreboard_i->set_error_handler(
+                [this]() { fr->flush("scoreboard error"); });
+            return;
+        }
+
         std::cout << "Dumping waves into " << tracename << std::endl;
         tf = std::make_shared<VerilatedVcdSc>();
         Verilated::traceEverOn(true);
@@ -335,6 +562,150 @@ public:
 #endif
     }
 
+    //  Record the current state of the signals in the flight recorder (if any)
+    void flight_record()
+    {
+#if VM_TRACE
+        if (fr != nullptr) {
+            const uint64_t ps = (uint64_t)(sc_time_stamp().to_seconds() * 1e12 + 0.5);
+            fr->dump(ps, ps / 1000);
+        }
+#endif
+    }
+
+#if HPDCACHE_TEST_CHECKPOINT
+    //  A checkpoint can only be restored by a testbench with the same
+    //  configuration of the HPDcache
+    static std::string checkpoint_signature()
+    {
+        std::stringstream ss;
+        ss << "HPDCACHE_CHECKPOINT_V2"
+           << " PA_WIDTH=" << HPDCACHE_PA_WIDTH << " SETS=" << HPDCACHE_SETS
+           << " WAYS=" << HPDCACHE_WAYS << " CL_WORDS=" << HPDCACHE_CL_WORDS
+           << " WORD_WIDTH=" << HPDCACHE_WORD_WIDTH << " REQ_WORDS=" << HPDCACHE_REQ_WORDS
+           << " MSHR_SETS=" << HPDCACHE_MSHR_SETS << " MSHR_WAYS=" << HPDCACHE_MSHR_WAYS
+           << " WBUF_DIR_ENTRIES=" << HPDCACHE_WBUF_DIR_ENTRIES
+           << " WBUF_DATA_ENTRIES=" << HPDCACHE_WBUF_DATA_ENTRIES
+           << " MEM_DATA_WIDTH=" << HPDCACHE_MEM_DATA_WIDTH
+           << " MEM_ID_WIDTH=" << HPDCACHE_MEM_ID_WIDTH;
+        return ss.str();
+    }
+
+    //  Drain the HPDcache (write buffer and pending transactions) once the
+    //  sequences are done, then save the state of the model and of the
+    //  testbench: memory and timing state of the memory model, shadow memory of
+    //  the scoreboard and position in the trace. The state of the random delay
+    //  distributions is not saved: the restored simulation restarts them from
+    //  its own seed
+    void save_checkpoint(uint64_t& cycles)
+    {
+        Verilated::gotFinish(false);
+        wbuf_flush = true;
+        for (;; ++cycles) {
+            if (cycles >= max_cycles) {
+                std::cout << "error: timeout while draining the cache before the checkpoint"
+                          << std::endl;
+                return;
+            }
+            clk_i = 0;
+            sc_start(500, sc_core::SC_PS);
+            flight_record();
+            clk_i = 1;
+            sc_start(500, sc_core::SC_PS);
+            flight_record();
+            wbuf_flush = false;
+            if (wbuf_empty.read() && no_inflight_requests.read()) break;
+        }
+
+        int32_t roi = -1;
+        uint64_t position = 0;
+        if (seq_name == "from_trace") {
+            auto seq = std::static_pointer_cast<hpdcache_test_from_trace_seq>(seqs[0]);
+            roi = seq->get_roi();
+            position = seq->get_position();
+        }
+
+        std::stringstream ss;
+        ss.write(reinterpret_cast<const char*>(&seed), sizeof(seed));
+        ss.write(reinterpret_cast<const char*>(&cycles), sizeof(cycles));
+        ss.write(reinterpret_cast<const char*>(&roi), sizeof(roi));
+        ss.write(reinterpret_cast<const char*>(&position), sizeof(position));
+        hpdcache_test_mem_resp_model_i->save_state(ss);
+        hpdcache_test_scoreboard_i->save_state(ss);
+
+        std::string signature = checkpoint_signature();
+        std::string tb_state = ss.str();
+        VerilatedSave os;
+        os.open(checkpoint_save.c_str());
+        if (!os.isOpen()) {
+            std::cout << "error: cannot create the checkpoint file " << checkpoint_save
+                      << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        os << signature << tb_state << *top;
+        os.close();
+
+        std::cout << "Checkpoint saved into " << checkpoint_save << " (cycle " << cycles;
+        if (seq_name == "from_trace") std::cout << ", trace position " << position;
+        std::cout << ")" << std::endl;
+    }
+
+    //  Restore the state of the testbench from the checkpoint, and leave the
+    //  file open to restore the model once the reset sequence is done
+    void restore_tb_state(VerilatedRestore& is)
+    {
+        is.open(checkpoint_restore.c_str());
+        if (!is.isOpen()) {
+            std::cout << "error: cannot open the checkpoint file " << checkpoint_restore
+                      << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        std::string signature, tb_state;
+        is >> signature;
+        if (signature != checkpoint_signature()) {
+            std::cout << "error: the checkpoint has been saved with another configuration"
+                      << std::endl
+                      << "    checkpoint : " << signature << std::endl
+                      << "    testbench  : " << checkpoint_signature() << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        is >> tb_state;
+
+        std::istringstream ss(tb_state);
+        uint64_t saved_seed = 0, saved_cycles = 0, position = 0;
+        int32_t roi = -1;
+        ss.read(reinterpret_cast<char*>(&saved_seed), sizeof(saved_seed));
+        ss.read(reinterpret_cast<char*>(&saved_cycles), sizeof(saved_cycles));
+        ss.read(reinterpret_cast<char*>(&roi), sizeof(roi));
+        ss.read(reinterpret_cast<char*>(&position), sizeof(position));
+        if (!ss || !hpdcache_test_mem_resp_model_i->restore_state(ss) ||
+            !hpdcache_test_scoreboard_i->restore_state(ss))
+        {
+            std::cout << "error: the checkpoint file " << checkpoint_restore << " is truncated"
+                      << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        //  The replay of the trace continues after the last record replayed
+        //  before the checkpoint (plus the records to skip, if any)
+        if (seq_name == "from_trace") {
+            if ((trace_roi >= 0) && (trace_roi != roi)) {
+                std::cout << "error: the checkpoint has been saved in the region " << roi
+                          << " of the trace" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            std::static_pointer_cast<hpdcache_test_from_trace_seq>(seqs[0])->set_region(
+                roi, position + trace_skip);
+        }
+
+        std::cout << "Restoring the checkpoint " << checkpoint_restore << " (saved at cycle "
+                  << saved_cycles << " with seed " << saved_seed;
+        if (seq_name == "from_trace") std::cout << ", trace position " << position;
+        std::cout << ")" << std::endl;
+    }
+#endif
+
     void coverage(const std::string filename) { this->covname = filename; }
 
     ~hpdcache_test()
@@ -353,21 +724,36 @@ public:
 
 private:
     std::shared_ptr<Vhpdcache_wrapper> top;
-    std::shared_ptr<hpdcache_test_agent> hpdcache_test_agent_i;
+    std::vector<std::shared_ptr<hpdcache_test_agent>> agents;
     std::shared_ptr<hpdcache_test_mem_resp_model> hpdcache_test_mem_resp_model_i;
     std::shared_ptr<hpdcache_test_scoreboard> hpdcache_test_scoreboard_i;
 
     sc_core::sc_signal<bool> clk_i;
     sc_core::sc_signal<bool> rst_ni;
     sc_core::sc_signal<bool> wbuf_flush;
-    sc_core::sc_signal<bool> core_req_valid;
-    sc_core::sc_signal<bool> core_req_ready;
-    sc_core::sc_signal<sc_bv<HPDCACHE_CORE_REQ_WIDTH>> core_req;
-    sc_core::sc_signal<bool> core_req_abort;
-    sc_core::sc_signal<sc_bv<HPDCACHE_TAG_WIDTH>> core_req_tag;
-    sc_core::sc_signal<sc_bv<HPDCACHE_REQ_PMA_WIDTH>> core_req_pma;
-    sc_core::sc_signal<bool> core_rsp_valid;
-    sc_core::sc_signal<sc_bv<HPDCACHE_CORE_RSP_WIDTH>> core_rsp;
+
+    //  Requester ports (only the first one is used in single-requester mode)
+    sc_core::sc_signal<bool> core_req_valid[NREQUESTERS];
+    sc_core::sc_signal<bool> core_req_ready[NREQUESTERS];
+    sc_core::sc_signal<sc_bv<HPDCACHE_CORE_REQ_WIDTH>> core_req[NREQUESTERS];
+    sc_core::sc_signal<bool> core_req_abort[NREQUESTERS];
+    sc_core::sc_signal<sc_bv<HPDCACHE_TAG_WIDTH>> core_req_tag[NREQUESTERS];
+    sc_core::sc_signal<sc_bv<HPDCACHE_REQ_PMA_WIDTH>> core_req_pma[NREQUESTERS];
+    sc_core::sc_signal<bool> core_rsp_valid[NREQUESTERS];
+    sc_core::sc_signal<sc_bv<HPDCACHE_CORE_RSP_WIDTH>> core_rsp[NREQUESTERS];
+
+#if CONF_HPDCACHE_TEST_MULTIREQ
+    //  Packed requester ports of the wrapper
+    std::shared_ptr<hpdcache_test_core_ports> core_ports;
+    sc_core::sc_signal<sc_bv<NREQUESTERS>> core_req_valid_all;
+    sc_core::sc_signal<sc_bv<NREQUESTERS>> core_req_ready_all;
+    sc_core::sc_signal<sc_bv<NREQUESTERS * HPDCACHE_CORE_REQ_WIDTH>> core_req_all;
+    sc_core::sc_signal<sc_bv<NREQUESTERS>> core_req_abort_all;
+    sc_core::sc_signal<sc_bv<NREQUESTERS * HPDCACHE_TAG_WIDTH>> core_req_tag_all;
+    sc_core::sc_signal<sc_bv<NREQUESTERS * HPDCACHE_REQ_PMA_WIDTH>> core_req_pma_all;
+    sc_core::sc_signal<sc_bv<NREQUESTERS>> core_rsp_valid_all;
+    sc_core::sc_signal<sc_bv<NREQUESTERS * HPDCACHE_CORE_RSP_WIDTH>> core_rsp_all;
+#endif
 
     sc_core::sc_signal<bool> mem_req_read_ready;
     sc_core::sc_signal<bool> mem_req_read_valid;
@@ -378,6 +764,7 @@ private:
     sc_core::sc_signal<sc_bv<2>> mem_req_read_command;
     sc_core::sc_signal<sc_bv<4>> mem_req_read_atomic;
     sc_core::sc_signal<bool> mem_req_read_cacheable;
+    sc_core::sc_signal<bool> mem_req_read_wrap;
     sc_core::sc_signal<bool> mem_resp_read_ready;
     sc_core::sc_signal<bool> mem_resp_read_valid;
     sc_core::sc_signal<sc_bv<2>> mem_resp_read_error;
@@ -404,8 +791,8 @@ private:
     sc_core::sc_signal<sc_bv<2>> mem_resp_write_error;
     sc_core::sc_signal<sc_bv<HPDCACHE_MEM_ID_WIDTH>> mem_resp_write_id;
 
-    sc_core::sc_fifo<hpdcache_test_transaction_req> sb_core_req;
-    sc_core::sc_fifo<hpdcache_test_transaction_resp> sb_core_resp;
+    sc_core::sc_fifo<hpdcache_test_transaction_req> sb_core_req[NREQUESTERS];
+    sc_core::sc_fifo<hpdcache_test_transaction_resp> sb_core_resp[NREQUESTERS];
     sc_core::sc_fifo<hpdcache_test_transaction_mem_read_req> sb_mem_read_req;
     sc_core::sc_fifo<hpdcache_test_transaction_mem_read_resp> sb_mem_read_resp;
     sc_core::sc_fifo<hpdcache_test_transaction_mem_write_req> sb_mem_write_req;
@@ -454,6 +841,11 @@ usage(const char* argv)
 int
 sc_main(int argc, char** argv)
 {
+#if HPDCACHE_TEST_THREADS > 1
+    //  the model is built with the testbench, and it takes its threads from the default context
+    std::cout << "info: the model runs on " << HPDCACHE_TEST_THREADS << " threads" << std::endl;
+    Verilated::defaultContextp()->threads(HPDCACHE_TEST_THREADS);
+#endif
     hpdcache_test test;
     bool write_coverage_data;
 
@@ -469,10 +861,28 @@ sc_main(int argc, char** argv)
                                                 { "coverage", required_argument, 0, 'c' },
                                                 { "sequence", required_argument, 0, 's' },
                                                 { "file", required_argument, 0, 'f' },
+                                                { "pipelined", no_argument, 0, 'p' },
+                                                { "requesters", required_argument, 0, 'q' },
+                                                { "trace-roi", required_argument, 0, 'o' },
+                                                { "trace-skip", required_argument, 0, 'k' },
+                                                { "latency-file", required_argument, 0, 'j' },
+                                                { "perf-period", required_argument, 0, 'S' },
+                                                { "perf-file", required_argument, 0, 'F' },
+                                                { "span-file", required_argument, 0, 'x' },
+                                                { "flight-recorder", required_argument, 0, 'w' },
+                                                { "checkpoint-save", required_argument, 0, 'C' },
+                                                { "checkpoint-restore", required_argument, 0, 'R' },
+                                                { "mem-timing", required_argument, 0, 'M' },
+                                                { "mem-limits", required_argument, 0, 'L' },
+                                                { "mem-order", required_argument, 0, 'O' },
                                                 { 0, 0, 0, 0 } };
 
         option_index = 0;
-        c = getopt_long(argc, argv, "hm:n:r:c:l:t:f:s:e:", long_options, &option_index);
+        c = getopt_long(argc,
+                        argv,
+                        "hm:n:r:c:l:t:f:s:e:pq:o:k:j:S:F:x:w:C:R:M:L:O:",
+                        long_options,
+                        &option_index);
         if (c == -1) break;
 
         switch (c) {
@@ -491,6 +901,7 @@ sc_main(int argc, char** argv)
                 std::cout << "info: setting random seed to " << seed << std::endl;
                 srand(seed);
                 scv_random::set_global_seed(seed);
+                test.seed = seed;
                 break;
             }
             case 't':
@@ -545,13 +956,55 @@ sc_main(int argc, char** argv)
                     exit(EXIT_FAILURE);
                 }
 #else
-                instance_trace_writter()->open_file(optarg);
+                instance_trace_writer()->open_file(optarg);
 #endif
                 break;
             }
             case 'e':
                 test.error_limit = atoll(optarg);
                 break;
+            case 'p':
+                test.pipelined = true;
+                break;
+            case 'q':
+                test.nrequesters = atoi(optarg);
+                break;
+            case 'o':
+                test.trace_roi = atoi(optarg);
+                break;
+            case 'k':
+                test.trace_skip = strtoull(optarg, NULL, 0);
+                break;
+            case 'j':
+                test.latency_file = optarg;
+                break;
+            case 'S':
+                test.perf_period = strtoull(optarg, NULL, 0);
+                break;
+            case 'F':
+                test.perf_file = optarg;
+                break;
+            case 'x':
+                test.span_file = optarg;
+                break;
+            case 'w':
+                test.flight_cycles = strtoull(optarg, NULL, 0);
+                break;
+            case 'C':
+                test.checkpoint_save = optarg;
+                break;
+            case 'R':
+                test.checkpoint_restore = optarg;
+                break;
+            case 'M':
+                test.mem_timing = optarg;
+                break;
+            case 'L':
+                test.mem_limits = optarg;
+                break;
+            case 'O':
+                test.mem_order = optarg;
+                break;
         }
     }
 
@@ -0,0 +1,356 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Entry point of the HPDCACHE testbench without SystemC. The
+ *               model is built by Verilator in C++ mode (--cc), and the clock
+ *               is driven by a plain loop. The components of the testbench
+ *               are stepped on each edge of the clock, in the same order as
+ *               the SystemC processes sensitive to that edge
+ */
+#include <chrono>
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <verilated.h>
+#if VM_TRACE
+#include <verilated_vcd_c.h>
+#endif
+
+#include "Vhpdcache_wrapper.h"
+#include "logger.h"
+
+#include "hpdcache_test_cc_driver.h"
+#include "hpdcache_test_cc_mem_model.h"
+#include "hpdcache_test_cc_scoreboard.h"
+#include "hpdcache_test_cc_sequence.h"
+#include "hpdcache_test_defs.h"
+#include "sequence_lib/hpdcache_test_cc_from_trace_seq.h"
+#include "sequence_lib/hpdcache_test_cc_random_seq.h"
+
+#if CONF_HPDCACHE_TEST_MULTIREQ
+#error "the testbench without SystemC supports a single requester"
+#endif
+
+class hpdcache_test_cc
+{
+public:
+    uint64_t max_cycles;
+    uint64_t max_trans;
+    size_t error_limit;
+    bool pipelined;
+    uint64_t seed;
+    bool trace_on;
+    std::string trace_name;
+    std::string seq_name;
+    std::string file_name;
+    int trace_roi;
+    uint64_t trace_skip;
+
+    hpdcache_test_cc()
+      : max_cycles(1ULL << 30)
+      , max_trans(100)
+      , error_limit(0)
+      , pipelined(false)
+      , seed(0)
+      , trace_on(false)
+      , trace_roi(-1)
+      , trace_skip(0)
+      , ctx(new VerilatedContext)
+    {
+    }
+
+    void build(int argc, char** argv)
+    {
+        ctx->commandArgs(argc, argv);
+#if VM_TRACE
+        //  tracing shall be enabled before the model is built
+        if (trace_on) ctx->traceEverOn(true);
+#endif
+#if HPDCACHE_TEST_THREADS > 1
+        //  the context shall provide the threads of the model before the model is built
+        std::cout << "info: the model runs on " << HPDCACHE_TEST_THREADS << " threads" << std::endl;
+        ctx->threads(HPDCACHE_TEST_THREADS);
+#endif
+        top.reset(new Vhpdcache_wrapper(ctx.get(), "i_top"));
+
+        mem.reset(new hpdcache_test_cc_mem_model(top.get(), seed));
+        sb.reset(new hpdcache_test_cc_scoreboard(top.get()));
+
+        if (seq_name.empty() || (seq_name == "random")) {
+            auto p = new hpdcache_test_cc_random_seq("random_seq", seed);
+            seq.reset(p);
+            seq->set_mem_model(mem.get());
+            p->set_error_segments();
+        } else if (seq_name == "from_trace") {
+            if (file_name.empty()) {
+                std::cout << "error: the from_trace sequence needs a trace file (-f)" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            auto p = new hpdcache_test_cc_from_trace_seq("from_trace_seq", file_name, seed);
+            p->set_region(trace_roi, trace_skip);
+            p->start();
+            seq.reset(p);
+            seq->set_mem_model(mem.get());
+        } else {
+            std::cout << "error: unsupported sequence (the testbench without SystemC supports"
+                      << " random and from_trace)" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        seq->set_max_transactions(max_trans);
+
+        mem->set_listener(sb.get());
+        sb->set_sequence(seq.get());
+        sb->set_mem_model(mem.get());
+        sb->set_error_limit(error_limit);
+
+        drv.reset(new hpdcache_test_cc_driver(top.get(), seq.get(), sb.get()));
+        drv->set_pipelined(pipelined);
+    }
+
+    void simulate()
+    {
+        std::chrono::time_point<std::chrono::system_clock> start, end;
+        uint64_t cycles;
+
+        std::cout << "Starting the simulation..." << std::endl << std::endl;
+
+        start = std::chrono::system_clock::now();
+
+#if VM_TRACE
+        if (trace_on) {
+            std::cout << "Dumping waves into " << trace_name << std::endl;
+            tf.reset(new VerilatedVcdC);
+            top->trace(tf.get(), 99); // Trace 99 levels of hierarchy
+            tf->open(trace_name.c_str());
+        }
+#endif
+
+        top->wbuf_flush_i = 0;
+        top->cfg_enable_i = 1;
+        top->cfg_wbuf_threshold_i = 1;
+        top->cfg_wbuf_reset_timecnt_on_write_i = 1;
+        top->cfg_wbuf_sequential_waw_i = 0;
+        top->cfg_wbuf_inhibit_write_coalescing_i = 0;
+        top->cfg_prefetch_updt_plru_i = 0;
+        top->cfg_error_on_cacheable_amo_i = 0;
+        top->cfg_rtab_single_entry_i = 0;
+        top->cfg_default_wb_i = 0;
+        top->cfg_scrub_enable_i = 0;
+        top->cfg_scrub_period_i = 10; // 2^10 = 1024
+        top->cfg_scrub_restart_i = 1;
+
+        ctx->assertOn(false);
+        top->rst_ni = 1;
+        for (cycles = 0; cycles < 5; ++cycles) reset_cycle();
+        ctx->assertOn(true);
+        top->rst_ni = 0;
+        for (cycles = 0; cycles < 5; ++cycles) reset_cycle();
+        top->rst_ni = 1;
+
+        for (; cycles < max_cycles; ++cycles) {
+            cycle();
+            if (drv->is_done() && sb->no_inflight()) break;
+        }
+
+        end = std::chrono::system_clock::now();
+
+        std::cout << "Finishing the simulation..." << std::endl;
+
+        int ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        std::cout << "Simulation wall clock time (sec): " << std::fixed << std::setprecision(2)
+                  << (double)ms / 1000 << std::endl;
+        std::cout << "Simulation real frequency       : " << std::fixed << std::setprecision(2)
+                  << (double)cycles / ms << " KHz" << std::endl;
+        std::cout << std::defaultfloat;
+
+        top->final();
+#if VM_TRACE
+        if (tf) tf->close();
+#endif
+
+        //  the components print their statistics when destroyed
+        drv.reset();
+        sb.reset();
+        seq.reset();
+        mem.reset();
+    }
+
+private:
+    std::unique_ptr<VerilatedContext> ctx;
+    std::unique_ptr<Vhpdcache_wrapper> top;
+#if VM_TRACE
+    std::unique_ptr<VerilatedVcdC> tf;
+#endif
+    std::unique_ptr<hpdcache_test_cc_mem_model> mem;
+    std::unique_ptr<hpdcache_test_cc_scoreboard> sb;
+    std::unique_ptr<hpdcache_test_cc_sequence> seq;
+    std::unique_ptr<hpdcache_test_cc_driver> drv;
+
+    void dump()
+    {
+#if VM_TRACE
+        if (tf) tf->dump(ctx->time());
+#endif
+    }
+
+    void reset_cycle()
+    {
+        top->clk_i = 0;
+        ctx->timeInc(500);
+        top->eval();
+        dump();
+        top->clk_i = 1;
+        ctx->timeInc(500);
+        top->eval();
+        dump();
+    }
+
+    //  One clock cycle. The outputs of the model are read right after the
+    //  falling edge, then the inputs driven by the testbench are settled
+    //  before the rising edge, where the testbench samples the model
+    void cycle()
+    {
+        top->clk_i = 0;
+        ctx->timeInc(500);
+        top->eval();
+        mem->negedge();
+        drv->negedge();
+        top->eval();
+        dump();
+
+        mem->sample();
+        drv->sample();
+        sb->sample();
+
+        top->clk_i = 1;
+        ctx->timeInc(500);
+        top->eval();
+        mem->posedge();
+        drv->posedge();
+        dump();
+    }
+};
+
+static void
+usage(const char* argv)
+{
+    std::cout << "usage: " << argv << " [options]" << std::endl
+              << "  -h, --help                  print this message" << std::endl
+              << "  -m, --max-cycles <n>        maximum nb of cycles" << std::endl
+              << "  -n <n>                      nb of transactions of the sequence" << std::endl
+              << "  -r, --seed <n>              random seed" << std::endl
+              << "  -l, --log-level <n>         log level (0 to 3)" << std::endl
+              << "  -t, --trace <name>          write the waveforms (VCD)" << std::endl
+              << "  -s, --sequence <name>       random (default) or from_trace" << std::endl
+              << "  -f, --file <name>           trace file of the from_trace sequence" << std::endl
+              << "  -e <n>                      stop after <n> scoreboard errors" << std::endl
+              << "  -p, --pipelined             pipelined driver" << std::endl
+              << "  -o, --trace-roi <n>         region of interest of the trace" << std::endl
+              << "  -k, --trace-skip <n>        nb of records to skip in the trace" << std::endl;
+}
+
+int
+main(int argc, char** argv)
+{
+    hpdcache_test_cc test;
+
+    for (;;) {
+        int c;
+        int option_index;
+        static struct option long_options[] = { { "help", no_argument, 0, 'h' },
+                                                { "max-cycles", required_argument, 0, 'm' },
+                                                { "seed", required_argument, 0, 'r' },
+                                                { "log-level", required_argument, 0, 'l' },
+                                                { "trace", required_argument, 0, 't' },
+                                                { "sequence", required_argument, 0, 's' },
+                                                { "file", required_argument, 0, 'f' },
+                                                { "pipelined", no_argument, 0, 'p' },
+                                                { "trace-roi", required_argument, 0, 'o' },
+                                                { "trace-skip", required_argument, 0, 'k' },
+                                                { 0, 0, 0, 0 } };
+
+        option_index = 0;
+        c = getopt_long(argc,
+                        argv,
+                        "hm:n:r:l:t:f:s:e:po:k:c:q:j:S:F:x:w:C:R:M:L:O:",
+                        long_options,
+                        &option_index);
+        if (c == -1) break;
+
+        switch (c) {
+            case '?':
+            case 'h':
+                usage(argv[0]);
+                return 0;
+            case 'm':
+                test.max_cycles = atoll(optarg);
+                break;
+            case 'n':
+                test.max_trans = atoll(optarg);
+                break;
+            case 'r': {
+                unsigned long int seed = strtol(optarg, NULL, 0);
+                std::cout << "info: setting random seed to " << seed << std::endl;
+                srand(seed);
+                test.seed = seed;
+                break;
+            }
+            case 't':
+                test.trace_on = true;
+                test.trace_name = optarg;
+                break;
+            case 'l': {
+                const int level = atoi(optarg);
+                if ((level < 0) || (level > 3)) {
+                    std::cout << "error: unsupported verbosity level" << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+                std::cout << "info: setting log level to " << level << std::endl;
+                Logger::set_log_level(level);
+                break;
+            }
+            case 's':
+                test.seq_name = optarg;
+                break;
+            case 'f': {
+                test.file_name = optarg;
+                std::ifstream traceFile(test.file_name, std::ifstream::in);
+                if (!traceFile.good()) {
+                    std::cout << "error: trace file cannot be accessed" << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            }
+            case 'e':
+                test.error_limit = atoll(optarg);
+                break;
+            case 'p':
+                test.pipelined = true;
+                break;
+            case 'o':
+                test.trace_roi = atoi(optarg);
+                break;
+            case 'k':
+                test.trace_skip = strtoull(optarg, NULL, 0);
+                break;
+            default:
+                //  options of the SystemC testbench that are not implemented
+                std::cout << "error: option -" << (char)c
+                          << " is not supported by the testbench without SystemC" << std::endl;
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    test.build(argc, argv);
+    test.simulate();
+    return 0;
+}
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
@@ -39,6 +39,7 @@ import hpdcache_pkg::*;
         mshrUseRegbank: `CONF_HPDCACHE_MSHR_USE_REGBANK,
         cbufEntries: `CONF_HPDCACHE_CBUF_ENTRIES,
         refillCoreRspFeedthrough: `CONF_HPDCACHE_REFILL_CORE_RSP_FEEDTHROUGH,
+        refillCriticalWordFirst: `CONF_HPDCACHE_REFILL_CRITICAL_WORD_FIRST,
         refillFifoDepth: `CONF_HPDCACHE_REFILL_FIFO_DEPTH,
         wbufDirEntries: `CONF_HPDCACHE_WBUF_DIR_ENTRIES,
         wbufDataEntries: `CONF_HPDCACHE_WBUF_DATA_ENTRIES,
@@ -58,6 +59,7 @@ import hpdcache_pkg::*;
     },
 
     localparam hpdcache_cfg_t Cfg = hpdcacheBuildConfig(UserCfg),
+    localparam int unsigned NREQUESTERS = Cfg.u.nRequesters,
     localparam type wbuf_timecnt_t = logic unsigned [Cfg.u.wbufTimecntWidth-1:0],
 
     //      Request Interface Definitions
@@ -103,6 +105,21 @@ import hpdcache_pkg::*;
     //      Force the write buffer to send all pending writes
     input  wire logic                          wbuf_flush_i,
 
+`ifdef CONF_HPDCACHE_TEST_MULTIREQ
+    //      Core request interface (one port per requester)
+    //         1st cycle
+    input  logic          [NREQUESTERS-1:0]    core_req_valid_i,
+    output logic          [NREQUESTERS-1:0]    core_req_ready_o,
+    input  hpdcache_req_t [NREQUESTERS-1:0]    core_req_i,
+    //         2nd cycle
+    input  logic          [NREQUESTERS-1:0]    core_req_abort_i,
+    input  hpdcache_tag_t [NREQUESTERS-1:0]    core_req_tag_i,
+    input  hpdcache_pma_t [NREQUESTERS-1:0]    core_req_pma_i,
+
+    //      Core response interface (one port per requester)
+    output var  logic          [NREQUESTERS-1:0] core_rsp_valid_o,
+    output var  hpdcache_rsp_t [NREQUESTERS-1:0] core_rsp_o,
+`else
     //      Core request interface
     //         1st cycle
     input  logic                               core_req_valid_i,
@@ -116,6 +133,7 @@ import hpdcache_pkg::*;
     //      Core response interface
     output var  logic                          core_rsp_valid_o,
     output var  hpdcache_rsp_t                 core_rsp_o,
+`endif
 
     //      Memory read interface
     input  wire logic                          mem_req_read_ready_i,
@@ -127,6 +145,7 @@ import hpdcache_pkg::*;
     output wire hpdcache_mem_command_e         mem_req_read_command_o,
     output wire hpdcache_mem_atomic_e          mem_req_read_atomic_o,
     output wire logic                          mem_req_read_cacheable_o,
+    output wire logic                          mem_req_read_wrap_o,
 
     output var  logic                          mem_resp_read_ready_o,
     input  wire logic                          mem_resp_read_valid_i,
@@ -205,8 +224,6 @@ import hpdcache_pkg::*;
 
     //  Declaration of internal signals
     //  {{{
-    localparam int unsigned NREQUESTERS = Cfg.u.nRequesters;
-
     logic                  core_req_valid [NREQUESTERS];
     logic                  core_req_ready [NREQUESTERS];
     hpdcache_req_t         core_req       [NREQUESTERS];
@@ -236,7 +253,8 @@ import hpdcache_pkg::*;
            mem_req_read_id_o        = mem_req_read.mem_req_id,
            mem_req_read_command_o   = mem_req_read.mem_req_command,
            mem_req_read_atomic_o    = mem_req_read.mem_req_atomic,
-           mem_req_read_cacheable_o = mem_req_read.mem_req_cacheable;
+           mem_req_read_cacheable_o = mem_req_read.mem_req_cacheable,
+           mem_req_read_wrap_o      = mem_req_read.mem_req_wrap;
 
     assign mem_resp_read.mem_resp_r_error = mem_resp_read_error_i,
            mem_resp_read.mem_resp_r_id    = mem_resp_read_id_i,
@@ -263,6 +281,29 @@ import hpdcache_pkg::*;
            mem_resp_write.mem_resp_w_id        = mem_resp_write_id_i;
     //  }}}
 
+`ifdef CONF_HPDCACHE_TEST_MULTIREQ
+    //  Each requester port of the testbench is directly connected to the
+    //  corresponding requester port of the cache
+    always_comb
+    begin : core_req_routing_comb
+        for (int i = 0; i < NREQUESTERS; i++) begin
+            core_req_valid   [i] = core_req_valid_i [i];
+            core_req_ready_o [i] = core_req_ready   [i];
+            core_req         [i] = core_req_i       [i];
+            core_req_abort   [i] = core_req_abort_i [i];
+            core_req_tag     [i] = core_req_tag_i   [i];
+            core_req_pma     [i] = core_req_pma_i   [i];
+        end
+    end
+
+    always_comb
+    begin : core_rsp_routing_comb
+        for (int i = 0; i < NREQUESTERS; i++) begin
+            core_rsp_valid_o [i] = core_rsp_valid [i];
+            core_rsp_o       [i] = core_rsp       [i];
+        end
+    end
+`else
     always_comb
     begin : core_req_routing_comb
         core_req_ready_o = core_req_valid_i && core_req_ready[core_req_i.sid];
@@ -287,6 +328,7 @@ import hpdcache_pkg::*;
             end
         end
     end
+`endif
 
     hpdcache #(
         .HPDcacheCfg                       (Cfg),
@@ -99,6 +99,8 @@ public:
 
     ~hpdcache_test_agent() {}
 
+    void set_pipelined(bool enable) { driver->set_pipelined(enable); }
+
 private:
     std::shared_ptr<hpdcache_test_driver> driver;
 };
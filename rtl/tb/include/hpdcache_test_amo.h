@@ -25,6 +25,8 @@
 #ifndef __HPDCACHE_TEST_AMO_H__
 #define __HPDCACHE_TEST_AMO_H__
 
+#include <cassert>
+#include <cstdint>
 #include <iostream>
 
 class hpdcache_test_transaction_req;
@@ -41,6 +43,8 @@ protected:
     }
 
 public:
+    //  R is the core request of the harness (HPDCACHE_REQ_AMO_* constants)
+    template<typename R = hpdcache_test_transaction_req>
     static uint64_t compute_amo(unsigned atop, uint64_t ld_data, uint64_t st_data, unsigned bytes)
     {
         bool umax = (ld_data > st_data);
@@ -53,35 +57,35 @@ public:
 
         uint64_t result;
         switch (atop) {
-            case hpdcache_test_transaction_req::HPDCACHE_REQ_AMO_SWAP:
+            case R::HPDCACHE_REQ_AMO_SWAP:
                 result = st_data;
                 break;
-            case hpdcache_test_transaction_req::HPDCACHE_REQ_AMO_ADD:
+            case R::HPDCACHE_REQ_AMO_ADD:
                 result = ld_data + st_data;
                 break;
-            case hpdcache_test_transaction_req::HPDCACHE_REQ_AMO_AND:
+            case R::HPDCACHE_REQ_AMO_AND:
                 result = ld_data & st_data;
                 break;
-            case hpdcache_test_transaction_req::HPDCACHE_REQ_AMO_OR:
+            case R::HPDCACHE_REQ_AMO_OR:
                 result = ld_data | st_data;
                 break;
-            case hpdcache_test_transaction_req::HPDCACHE_REQ_AMO_XOR:
+            case R::HPDCACHE_REQ_AMO_XOR:
                 result = ld_data ^ st_data;
                 break;
-            case hpdcache_test_transaction_req::HPDCACHE_REQ_AMO_MAX:
+            case R::HPDCACHE_REQ_AMO_MAX:
                 result = smax ? ld_data : st_data;
                 break;
-            case hpdcache_test_transaction_req::HPDCACHE_REQ_AMO_MAXU:
+            case R::HPDCACHE_REQ_AMO_MAXU:
                 result = umax ? ld_data : st_data;
                 break;
-            case hpdcache_test_transaction_req::HPDCACHE_REQ_AMO_MIN:
+            case R::HPDCACHE_REQ_AMO_MIN:
                 result = smax ? st_data : ld_data;
                 break;
-            case hpdcache_test_transaction_req::HPDCACHE_REQ_AMO_MINU:
+            case R::HPDCACHE_REQ_AMO_MINU:
                 result = umax ? st_data : ld_data;
                 break;
             default:
-                sc_assert(false && "unknown atomic operation");
+                assert(false && "unknown atomic operation");
                 return 0;
         }
 
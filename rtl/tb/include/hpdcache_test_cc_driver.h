@@ -0,0 +1,231 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Driver of the HPDCACHE testbench without SystemC. It pulls the
+ *               requests from the sequence, drives them on the request port
+ *               of the cache, and monitors the responses (see
+ *               hpdcache_test_driver.h)
+ */
+#ifndef __HPDCACHE_TEST_CC_DRIVER_H__
+#define __HPDCACHE_TEST_CC_DRIVER_H__
+
+#include "Vhpdcache_wrapper.h"
+#include "hpdcache_test_cc_ports.h"
+#include "hpdcache_test_cc_scoreboard.h"
+#include "hpdcache_test_cc_sequence.h"
+#include "hpdcache_test_cc_transaction.h"
+#include "hpdcache_test_defs.h"
+#include "logger.h"
+#include <iostream>
+#include <sstream>
+
+class hpdcache_test_cc_driver
+{
+    typedef hpdcache_test_cc_req req_t;
+    typedef hpdcache_test_cc_resp resp_t;
+
+public:
+    hpdcache_test_cc_driver(Vhpdcache_wrapper* top,
+                            hpdcache_test_cc_sequence* seq,
+                            hpdcache_test_cc_scoreboard* sb)
+      : top_m(top)
+      , seq_m(seq)
+      , sb_m(sb)
+      , pipelined(false)
+      , valid(false)
+      , ready(false)
+      , cur_delay(0)
+      , next_fetch(0)
+      , nb_cycles(0)
+      , nb_requests(0)
+      , nb_valid_cycles(0)
+      , first_req_cycle(0)
+      , last_req_cycle(0)
+    {
+        top_m->core_req_valid_i = 0;
+        top_m->core_req_abort_i = 0;
+        top_m->core_req_tag_i = 0;
+        top_m->core_req_pma_i = 0;
+    }
+
+    ~hpdcache_test_cc_driver()
+    {
+        if (Logger::get_log_level() >= Logger::LOG_LOW) {
+            std::stringstream ss;
+            const uint64_t nb_active_cycles =
+                (nb_requests > 0) ? (last_req_cycle - first_req_cycle + 1) : 0;
+
+            ss << "DRIVER STATISTICS (driver)" << std::endl
+               << "--------------------------------------------------" << std::endl
+               << "DRV.MODE                : " << (pipelined ? "pipelined" : "blocking")
+               << std::endl
+               << "DRV.NB_REQUESTS         : " << nb_requests << std::endl
+               << "DRV.NB_VALID_CYCLES     : " << nb_valid_cycles << std::endl
+               << "DRV.NB_ACTIVE_CYCLES    : " << nb_active_cycles << std::endl
+               << std::endl
+
+               << "Computed values" << std::endl
+               << "---------------" << std::endl
+               << "Requests per cycle      : "
+               << (nb_active_cycles > 0 ? (double)nb_requests / nb_active_cycles : 0)
+               << std::endl
+               << "Requests per valid cycle: "
+               << (nb_valid_cycles > 0 ? (double)nb_requests / nb_valid_cycles : 0) << std::endl;
+
+            std::cout << ss.str() << std::endl;
+        }
+    }
+
+    //  When enabled, the driver keeps the valid signal asserted across
+    //  consecutive requests (see hpdcache_test_driver.h)
+    void set_pipelined(bool enable) { pipelined = enable; }
+
+    //  All the requests of the sequence were accepted by the cache
+    bool is_done() const { return !valid && seq_m->is_done(); }
+
+    //  Monitor the responses of the cache right after the falling edge
+    void negedge()
+    {
+        if (!top_m->core_rsp_valid_o) return;
+
+        resp_t resp;
+        core_resp_from_port(resp);
+
+        //  send response to the scoreboard
+        sb_m->core_resp(resp);
+    }
+
+    //  Read the ready signal (value just before the rising edge)
+    void sample() { ready = top_m->core_req_ready_o; }
+
+    void posedge()
+    {
+        nb_cycles++;
+
+        if (valid) {
+            nb_valid_cycles++;
+            if (!ready) return;
+
+            //  the request is accepted: send its tag (second cycle of the
+            //  request) and forward it to the scoreboard
+            count_request();
+            top_m->core_req_tag_i = core_get_req_tag(cur);
+            top_m->core_req_pma_i = core_get_req_pma(cur);
+            top_m->core_req_abort_i = cur.abort;
+            sb_m->core_req(cur);
+
+            valid = false;
+            if (!pipelined) {
+                top_m->core_req_valid_i = 0;
+                next_fetch = nb_cycles + cur_delay;
+            }
+        }
+
+        //  fetch the next request once the delay of the previous one elapsed
+        if (nb_cycles >= next_fetch && seq_m->next(cur, cur_delay)) {
+            valid = true;
+            core_req_to_port(cur);
+            top_m->core_req_valid_i = 1;
+            if (pipelined) next_fetch = nb_cycles + cur_delay;
+        } else {
+            top_m->core_req_valid_i = 0;
+        }
+    }
+
+private:
+    Vhpdcache_wrapper* top_m;
+    hpdcache_test_cc_sequence* seq_m;
+    hpdcache_test_cc_scoreboard* sb_m;
+
+    bool pipelined;
+    bool valid;
+    bool ready;
+    req_t cur;
+    unsigned cur_delay;
+    uint64_t next_fetch;
+
+    uint64_t nb_cycles;
+    uint64_t nb_requests;
+    uint64_t nb_valid_cycles;
+    uint64_t first_req_cycle;
+    uint64_t last_req_cycle;
+
+    void count_request()
+    {
+        if (nb_requests == 0) first_req_cycle = nb_cycles;
+        last_req_cycle = nb_cycles;
+        nb_requests++;
+    }
+
+    static uint64_t core_get_req_tag(const req_t& r)
+    {
+        return (r.addr >> HPDCACHE_ADDR_OFFSET_WIDTH)
+               & hpdcache_test_cc_ports::field_mask(HPDCACHE_TAG_WIDTH);
+    }
+
+    static uint32_t core_get_req_pma(const req_t& r)
+    {
+        uint32_t ret = 0;
+        if (r.wr_policy_hint & req_t::HPDCACHE_WR_POLICY_AUTO) ret |= (0x1 << 0);
+        if (r.wr_policy_hint & req_t::HPDCACHE_WR_POLICY_WB) ret |= (0x1 << 1);
+        if (r.wr_policy_hint & req_t::HPDCACHE_WR_POLICY_WT) ret |= (0x1 << 2);
+        if (r.io) ret |= (0x1 << 3);
+        if (r.uncacheable) ret |= (0x1 << 4);
+        return ret;
+    }
+
+    void core_req_to_port(const req_t& r)
+    {
+        using namespace hpdcache_test_cc_ports;
+
+        const unsigned PMA_POS = 0;
+        const unsigned TAG_POS = PMA_POS + HPDCACHE_REQ_PMA_WIDTH;
+        const unsigned PHYS_INDEXED_POS = TAG_POS + HPDCACHE_TAG_WIDTH;
+        const unsigned NEED_RSP_POS = PHYS_INDEXED_POS + HPDCACHE_REQ_PHYS_INDEXED_WIDTH;
+        const unsigned TRANS_ID_POS = NEED_RSP_POS + HPDCACHE_REQ_NEED_RSP_WIDTH;
+        const unsigned SRC_ID_POS = TRANS_ID_POS + HPDCACHE_REQ_TRANS_ID_WIDTH;
+        const unsigned SIZE_POS = SRC_ID_POS + HPDCACHE_REQ_SRC_ID_WIDTH;
+        const unsigned BE_POS = SIZE_POS + HPDCACHE_REQ_SIZE_WIDTH;
+        const unsigned OP_POS = BE_POS + (HPDCACHE_REQ_DATA_WIDTH / 8);
+        const unsigned WDATA_POS = OP_POS + HPDCACHE_REQ_OP_WIDTH;
+        const unsigned ADDR_POS = WDATA_POS + HPDCACHE_REQ_DATA_WIDTH;
+
+        auto& port = top_m->core_req_i;
+        set(port, PMA_POS, HPDCACHE_REQ_PMA_WIDTH, core_get_req_pma(r));
+        set(port, TAG_POS, HPDCACHE_TAG_WIDTH, core_get_req_tag(r));
+        set(port, PHYS_INDEXED_POS, HPDCACHE_REQ_PHYS_INDEXED_WIDTH, r.phys_indexed ? 1 : 0);
+        set(port, NEED_RSP_POS, HPDCACHE_REQ_NEED_RSP_WIDTH, r.need_rsp ? 1 : 0);
+        set(port, TRANS_ID_POS, HPDCACHE_REQ_TRANS_ID_WIDTH, r.tid);
+        set(port, SRC_ID_POS, HPDCACHE_REQ_SRC_ID_WIDTH, r.sid);
+        set(port, SIZE_POS, HPDCACHE_REQ_SIZE_WIDTH, r.size);
+        set_bytes(port, BE_POS, r.be, req_t::BE_BYTES);
+        set(port, OP_POS, HPDCACHE_REQ_OP_WIDTH, r.op);
+        set_bytes(port, WDATA_POS, r.wdata, req_t::DATA_BYTES);
+        set(port, ADDR_POS, HPDCACHE_ADDR_OFFSET_WIDTH, r.addr);
+    }
+
+    void core_resp_from_port(resp_t& resp) const
+    {
+        using namespace hpdcache_test_cc_ports;
+
+        const unsigned ABORTED_POS = 0;
+        const unsigned ERROR_POS = ABORTED_POS + HPDCACHE_RSP_ABORTED_WIDTH;
+        const unsigned TRANS_ID_POS = ERROR_POS + HPDCACHE_RSP_ERROR_WIDTH;
+        const unsigned SRC_ID_POS = TRANS_ID_POS + HPDCACHE_REQ_TRANS_ID_WIDTH;
+        const unsigned RDATA_POS = SRC_ID_POS + HPDCACHE_REQ_SRC_ID_WIDTH;
+
+        const auto& port = top_m->core_rsp_o;
+        resp.aborted = get(port, ABORTED_POS, HPDCACHE_RSP_ABORTED_WIDTH) > 0;
+        resp.error = get(port, ERROR_POS, HPDCACHE_RSP_ERROR_WIDTH) > 0;
+        resp.tid = get(port, TRANS_ID_POS, HPDCACHE_REQ_TRANS_ID_WIDTH);
+        resp.sid = get(port, SRC_ID_POS, HPDCACHE_REQ_SRC_ID_WIDTH);
+        get_bytes(port, RDATA_POS, resp.rdata, resp_t::DATA_BYTES);
+    }
+};
+
+#endif /* __HPDCACHE_TEST_CC_DRIVER_H__ */
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
@@ -0,0 +1,495 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Memory response model of the HPDCACHE testbench without
+ *               SystemC. Each process of the SystemC model
+ *               (hpdcache_test_mem_resp_model.h) is a state machine stepped on
+ *               the edge of the clock where the process is sensitive. The
+ *               content of the memory, the error segments, the exclusive
+ *               reservations and the atomic operations are those of the
+ *               SystemC model (hpdcache_test_mem_func_model.h)
+ */
+#ifndef __HPDCACHE_TEST_CC_MEM_MODEL_H__
+#define __HPDCACHE_TEST_CC_MEM_MODEL_H__
+
+#include "Vhpdcache_wrapper.h"
+#include "hpdcache_test_cc_ports.h"
+#include "hpdcache_test_cc_random.h"
+#include "hpdcache_test_cc_transaction.h"
+#include "hpdcache_test_defs.h"
+#include "hpdcache_test_mem_func_model.h"
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <vector>
+
+class hpdcache_test_cc_mem_model : public hpdcache_test_mem_func_model
+{
+public:
+    typedef hpdcache_test_cc_mem_req mem_req_t;
+    typedef hpdcache_test_cc_mem_read_resp mem_read_resp_t;
+    typedef hpdcache_test_cc_mem_write_resp mem_write_resp_t;
+
+    //  Capacity of the response FIFOs (same as the SystemC model)
+    static constexpr size_t RESP_FIFO_DEPTH = 2;
+
+    hpdcache_test_cc_mem_model(Vhpdcache_wrapper* top, uint64_t seed)
+      : hpdcache_test_mem_func_model("_i_mem")
+      , top_m(top)
+      , listener_m(nullptr)
+      , rng_m(seed ^ 0x6d656d5f6d6f64ULL)
+      , rd_req_state_m(RD_REQ_IDLE)
+      , rd_resp_state_m(RESP_IDLE)
+      , wr_req_state_m(WR_CHAN_IDLE)
+      , wr_data_state_m(WR_CHAN_IDLE)
+      , wr_state_m(WR_IDLE)
+      , wr_resp_state_m(RESP_IDLE)
+      , rd_req_cnt_m(0)
+      , rd_req_beat_m(0)
+      , rd_req_error_m(false)
+      , rd_resp_cnt_m(0)
+      , wr_req_cnt_m(0)
+      , wr_data_cnt_m(0)
+      , wr_resp_cnt_m(0)
+      , wr_has_meta_m(false)
+      , rd_resp_ready_m(false)
+      , wr_resp_ready_m(false)
+      , nb_cycles_m(0)
+    {
+        set_mem_seed(seed);
+
+        //  same delay distributions as the SystemC model
+        ra_delay_m.push(0, 2, 90);
+        ra_delay_m.push(3, 8, 8);
+        ra_delay_m.push(9, 32, 2);
+        rd_delay_m.push(0, 2, 8);
+        rd_delay_m.push(3, 8, 90);
+        rd_delay_m.push(9, 64, 2);
+        wa_delay_m.push(0, 2, 90);
+        wa_delay_m.push(3, 8, 8);
+        wa_delay_m.push(9, 32, 2);
+        wd_delay_m.push(0, 2, 90);
+        wd_delay_m.push(3, 8, 8);
+        wd_delay_m.push(9, 32, 2);
+        wb_delay_m.push(0, 2, 8);
+        wb_delay_m.push(3, 8, 90);
+        wb_delay_m.push(9, 64, 2);
+
+        top_m->mem_req_read_ready_i = 0;
+        top_m->mem_resp_read_valid_i = 0;
+        top_m->mem_req_write_ready_i = 0;
+        top_m->mem_req_write_data_ready_i = 0;
+        top_m->mem_resp_write_valid_i = 0;
+    }
+
+    //  Observer of the memory transactions (scoreboard)
+    void set_listener(hpdcache_test_cc_mem_listener* l) { listener_m = l; }
+
+    //  Processes sensitive to the falling edge of the clock. The outputs of
+    //  the cache are read right after the edge
+    void negedge()
+    {
+        read_process();
+        write_address_process();
+        write_data_process();
+    }
+
+    //  Read the inputs of the processes sensitive to the rising edge of the
+    //  clock (value just before the edge)
+    void sample()
+    {
+        rd_resp_ready_m = top_m->mem_resp_read_ready_o;
+        wr_resp_ready_m = top_m->mem_resp_write_ready_o;
+    }
+
+    //  Processes sensitive to the rising edge of the clock
+    void posedge()
+    {
+        nb_cycles_m++;
+        read_response_process();
+        write_response_process();
+        write_process();
+    }
+
+private:
+    enum rd_req_state_e
+    {
+        RD_REQ_IDLE,
+        RD_REQ_DELAY,
+        RD_REQ_READY,
+        RD_REQ_RESP
+    };
+
+    enum wr_chan_state_e
+    {
+        WR_CHAN_IDLE,
+        WR_CHAN_DELAY,
+        WR_CHAN_READY
+    };
+
+    enum wr_state_e
+    {
+        WR_IDLE,
+        WR_WAIT,
+        WR_RESP
+    };
+
+    enum resp_state_e
+    {
+        RESP_IDLE,
+        RESP_DELAY,
+        RESP_VALID
+    };
+
+    struct mem_write_data_t
+    {
+        uint8_t data[MEM_NOC_DATA_BYTES];
+        uint8_t be[MEM_NOC_DATA_BYTES / 8];
+        bool last;
+    };
+
+    Vhpdcache_wrapper* top_m;
+    hpdcache_test_cc_mem_listener* listener_m;
+    hpdcache_test_cc_rng rng_m;
+
+    hpdcache_test_cc_bag ra_delay_m;
+    hpdcache_test_cc_bag rd_delay_m;
+    hpdcache_test_cc_bag wa_delay_m;
+    hpdcache_test_cc_bag wd_delay_m;
+    hpdcache_test_cc_bag wb_delay_m;
+
+    std::deque<mem_read_resp_t> read_resp_fifo_m;
+    std::deque<mem_req_t> write_req_fifo_m;
+    std::deque<mem_write_data_t> write_data_fifo_m;
+    std::deque<mem_write_resp_t> write_resp_fifo_m;
+
+    rd_req_state_e rd_req_state_m;
+    resp_state_e rd_resp_state_m;
+    wr_chan_state_e wr_req_state_m;
+    wr_chan_state_e wr_data_state_m;
+    wr_state_e wr_state_m;
+    resp_state_e wr_resp_state_m;
+
+    unsigned rd_req_cnt_m;
+    unsigned rd_req_beat_m;
+    bool rd_req_error_m;
+    unsigned rd_resp_cnt_m;
+    unsigned wr_req_cnt_m;
+    unsigned wr_data_cnt_m;
+    unsigned wr_resp_cnt_m;
+
+    mem_req_t rd_req_m;
+    mem_read_resp_t rd_resp_m;
+    mem_req_t wr_req_m;
+    mem_write_resp_t wr_resp_m;
+    bool wr_has_meta_m;
+
+    //  Responses of the write process waiting for room in the response FIFOs
+    std::deque<mem_read_resp_t> wr_pending_read_resp_m;
+    std::deque<mem_write_resp_t> wr_pending_write_resp_m;
+
+    bool rd_resp_ready_m;
+    bool wr_resp_ready_m;
+    uint64_t nb_cycles_m;
+
+    unsigned next_delay(const hpdcache_test_cc_bag& bag) { return (unsigned)bag.next(rng_m); }
+
+    //  Read channel
+    //  {{{
+    void read_process()
+    {
+        for (;;) {
+            switch (rd_req_state_m) {
+                case RD_REQ_IDLE:
+                    if (!top_m->mem_req_read_valid_o) return;
+
+                    //  consume the request from the request ports
+                    rd_req_m.addr = top_m->mem_req_read_addr_o;
+                    rd_req_m.len = top_m->mem_req_read_len_o;
+                    rd_req_m.size = top_m->mem_req_read_size_o;
+                    rd_req_m.id = top_m->mem_req_read_id_o;
+                    rd_req_m.command = top_m->mem_req_read_command_o;
+                    rd_req_m.atomic = top_m->mem_req_read_atomic_o;
+                    rd_req_m.cacheable = top_m->mem_req_read_cacheable_o;
+                    rd_req_m.wrap = top_m->mem_req_read_wrap_o;
+                    if (listener_m) listener_m->mem_read_req(rd_req_m);
+
+                    rd_req_cnt_m = next_delay(ra_delay_m);
+                    rd_req_state_m = RD_REQ_DELAY;
+                    // fall through
+
+                case RD_REQ_DELAY:
+                    if (rd_req_cnt_m > 0) {
+                        rd_req_cnt_m--;
+                        return;
+                    }
+                    top_m->mem_req_read_ready_i = 1;
+                    rd_req_state_m = RD_REQ_READY;
+                    return;
+
+                case RD_REQ_READY:
+                    top_m->mem_req_read_ready_i = 0;
+
+                    rd_req_error_m = !read_access(rd_req_m);
+                    rd_req_beat_m = 0;
+                    rd_req_state_m = RD_REQ_RESP;
+                    // fall through
+
+                case RD_REQ_RESP:
+                    //  the beats are pushed as soon as there is room in the FIFO
+                    while (rd_req_beat_m <= rd_req_m.len) {
+                        if (read_resp_fifo_m.size() >= RESP_FIFO_DEPTH) return;
+                        mem_read_resp_t resp;
+                        resp.id = rd_req_m.id;
+                        resp.last = (rd_req_beat_m == rd_req_m.len);
+                        resp.error = rd_req_error_m;
+                        if (resp.error) {
+                            memset(resp.data, 0, sizeof(resp.data));
+                        } else {
+                            read_beat(rd_req_m, rd_req_beat_m, resp.data);
+                        }
+                        read_resp_fifo_m.push_back(resp);
+                        rd_req_beat_m++;
+                    }
+                    rd_req_state_m = RD_REQ_IDLE;
+                    break;
+            }
+        }
+    }
+
+    void read_response_process()
+    {
+        for (;;) {
+            switch (rd_resp_state_m) {
+                case RESP_IDLE:
+                    if (read_resp_fifo_m.empty()) return;
+                    rd_resp_m = read_resp_fifo_m.front();
+                    read_resp_fifo_m.pop_front();
+                    rd_resp_cnt_m = next_delay(rd_delay_m);
+                    rd_resp_state_m = RESP_DELAY;
+                    // fall through
+
+                case RESP_DELAY:
+                    if (rd_resp_cnt_m > 0) {
+                        rd_resp_cnt_m--;
+                        return;
+                    }
+                    if (listener_m) listener_m->mem_read_resp(rd_resp_m);
+                    top_m->mem_resp_read_valid_i = 1;
+                    top_m->mem_resp_read_error_i = rd_resp_m.error ? 1 : 0;
+                    top_m->mem_resp_read_id_i = rd_resp_m.id;
+                    hpdcache_test_cc_ports::set_bytes(
+                        top_m->mem_resp_read_data_i, 0, rd_resp_m.data, MEM_NOC_DATA_BYTES);
+                    top_m->mem_resp_read_last_i = rd_resp_m.last;
+                    rd_resp_state_m = RESP_VALID;
+                    return;
+
+                case RESP_VALID:
+                    if (!rd_resp_ready_m) return;
+                    top_m->mem_resp_read_valid_i = 0;
+                    rd_resp_state_m = RESP_IDLE;
+                    break;
+            }
+        }
+    }
+    //  }}}
+
+    //  Write channels
+    //  {{{
+    void write_address_process()
+    {
+        switch (wr_req_state_m) {
+            case WR_CHAN_READY:
+                top_m->mem_req_write_ready_i = 0;
+                wr_req_state_m = WR_CHAN_IDLE;
+                // fall through
+
+            case WR_CHAN_IDLE:
+                if (!top_m->mem_req_write_valid_o) return;
+                wr_req_cnt_m = next_delay(wa_delay_m);
+                wr_req_state_m = WR_CHAN_DELAY;
+                // fall through
+
+            case WR_CHAN_DELAY:
+                if (wr_req_cnt_m > 0) {
+                    wr_req_cnt_m--;
+                    return;
+                }
+                top_m->mem_req_write_ready_i = 1;
+
+                //  forward the request to the write process
+                mem_req_t r;
+                r.addr = top_m->mem_req_write_addr_o;
+                r.len = top_m->mem_req_write_len_o;
+                r.size = top_m->mem_req_write_size_o;
+                r.id = top_m->mem_req_write_id_o;
+                r.command = top_m->mem_req_write_command_o;
+                r.atomic = top_m->mem_req_write_atomic_o;
+                r.cacheable = top_m->mem_req_write_cacheable_o;
+                r.wrap = false;
+                write_req_fifo_m.push_back(r);
+                wr_req_state_m = WR_CHAN_READY;
+                return;
+        }
+    }
+
+    void write_data_process()
+    {
+        switch (wr_data_state_m) {
+            case WR_CHAN_READY:
+                top_m->mem_req_write_data_ready_i = 0;
+                wr_data_state_m = WR_CHAN_IDLE;
+                // fall through
+
+            case WR_CHAN_IDLE:
+                if (!top_m->mem_req_write_data_valid_o) return;
+                wr_data_cnt_m = next_delay(wd_delay_m);
+                wr_data_state_m = WR_CHAN_DELAY;
+                // fall through
+
+            case WR_CHAN_DELAY:
+                if (wr_data_cnt_m > 0) {
+                    wr_data_cnt_m--;
+                    return;
+                }
+                top_m->mem_req_write_data_ready_i = 1;
+
+                mem_write_data_t d;
+                hpdcache_test_cc_ports::get_bytes(
+                    top_m->mem_req_write_data_o, 0, d.data, MEM_NOC_DATA_BYTES);
+                hpdcache_test_cc_ports::get_bytes(
+                    top_m->mem_req_write_be_o, 0, d.be, MEM_NOC_DATA_BYTES / 8);
+                d.last = top_m->mem_req_write_last_o;
+                write_data_fifo_m.push_back(d);
+                wr_data_state_m = WR_CHAN_READY;
+                return;
+        }
+    }
+
+    //  Execute a write request and queue its responses
+    void write_operation(const mem_req_t& req)
+    {
+        const write_status_t st = write_access(req, req.data.data(), req.be.data());
+
+        //  the old data of an AMO is sent on the read response channel. If the
+        //  request is in an error segment, the data is zero and the error flag
+        //  is on the write response
+        if (req.is_amo()) {
+            mem_read_resp_t read_resp;
+            memcpy(read_resp.data, st.amo_data, sizeof(read_resp.data));
+            read_resp.error = false;
+            read_resp.id = req.id;
+            read_resp.last = true;
+            wr_pending_read_resp_m.push_back(read_resp);
+        }
+
+        //  send the write acknowledge on the write response channel
+        mem_write_resp_t resp;
+        resp.id = req.id;
+        resp.is_atomic = st.is_atomic;
+        resp.error = st.error;
+        wr_pending_write_resp_m.push_back(resp);
+    }
+
+    void write_process()
+    {
+        for (;;) {
+            switch (wr_state_m) {
+                case WR_IDLE:
+                    if (!wr_has_meta_m) {
+                        if (write_req_fifo_m.empty()) return;
+                        wr_req_m = write_req_fifo_m.front();
+                        write_req_fifo_m.pop_front();
+                        wr_req_m.data.clear();
+                        wr_req_m.be.clear();
+                        wr_req_m.bad_last_flit = -1;
+                        wr_has_meta_m = true;
+                    }
+
+                    //  collect the len + 1 data flits of the burst. Only the
+                    //  last one shall have the last flag (checked by the
+                    //  scoreboard)
+                    while (wr_req_m.data.size() < (wr_req_m.len + 1) * MEM_NOC_DATA_BYTES) {
+                        if (write_data_fifo_m.empty()) return;
+                        const mem_write_data_t& d = write_data_fifo_m.front();
+                        const unsigned i = wr_req_m.data.size() / MEM_NOC_DATA_BYTES;
+                        if ((d.last != (i == wr_req_m.len)) && (wr_req_m.bad_last_flit < 0)) {
+                            wr_req_m.bad_last_flit = i;
+                        }
+                        auto& data = wr_req_m.data;
+                        auto& be = wr_req_m.be;
+                        data.insert(data.end(), d.data, d.data + MEM_NOC_DATA_BYTES);
+                        be.insert(be.end(), d.be, d.be + MEM_NOC_DATA_BYTES / 8);
+                        wr_req_m.last = d.last;
+                        write_data_fifo_m.pop_front();
+                    }
+                    wr_has_meta_m = false;
+                    wr_state_m = WR_WAIT;
+                    return;
+
+                case WR_WAIT:
+                    //  send request to scoreboard, and make the write operation
+                    if (listener_m) listener_m->mem_write_req(wr_req_m);
+                    write_operation(wr_req_m);
+                    wr_state_m = WR_RESP;
+                    // fall through
+
+                case WR_RESP:
+                    while (!wr_pending_read_resp_m.empty()) {
+                        if (read_resp_fifo_m.size() >= RESP_FIFO_DEPTH) return;
+                        read_resp_fifo_m.push_back(wr_pending_read_resp_m.front());
+                        wr_pending_read_resp_m.pop_front();
+                    }
+                    while (!wr_pending_write_resp_m.empty()) {
+                        if (write_resp_fifo_m.size() >= RESP_FIFO_DEPTH) return;
+                        write_resp_fifo_m.push_back(wr_pending_write_resp_m.front());
+                        wr_pending_write_resp_m.pop_front();
+                    }
+                    wr_state_m = WR_IDLE;
+                    break;
+            }
+        }
+    }
+
+    void write_response_process()
+    {
+        for (;;) {
+            switch (wr_resp_state_m) {
+                case RESP_IDLE:
+                    if (write_resp_fifo_m.empty()) return;
+                    wr_resp_m = write_resp_fifo_m.front();
+                    write_resp_fifo_m.pop_front();
+                    wr_resp_cnt_m = next_delay(wb_delay_m);
+                    wr_resp_state_m = RESP_DELAY;
+                    // fall through
+
+                case RESP_DELAY:
+                    if (wr_resp_cnt_m > 0) {
+                        wr_resp_cnt_m--;
+                        return;
+                    }
+                    if (listener_m) listener_m->mem_write_resp(wr_resp_m);
+                    top_m->mem_resp_write_valid_i = 1;
+                    top_m->mem_resp_write_is_atomic_i = wr_resp_m.is_atomic;
+                    top_m->mem_resp_write_error_i = wr_resp_m.error ? 1 : 0;
+                    top_m->mem_resp_write_id_i = wr_resp_m.id;
+                    wr_resp_state_m = RESP_VALID;
+                    return;
+
+                case RESP_VALID:
+                    if (!wr_resp_ready_m) return;
+                    top_m->mem_resp_write_valid_i = 0;
+                    wr_resp_state_m = RESP_IDLE;
+                    break;
+            }
+        }
+    }
+    //  }}}
+};
+
+#endif /* __HPDCACHE_TEST_CC_MEM_MODEL_H__ */
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
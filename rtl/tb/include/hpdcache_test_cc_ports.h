@@ -0,0 +1,108 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Access to the bit fields of the ports of a model verilated
+ *               without SystemC (--cc)
+ */
+#ifndef __HPDCACHE_TEST_CC_PORTS_H__
+#define __HPDCACHE_TEST_CC_PORTS_H__
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <verilated.h>
+
+/**
+ * @brief Verilator maps the ports of up to 64 bits to integers (CData, SData,
+ *        IData or QData), and the wider ones to arrays of 32-bit words
+ *        (VlWide). The functions below read and write a field of at most 64
+ *        bits at any position of a port of either kind
+ */
+namespace hpdcache_test_cc_ports {
+
+static inline uint64_t
+field_mask(unsigned width)
+{
+    return (width >= 64) ? ~0ULL : ((1ULL << width) - 1);
+}
+
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value>::type
+set(T& port, unsigned lsb, unsigned width, uint64_t value)
+{
+    const uint64_t mask = field_mask(width) << lsb;
+    port = static_cast<T>((static_cast<uint64_t>(port) & ~mask) | ((value << lsb) & mask));
+}
+
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value, uint64_t>::type
+get(const T& port, unsigned lsb, unsigned width)
+{
+    return (static_cast<uint64_t>(port) >> lsb) & field_mask(width);
+}
+
+template<std::size_t N>
+inline void
+set(VlWide<N>& port, unsigned lsb, unsigned width, uint64_t value)
+{
+    while (width > 0) {
+        const unsigned w = lsb / 32;
+        const unsigned b = lsb % 32;
+        const unsigned n = (width < (32 - b)) ? width : (32 - b);
+        const uint32_t mask = static_cast<uint32_t>(field_mask(n)) << b;
+
+        port[w] = (port[w] & ~mask) | ((static_cast<uint32_t>(value) << b) & mask);
+        value >>= n;
+        lsb += n;
+        width -= n;
+    }
+}
+
+template<std::size_t N>
+inline uint64_t
+get(const VlWide<N>& port, unsigned lsb, unsigned width)
+{
+    uint64_t ret = 0;
+    for (unsigned pos = 0; pos < width;) {
+        const unsigned w = (lsb + pos) / 32;
+        const unsigned b = (lsb + pos) % 32;
+        const unsigned n = ((width - pos) < (32 - b)) ? (width - pos) : (32 - b);
+
+        ret |= ((static_cast<uint64_t>(port[w]) >> b) & field_mask(n)) << pos;
+        pos += n;
+    }
+    return ret;
+}
+
+//  Write (read) n bytes into (from) a port, starting at the given bit
+template<typename T>
+inline void
+set_bytes(T& port, unsigned lsb, const uint8_t* buf, unsigned n)
+{
+    for (unsigned i = 0; i < n; i += 8) {
+        const unsigned cnt = ((n - i) < 8) ? (n - i) : 8;
+        uint64_t v = 0;
+        memcpy(&v, buf + i, cnt);
+        set(port, lsb + i * 8, cnt * 8, v);
+    }
+}
+
+template<typename T>
+inline void
+get_bytes(const T& port, unsigned lsb, uint8_t* buf, unsigned n)
+{
+    for (unsigned i = 0; i < n; i += 8) {
+        const unsigned cnt = ((n - i) < 8) ? (n - i) : 8;
+        const uint64_t v = get(port, lsb + i * 8, cnt * 8);
+        memcpy(buf + i, &v, cnt);
+    }
+}
+
+} // namespace hpdcache_test_cc_ports
+
+#endif /* __HPDCACHE_TEST_CC_PORTS_H__ */
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
@@ -0,0 +1,70 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Weighted random distributions of the HPDCACHE testbench
+ *               without SystemC. They replace the scv_bag of the SCV library
+ */
+#ifndef __HPDCACHE_TEST_CC_RANDOM_H__
+#define __HPDCACHE_TEST_CC_RANDOM_H__
+
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+typedef std::mt19937_64 hpdcache_test_cc_rng;
+
+/**
+ * @class hpdcache_test_cc_bag
+ * @brief Set of ranges of values with a weight each. A draw selects a range
+ *        with a probability proportional to its weight, then a value of the
+ *        range with a uniform probability
+ */
+class hpdcache_test_cc_bag
+{
+public:
+    hpdcache_test_cc_bag()
+      : total_m(0)
+    {
+    }
+
+    void push(int64_t lo, int64_t hi, unsigned weight)
+    {
+        entries_m.push_back({ lo, hi, weight });
+        total_m += weight;
+    }
+
+    void push(int64_t value, unsigned weight) { push(value, value, weight); }
+
+    int64_t next(hpdcache_test_cc_rng& rng) const
+    {
+        assert(total_m > 0);
+
+        uint64_t w = rng() % total_m;
+        for (const entry_t& e : entries_m) {
+            if (w < e.weight) {
+                return e.lo + (int64_t)(rng() % (uint64_t)(e.hi - e.lo + 1));
+            }
+            w -= e.weight;
+        }
+        return entries_m.back().hi;
+    }
+
+private:
+    struct entry_t
+    {
+        int64_t lo;
+        int64_t hi;
+        uint64_t weight;
+    };
+
+    std::vector<entry_t> entries_m;
+    uint64_t total_m;
+};
+
+#endif /* __HPDCACHE_TEST_CC_RANDOM_H__ */
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
@@ -0,0 +1,208 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Scoreboard of the HPDCACHE testbench without SystemC. It makes
+ *               the checks of the scoreboard of the SystemC testbench
+ *               (hpdcache_test_scoreboard_base.h), but it is called directly by
+ *               the driver and the memory model instead of reading FIFOs
+ */
+#ifndef __HPDCACHE_TEST_CC_SCOREBOARD_H__
+#define __HPDCACHE_TEST_CC_SCOREBOARD_H__
+
+#include "Vhpdcache_wrapper.h"
+#include "hpdcache_test_amo.h"
+#include "hpdcache_test_cc_mem_model.h"
+#include "hpdcache_test_cc_sequence.h"
+#include "hpdcache_test_cc_transaction.h"
+#include "hpdcache_test_defs.h"
+#include "hpdcache_test_scoreboard_base.h"
+#include "logger.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+class hpdcache_test_cc_scoreboard
+  : public hpdcache_test_cc_mem_listener
+  , public hpdcache_test_scoreboard_base
+{
+    typedef hpdcache_test_cc_req req_t;
+    typedef hpdcache_test_cc_resp resp_t;
+    typedef hpdcache_test_cc_mem_req mem_req_t;
+    typedef hpdcache_test_cc_mem_read_resp mem_read_resp_t;
+    typedef hpdcache_test_cc_mem_write_resp mem_write_resp_t;
+
+public:
+    explicit hpdcache_test_cc_scoreboard(Vhpdcache_wrapper* top)
+      : top_m(top)
+      , seq_m(nullptr)
+    {
+    }
+
+    ~hpdcache_test_cc_scoreboard()
+    {
+        std::stringstream ss;
+
+        check_end();
+        if (seq_m && seq_m->ids_size() > 0) {
+            ss.str("");
+            ss << "unresponded ids (sid = " << seq_m->get_sid() << "):";
+            for (auto it : seq_m->get_ids()) {
+                ss << " 0x" << std::hex << it << std::dec;
+            }
+            print_error(ss.str());
+        }
+
+        if (Logger::get_log_level() >= Logger::LOG_LOW) {
+            ss.str("");
+            print_stats(ss);
+
+            std::cout << ss.str() << std::endl;
+        }
+    }
+
+    //  Set the sequence generating the requests. The scoreboard releases the
+    //  transaction IDs once the corresponding requests are completed
+    void set_sequence(hpdcache_test_cc_sequence* p) { seq_m = p; }
+
+    void set_mem_model(hpdcache_test_cc_mem_model* p) { mem_model_m = p; }
+
+    //  Count the events of the cache (value just before the rising edge)
+    void sample()
+    {
+        nb_cycles++;
+        if (top_m->evt_cache_write_miss_o) evt_cache_write_miss++;
+        if (top_m->evt_cache_read_miss_o) evt_cache_read_miss++;
+        if (top_m->evt_cache_dir_unc_err_o) evt_cache_dir_unc_err++;
+        if (top_m->evt_cache_dir_cor_err_o) evt_cache_dir_cor_err++;
+        if (top_m->evt_cache_dat_unc_err_o) evt_cache_dat_unc_err++;
+        if (top_m->evt_cache_dat_cor_err_o) evt_cache_dat_cor_err++;
+        if (top_m->evt_scrub_complete_o) evt_scrub_complete++;
+        if (top_m->evt_uncached_req_o) evt_uncached_req++;
+        if (top_m->evt_cmo_req_o) evt_cmo_req++;
+        if (top_m->evt_write_req_o) evt_write_req++;
+        if (top_m->evt_read_req_o) evt_read_req++;
+        if (top_m->evt_prefetch_req_o) evt_prefetch_req++;
+        if (top_m->evt_req_on_hold_o) evt_req_on_hold++;
+        if (top_m->evt_rtab_rollback_o) evt_rtab_rollback++;
+        if (top_m->evt_stall_refill_o) evt_stall_refill++;
+        if (top_m->evt_stall_o) evt_stall++;
+    }
+
+    void core_req(const req_t& req)
+    {
+        if (Logger::get_log_level() >= Logger::LOG_MEDIUM) {
+            std::cout << "cycle " << nb_cycles << " / " << req.to_string() << std::endl;
+        }
+
+        inflight_entry_t e;
+        e.sid = req.sid;
+        e.tid = req.tid;
+        e.addr = req.addr;
+        e.need_rsp = req.need_rsp;
+        e.hit = false;
+        e.is_read = req.is_load();
+        e.is_write = req.is_store();
+        e.is_amo = req.is_amo();
+        e.is_amo_lr = req.is_amo_lr();
+        e.is_amo_sc = req.is_amo_sc();
+        e.is_cmo = req.is_cmo();
+        e.is_prefetch = req.is_cmo_prefetch();
+        e.is_uncacheable = req.uncacheable;
+        e.bytes = 1 << req.size;
+        e.op = req.op;
+        memcpy(e.wdata, req.wdata, CORE_REQ_BYTES);
+        memcpy(e.be, req.be, sizeof(e.be));
+
+        check_core_req(e);
+    }
+
+    void core_resp(const resp_t& resp)
+    {
+        if (Logger::get_log_level() >= Logger::LOG_MEDIUM) {
+            std::cout << "cycle " << nb_cycles << " / " << resp.to_string() << std::endl;
+        }
+
+        check_core_resp(resp.sid, resp.tid, resp.error, resp.rdata);
+    }
+
+    void mem_read_req(const mem_req_t& req) override
+    {
+        if (Logger::get_log_level() >= Logger::LOG_MEDIUM) {
+            std::cout << "cycle " << nb_cycles << " / " << req.to_string("MEM_READ_REQ")
+                      << std::endl;
+        }
+
+        check_mem_read_req(req);
+    }
+
+    void mem_read_resp(const mem_read_resp_t& resp) override
+    {
+        if (Logger::get_log_level() >= Logger::LOG_MEDIUM) {
+            std::cout << "cycle " << nb_cycles << " / " << resp.to_string() << std::endl;
+        }
+
+        check_mem_read_resp(resp.id, resp.error, resp.last, resp.data);
+    }
+
+    void mem_write_req(const mem_req_t& req) override
+    {
+        if (Logger::get_log_level() >= Logger::LOG_MEDIUM) {
+            std::cout << "cycle " << nb_cycles << " / " << req.to_string("MEM_WRITE_REQ")
+                      << std::endl;
+        }
+
+        check_mem_write_req(req);
+    }
+
+    void mem_write_resp(const mem_write_resp_t& resp) override
+    {
+        if (Logger::get_log_level() >= Logger::LOG_MEDIUM) {
+            std::cout << "cycle " << nb_cycles << " / " << resp.to_string() << std::endl;
+        }
+
+        check_mem_write_resp(resp.id, resp.is_atomic);
+    }
+
+private:
+    Vhpdcache_wrapper* top_m;
+    hpdcache_test_cc_sequence* seq_m;
+
+    //  Hooks of the checks (see hpdcache_test_scoreboard_base)
+    //  {{{
+    std::string timestamp() const override
+    {
+        std::stringstream ss;
+        ss << "cycle " << nb_cycles;
+        return ss.str();
+    }
+
+    bool debug_enabled() const override { return Logger::get_log_level() >= Logger::LOG_DEBUG; }
+
+    const char* op_to_string(unsigned op) const override { return req_t::op_to_string(op); }
+
+    uint64_t compute_amo(unsigned op,
+                         uint64_t ld_data,
+                         uint64_t st_data,
+                         unsigned bytes) const override
+    {
+        return hpdcache_test_amo::compute_amo<req_t>(op, ld_data, st_data, bytes);
+    }
+
+    //  There is a single requester
+    void deallocate_id(unsigned, unsigned tid) override
+    {
+        if (!seq_m) {
+            print_error("no sequence associated to the scoreboard");
+            return;
+        }
+        seq_m->deallocate_id(tid);
+    }
+    //  }}}
+};
+
+#endif /* __HPDCACHE_TEST_CC_SCOREBOARD_H__ */
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
\ No newline at end of file
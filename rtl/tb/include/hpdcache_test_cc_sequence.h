@@ -0,0 +1,104 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Base class of the sequences of the HPDCACHE testbench without
+ *               SystemC. A sequence does not run in a thread: the driver pulls
+ *               the requests from it
+ */
+#ifndef __HPDCACHE_TEST_CC_SEQUENCE_H__
+#define __HPDCACHE_TEST_CC_SEQUENCE_H__
+
+#include "hpdcache_test_cc_mem_model.h"
+#include "hpdcache_test_cc_random.h"
+#include "hpdcache_test_cc_transaction.h"
+#include "hpdcache_test_defs.h"
+#include <algorithm>
+#include <iostream>
+#include <list>
+#include <string>
+
+class hpdcache_test_cc_sequence
+{
+    static constexpr unsigned HPDCACHE_REQ_MAX_TRANS_ID = 1 << HPDCACHE_REQ_TRANS_ID_WIDTH;
+
+public:
+    hpdcache_test_cc_sequence(const std::string& seq_name, uint64_t seed)
+      : name(seq_name)
+      , max_transactions(100)
+      , sid(0)
+      , rng(seed)
+      , mem_model(nullptr)
+    {
+        std::cout << "Building " << seq_name << std::endl;
+    }
+
+    virtual ~hpdcache_test_cc_sequence() {}
+
+    //  Get the next request of the sequence, and the nb of cycles to wait
+    //  after it is sent. Return false when there is no request to send in this
+    //  cycle (e.g. no free transaction ID) or when the sequence is done
+    virtual bool next(hpdcache_test_cc_req& req, unsigned& delay) = 0;
+
+    //  There are no more requests to send
+    virtual bool is_done() const = 0;
+
+    bool is_available_id() const { return (ids.size() < HPDCACHE_REQ_MAX_TRANS_ID); }
+
+    unsigned int allocate_id()
+    {
+        unsigned int id;
+
+        assert(is_available_id());
+
+        id = rng() % HPDCACHE_REQ_MAX_TRANS_ID;
+        for (;;) {
+            auto it = std::find(ids.begin(), ids.end(), id);
+            if (it == ids.end()) {
+                ids.insert(it, id);
+                break;
+            }
+            id = (id + 1) % HPDCACHE_REQ_MAX_TRANS_ID;
+        }
+        return id;
+    }
+
+    void deallocate_id(unsigned int id)
+    {
+        auto it = std::find(ids.begin(), ids.end(), id);
+        if (it != ids.end()) {
+            ids.erase(it);
+            return;
+        }
+
+        std::cout << "SEQ_ERROR: acknowledging an ID that is not currently used" << std::endl;
+    }
+
+    void set_max_transactions(size_t max_transactions)
+    {
+        this->max_transactions = max_transactions;
+    }
+
+    unsigned int get_sid() const { return sid; }
+
+    const std::list<unsigned int>& get_ids() const { return ids; }
+
+    size_t ids_size() const { return ids.size(); }
+
+    //  Memory model where the sequence declares its error segments (if any)
+    void set_mem_model(hpdcache_test_cc_mem_model* p) { mem_model = p; }
+
+protected:
+    std::list<unsigned int> ids;
+    std::string name;
+    size_t max_transactions;
+    unsigned int sid;
+    hpdcache_test_cc_rng rng;
+    hpdcache_test_cc_mem_model* mem_model;
+};
+
+#endif /* __HPDCACHE_TEST_CC_SEQUENCE_H__ */
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
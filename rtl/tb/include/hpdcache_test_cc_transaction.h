@@ -0,0 +1,347 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Transactions of the HPDCACHE testbench without SystemC. They
+ *               have the same fields as the ones of hpdcache_test_transaction.h,
+ *               but the data are arrays of bytes instead of SystemC bit vectors
+ */
+#ifndef __HPDCACHE_TEST_CC_TRANSACTION_H__
+#define __HPDCACHE_TEST_CC_TRANSACTION_H__
+
+#include "hpdcache_test_defs.h"
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//  Bitmaps of byte enables (and of valid bytes) have one bit per byte, packed
+//  in bytes as in the RAM model of the scoreboard
+static inline bool
+hpdcache_test_cc_get_bit(const uint8_t* bmap, unsigned i)
+{
+    return ((bmap[i / 8] >> (i % 8)) & 0x1) != 0;
+}
+
+static inline void
+hpdcache_test_cc_set_bit(uint8_t* bmap, unsigned i)
+{
+    bmap[i / 8] |= (1 << (i % 8));
+}
+
+//  Little-endian load (store) of n bytes (at most 8) from (into) a buffer
+static inline uint64_t
+hpdcache_test_cc_load(const uint8_t* buf, unsigned n)
+{
+    uint64_t ret = 0;
+    memcpy(&ret, buf, n);
+    return ret;
+}
+
+static inline void
+hpdcache_test_cc_store(uint8_t* buf, uint64_t v, unsigned n)
+{
+    memcpy(buf, &v, n);
+}
+
+class hpdcache_test_cc_req
+{
+public:
+    static constexpr unsigned DATA_BYTES = HPDCACHE_REQ_DATA_WIDTH / 8;
+    static constexpr unsigned BE_BYTES = (DATA_BYTES + 7) / 8;
+
+    enum hpdcache_req_op_e
+    {
+        HPDCACHE_REQ_LOAD = 0x00,
+        HPDCACHE_REQ_STORE = 0x01,
+        HPDCACHE_REQ_AMO_LR = 0x04,
+        HPDCACHE_REQ_AMO_SC = 0x05,
+        HPDCACHE_REQ_AMO_SWAP = 0x06,
+        HPDCACHE_REQ_AMO_ADD = 0x07,
+        HPDCACHE_REQ_AMO_AND = 0x08,
+        HPDCACHE_REQ_AMO_OR = 0x09,
+        HPDCACHE_REQ_AMO_XOR = 0x0a,
+        HPDCACHE_REQ_AMO_MAX = 0x0b,
+        HPDCACHE_REQ_AMO_MAXU = 0x0c,
+        HPDCACHE_REQ_AMO_MIN = 0x0d,
+        HPDCACHE_REQ_AMO_MINU = 0x0e,
+        HPDCACHE_REQ_CMO_FENCE = 0x10,
+        HPDCACHE_REQ_CMO_PREFETCH = 0x11,
+        HPDCACHE_REQ_CMO_INVAL_NLINE = 0x12,
+        HPDCACHE_REQ_CMO_INVAL_ALL = 0x13,
+        HPDCACHE_REQ_CMO_FLUSH_NLINE = 0x14,
+        HPDCACHE_REQ_CMO_FLUSH_ALL = 0x15,
+        HPDCACHE_REQ_CMO_FLUSH_INVAL_NLINE = 0x16,
+        HPDCACHE_REQ_CMO_FLUSH_INVAL_ALL = 0x17
+    };
+
+    enum hpdcache_wr_policy_hint_e
+    {
+        HPDCACHE_WR_POLICY_AUTO = 0x1,
+        HPDCACHE_WR_POLICY_WB = 0x2,
+        HPDCACHE_WR_POLICY_WT = 0x4
+    };
+
+    uint64_t addr;
+    uint8_t wdata[DATA_BYTES];
+    uint8_t be[BE_BYTES];
+    unsigned op;
+    unsigned size;
+    unsigned sid;
+    unsigned tid;
+    unsigned wr_policy_hint;
+    bool need_rsp;
+    bool phys_indexed;
+    bool uncacheable;
+    bool io;
+    bool abort;
+
+    hpdcache_test_cc_req()
+      : addr(0)
+      , op(HPDCACHE_REQ_LOAD)
+      , size(0)
+      , sid(0)
+      , tid(0)
+      , wr_policy_hint(HPDCACHE_WR_POLICY_AUTO)
+      , need_rsp(false)
+      , phys_indexed(false)
+      , uncacheable(false)
+      , io(false)
+      , abort(false)
+    {
+        memset(wdata, 0, sizeof(wdata));
+        memset(be, 0, sizeof(be));
+    }
+
+    //  Enable the bytes of the access (size and offset of the address)
+    void set_be_from_size()
+    {
+        const unsigned offset = addr % DATA_BYTES;
+        memset(be, 0, sizeof(be));
+        for (unsigned i = offset; (i < offset + (1U << size)) && (i < DATA_BYTES); i++) {
+            hpdcache_test_cc_set_bit(be, i);
+        }
+    }
+
+    bool is_load() const { return op == HPDCACHE_REQ_LOAD; }
+
+    bool is_store() const { return op == HPDCACHE_REQ_STORE; }
+
+    bool is_amo_lr() const { return op == HPDCACHE_REQ_AMO_LR; }
+
+    bool is_amo_sc() const { return op == HPDCACHE_REQ_AMO_SC; }
+
+    bool is_amo() const { return (op >= HPDCACHE_REQ_AMO_SWAP) && (op <= HPDCACHE_REQ_AMO_MINU); }
+
+    bool is_cmo() const
+    {
+        return (op >= HPDCACHE_REQ_CMO_FENCE) && (op <= HPDCACHE_REQ_CMO_FLUSH_INVAL_ALL);
+    }
+
+    bool is_cmo_prefetch() const { return op == HPDCACHE_REQ_CMO_PREFETCH; }
+
+    static const char* op_to_string(unsigned op)
+    {
+        switch (op) {
+            case HPDCACHE_REQ_LOAD: return "LOAD";
+            case HPDCACHE_REQ_STORE: return "STORE";
+            case HPDCACHE_REQ_AMO_LR: return "AMO_LR";
+            case HPDCACHE_REQ_AMO_SC: return "AMO_SC";
+            case HPDCACHE_REQ_AMO_SWAP: return "AMO_SWAP";
+            case HPDCACHE_REQ_AMO_ADD: return "AMO_ADD";
+            case HPDCACHE_REQ_AMO_AND: return "AMO_AND";
+            case HPDCACHE_REQ_AMO_OR: return "AMO_OR";
+            case HPDCACHE_REQ_AMO_XOR: return "AMO_XOR";
+            case HPDCACHE_REQ_AMO_MAX: return "AMO_MAX";
+            case HPDCACHE_REQ_AMO_MAXU: return "AMO_MAXU";
+            case HPDCACHE_REQ_AMO_MIN: return "AMO_MIN";
+            case HPDCACHE_REQ_AMO_MINU: return "AMO_MINU";
+            case HPDCACHE_REQ_CMO_FENCE: return "CMO_FENCE";
+            case HPDCACHE_REQ_CMO_PREFETCH: return "CMO_PREFETCH";
+            case HPDCACHE_REQ_CMO_INVAL_NLINE: return "CMO_INVAL_NLINE";
+            case HPDCACHE_REQ_CMO_INVAL_ALL: return "CMO_INVAL_ALL";
+            case HPDCACHE_REQ_CMO_FLUSH_NLINE: return "CMO_FLUSH_NLINE";
+            case HPDCACHE_REQ_CMO_FLUSH_ALL: return "CMO_FLUSH_ALL";
+            case HPDCACHE_REQ_CMO_FLUSH_INVAL_NLINE: return "CMO_FLUSH_INVAL_NLINE";
+            case HPDCACHE_REQ_CMO_FLUSH_INVAL_ALL: return "CMO_FLUSH_INVAL_ALL";
+        }
+        return "UNKNOWN";
+    }
+
+    const std::string to_string() const
+    {
+        std::stringstream os;
+        os << "CORE_REQ / @ = 0x" << std::hex << addr << std::dec << " / " << op_to_string(op)
+           << " / SID = 0x" << std::hex << sid << std::dec << " / TID = 0x" << std::hex << tid
+           << std::dec;
+        if (!is_cmo()) {
+            os << (uncacheable ? " / UNCACHED" : " / CACHED") << " / SIZE = 0x" << std::hex
+               << size << std::dec << (need_rsp ? " / NEED_RSP" : " / NO NEED_RSP");
+        }
+        if (is_store() || is_amo() || is_amo_sc()) {
+            os << " / WDATA = 0x" << std::hex;
+            for (int i = DATA_BYTES - 1; i >= 0; i--) {
+                os << std::setw(2) << std::setfill('0') << (unsigned)wdata[i];
+            }
+            os << std::dec << std::setfill(' ');
+        }
+        return os.str();
+    }
+};
+
+class hpdcache_test_cc_resp
+{
+public:
+    static constexpr unsigned DATA_BYTES = HPDCACHE_REQ_DATA_WIDTH / 8;
+
+    uint8_t rdata[DATA_BYTES];
+    unsigned sid;
+    unsigned tid;
+    bool error;
+    bool aborted;
+
+    const std::string to_string() const
+    {
+        std::stringstream os;
+        os << "CORE_RESP / RDATA = 0x" << std::hex;
+        for (int i = DATA_BYTES - 1; i >= 0; i--) {
+            os << std::setw(2) << std::setfill('0') << (unsigned)rdata[i];
+        }
+        os << std::setfill(' ') << " / SID = 0x" << sid << " / TID = 0x" << tid << std::dec
+           << (error ? " / ERROR" : "") << (aborted ? " / ABORTED" : "");
+        return os.str();
+    }
+};
+
+class hpdcache_test_cc_mem_req
+{
+public:
+    static constexpr unsigned DATA_BYTES = HPDCACHE_MEM_DATA_WIDTH / 8;
+
+    enum hpdcache_mem_command_e
+    {
+        HPDCACHE_MEM_READ = 0x0,
+        HPDCACHE_MEM_WRITE = 0x1,
+        HPDCACHE_MEM_ATOMIC = 0x2
+    };
+
+    enum hpdcache_mem_atomic_e
+    {
+        HPDCACHE_MEM_ATOMIC_ADD = 0x0,
+        HPDCACHE_MEM_ATOMIC_CLR = 0x1,
+        HPDCACHE_MEM_ATOMIC_SET = 0x2,
+        HPDCACHE_MEM_ATOMIC_EOR = 0x3,
+        HPDCACHE_MEM_ATOMIC_SMAX = 0x4,
+        HPDCACHE_MEM_ATOMIC_SMIN = 0x5,
+        HPDCACHE_MEM_ATOMIC_UMAX = 0x6,
+        HPDCACHE_MEM_ATOMIC_UMIN = 0x7,
+        HPDCACHE_MEM_ATOMIC_SWAP = 0x8,
+        HPDCACHE_MEM_ATOMIC_LDEX = 0xc,
+        HPDCACHE_MEM_ATOMIC_STEX = 0xd
+    };
+
+    uint64_t addr;
+    unsigned len;
+    unsigned size;
+    unsigned id;
+    unsigned command;
+    unsigned atomic;
+    bool cacheable;
+    bool wrap; //  wrapping burst (read requests only)
+
+    //  Write data and byte enable of the flits of the burst (write requests
+    //  only), with DATA_BYTES bytes of data and DATA_BYTES / 8 bytes of byte
+    //  enable per flit
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> be;
+    bool last;
+
+    //  Index of the first flit of the burst with an unexpected last flag (-1
+    //  if only the last flit has the last flag)
+    int bad_last_flit;
+
+    bool is_amo() const
+    {
+        return (command == HPDCACHE_MEM_ATOMIC) && (atomic != HPDCACHE_MEM_ATOMIC_STEX)
+               && (atomic != HPDCACHE_MEM_ATOMIC_LDEX);
+    }
+
+    bool is_stex() const
+    {
+        return (command == HPDCACHE_MEM_ATOMIC) && (atomic == HPDCACHE_MEM_ATOMIC_STEX);
+    }
+
+    bool is_ldex() const
+    {
+        return (command == HPDCACHE_MEM_ATOMIC) && (atomic == HPDCACHE_MEM_ATOMIC_LDEX);
+    }
+
+    const std::string to_string(const char* channel) const
+    {
+        std::stringstream os;
+        os << channel << " / ADDR = 0x" << std::hex << addr << std::dec << " / LEN = 0d" << len
+           << " / SIZE = 0d" << size << " / ID = 0x" << std::hex << id << std::dec
+           << " / COMMAND = 0x" << std::hex << command << " / ATOMIC = 0x" << atomic << std::dec
+           << (cacheable ? " / CACHEABLE" : " / UNCACHEABLE") << (wrap ? " / WRAP" : "");
+        return os.str();
+    }
+};
+
+class hpdcache_test_cc_mem_read_resp
+{
+public:
+    static constexpr unsigned DATA_BYTES = HPDCACHE_MEM_DATA_WIDTH / 8;
+
+    uint8_t data[DATA_BYTES];
+    unsigned id;
+    bool error;
+    bool last;
+
+    const std::string to_string() const
+    {
+        std::stringstream os;
+        os << "MEM_READ_RESP / ID = 0x" << std::hex << id << std::dec
+           << (error ? " / ERROR" : "") << (last ? " / LAST" : "");
+        return os.str();
+    }
+};
+
+class hpdcache_test_cc_mem_write_resp
+{
+public:
+    unsigned id;
+    bool error;
+    bool is_atomic;
+
+    const std::string to_string() const
+    {
+        std::stringstream os;
+        os << "MEM_WRITE_RESP / ID = 0x" << std::hex << id << std::dec
+           << (error ? " / ERROR" : "") << (is_atomic ? " / ATOMIC" : "");
+        return os.str();
+    }
+};
+
+/**
+ * @class hpdcache_test_cc_mem_listener
+ * @brief Observer of the transactions on the memory interface of the HPDcache
+ *        (i.e. the scoreboard). It has the role of the sb_mem_* FIFOs of the
+ *        SystemC testbench
+ */
+class hpdcache_test_cc_mem_listener
+{
+public:
+    virtual ~hpdcache_test_cc_mem_listener() {}
+    virtual void mem_read_req(const hpdcache_test_cc_mem_req& req) = 0;
+    virtual void mem_read_resp(const hpdcache_test_cc_mem_read_resp& resp) = 0;
+    virtual void mem_write_req(const hpdcache_test_cc_mem_req& req) = 0;
+    virtual void mem_write_resp(const hpdcache_test_cc_mem_write_resp& resp) = 0;
+};
+
+#endif /* __HPDCACHE_TEST_CC_TRANSACTION_H__ */
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
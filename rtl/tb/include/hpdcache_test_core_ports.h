@@ -0,0 +1,113 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Adapter between the per-requester agent ports and the packed
+ *               requester ports of the HPDCACHE wrapper (multi-requester mode)
+ */
+#ifndef __HPDCACHE_TEST_CORE_PORTS_H__
+#define __HPDCACHE_TEST_CORE_PORTS_H__
+
+#include "hpdcache_test_defs.h"
+#include <systemc>
+
+using namespace sc_core;
+using namespace sc_dt;
+
+class hpdcache_test_core_ports : public sc_module
+{
+    static_assert(NREQUESTERS > 1, "multi-requester mode needs at least two requesters");
+
+public:
+    //  Agent side (one port per requester)
+    sc_in<bool> core_req_valid_i[NREQUESTERS];
+    sc_out<bool> core_req_ready_o[NREQUESTERS];
+    sc_in<sc_bv<HPDCACHE_CORE_REQ_WIDTH>> core_req_i[NREQUESTERS];
+    sc_in<bool> core_req_abort_i[NREQUESTERS];
+    sc_in<sc_bv<HPDCACHE_TAG_WIDTH>> core_req_tag_i[NREQUESTERS];
+    sc_in<sc_bv<HPDCACHE_REQ_PMA_WIDTH>> core_req_pma_i[NREQUESTERS];
+    sc_out<bool> core_rsp_valid_o[NREQUESTERS];
+    sc_out<sc_bv<HPDCACHE_CORE_RSP_WIDTH>> core_rsp_o[NREQUESTERS];
+
+    //  Cache side (the element of requester i is at position i of each vector)
+    sc_out<sc_bv<NREQUESTERS>> cache_req_valid_o;
+    sc_in<sc_bv<NREQUESTERS>> cache_req_ready_i;
+    sc_out<sc_bv<NREQUESTERS * HPDCACHE_CORE_REQ_WIDTH>> cache_req_o;
+    sc_out<sc_bv<NREQUESTERS>> cache_req_abort_o;
+    sc_out<sc_bv<NREQUESTERS * HPDCACHE_TAG_WIDTH>> cache_req_tag_o;
+    sc_out<sc_bv<NREQUESTERS * HPDCACHE_REQ_PMA_WIDTH>> cache_req_pma_o;
+    sc_in<sc_bv<NREQUESTERS>> cache_rsp_valid_i;
+    sc_in<sc_bv<NREQUESTERS * HPDCACHE_CORE_RSP_WIDTH>> cache_rsp_i;
+
+    hpdcache_test_core_ports(sc_module_name nm)
+      : sc_module(nm)
+      , cache_req_valid_o("cache_req_valid_o")
+      , cache_req_ready_i("cache_req_ready_i")
+      , cache_req_o("cache_req_o")
+      , cache_req_abort_o("cache_req_abort_o")
+      , cache_req_tag_o("cache_req_tag_o")
+      , cache_req_pma_o("cache_req_pma_o")
+      , cache_rsp_valid_i("cache_rsp_valid_i")
+      , cache_rsp_i("cache_rsp_i")
+    {
+        SC_METHOD(pack_requests);
+        for (int i = 0; i < NREQUESTERS; i++) {
+            sensitive << core_req_valid_i[i] << core_req_i[i] << core_req_abort_i[i]
+                      << core_req_tag_i[i] << core_req_pma_i[i];
+        }
+
+        SC_METHOD(unpack_responses);
+        sensitive << cache_req_ready_i << cache_rsp_valid_i << cache_rsp_i;
+    }
+
+private:
+#if SC_VERSION_MAJOR < 3
+    SC_HAS_PROCESS(hpdcache_test_core_ports);
+#endif
+
+    void pack_requests()
+    {
+        sc_bv<NREQUESTERS> valid;
+        sc_bv<NREQUESTERS * HPDCACHE_CORE_REQ_WIDTH> req;
+        sc_bv<NREQUESTERS> abort;
+        sc_bv<NREQUESTERS * HPDCACHE_TAG_WIDTH> tag;
+        sc_bv<NREQUESTERS * HPDCACHE_REQ_PMA_WIDTH> pma;
+
+        for (int i = 0; i < NREQUESTERS; i++) {
+            valid[i] = core_req_valid_i[i].read();
+            req.range((i + 1) * HPDCACHE_CORE_REQ_WIDTH - 1, i * HPDCACHE_CORE_REQ_WIDTH) =
+                core_req_i[i].read();
+            abort[i] = core_req_abort_i[i].read();
+            tag.range((i + 1) * HPDCACHE_TAG_WIDTH - 1, i * HPDCACHE_TAG_WIDTH) =
+                core_req_tag_i[i].read();
+            pma.range((i + 1) * HPDCACHE_REQ_PMA_WIDTH - 1, i * HPDCACHE_REQ_PMA_WIDTH) =
+                core_req_pma_i[i].read();
+        }
+
+        cache_req_valid_o.write(valid);
+        cache_req_o.write(req);
+        cache_req_abort_o.write(abort);
+        cache_req_tag_o.write(tag);
+        cache_req_pma_o.write(pma);
+    }
+
+    void unpack_responses()
+    {
+        const sc_bv<NREQUESTERS> ready = cache_req_ready_i.read();
+        const sc_bv<NREQUESTERS> valid = cache_rsp_valid_i.read();
+        const sc_bv<NREQUESTERS * HPDCACHE_CORE_RSP_WIDTH> rsp = cache_rsp_i.read();
+
+        for (int i = 0; i < NREQUESTERS; i++) {
+            core_req_ready_o[i].write(ready.get_bit(i) != 0);
+            core_rsp_valid_o[i].write(valid.get_bit(i) != 0);
+            core_rsp_o[i].write(
+                rsp.range((i + 1) * HPDCACHE_CORE_RSP_WIDTH - 1, i * HPDCACHE_CORE_RSP_WIDTH));
+        }
+    }
+};
+
+#endif // __HPDCACHE_TEST_CORE_PORTS_H__
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
@@ -12,8 +12,6 @@
 #ifndef __HPDCACHE_TEST_DEFS_H__
 #define __HPDCACHE_TEST_DEFS_H__
 
-#include <systemc>
-
 #define HPDCACHE_TEST_DEFS_LOG2(x)                                                                 \
     (x <= 1       ? 0                                                                              \
      : x <= 2     ? 1                                                                              \
@@ -32,8 +30,6 @@
      : x <= 16384 ? 14                                                                             \
                   : 0)
 
-#define SCOREBOARD_RAM_SIZE (16 << 20) // Bytes
-
 #ifndef CONF_HPDCACHE_WAYS
 #define HPDCACHE_WAYS 8
 #else
@@ -132,7 +128,7 @@
 #define HPDCACHE_REQ_TRANS_ID_WIDTH (CONF_HPDCACHE_REQ_TRANS_ID_WIDTH)
 #endif
 
-#define NREQUESTERS 8
+#define NREQUESTERS (1 << (HPDCACHE_REQ_SRC_ID_WIDTH))
 
 #define HPDCACHE_SET_WIDTH HPDCACHE_TEST_DEFS_LOG2(HPDCACHE_SETS)
 #define HPDCACHE_CL_OFFSET_WIDTH                                                                   \
@@ -19,6 +19,7 @@
 #include "hpdcache_fault_injection.h"
 #endif
 #include "logger.h"
+#include <sstream>
 #include <string>
 #include <systemc>
 #include <verilated.h>
@@ -45,14 +46,65 @@ public:
 
     hpdcache_test_driver(sc_core::sc_module_name nm)
       : Driver(nm)
+      , pipelined(false)
+      , done(false)
+      , nb_cycles(0)
+      , nb_requests(0)
+      , nb_valid_cycles(0)
+      , nb_bubbles(0)
+      , first_req_cycle(0)
+      , last_req_cycle(0)
     {
         SC_THREAD(drive_request);
         sensitive << clk_i.pos();
 
         SC_THREAD(monitor_response);
         sensitive << clk_i.neg();
+
+        SC_METHOD(count_cycles);
+        sensitive << clk_i.pos();
+
+        nb_running_drivers++;
     };
 
+    ~hpdcache_test_driver()
+    {
+        if (sc_core::sc_report_handler::get_verbosity_level() >= sc_core::SC_LOW) {
+            std::stringstream ss;
+            const uint64_t nb_active_cycles =
+                (nb_requests > 0) ? (last_req_cycle - first_req_cycle + 1) : 0;
+
+            ss << "DRIVER STATISTICS (" << name() << ")" << std::endl
+               << "--------------------------------------------------" << std::endl
+               << "DRV.MODE                : " << (pipelined ? "pipelined" : "blocking")
+               << std::endl
+               << "DRV.NB_REQUESTS         : " << nb_requests << std::endl
+               << "DRV.NB_VALID_CYCLES     : " << nb_valid_cycles << std::endl
+               << "DRV.NB_ACTIVE_CYCLES    : " << nb_active_cycles << std::endl
+               << "DRV.NB_BUBBLES          : " << nb_bubbles << std::endl
+               << std::endl
+
+               << "Computed values" << std::endl
+               << "---------------" << std::endl
+               << "Requests per cycle      : "
+               << (nb_active_cycles > 0 ? (double)nb_requests / nb_active_cycles : 0)
+               << std::endl
+               << "Requests per valid cycle: "
+               << (nb_valid_cycles > 0 ? (double)nb_requests / nb_valid_cycles : 0) << std::endl;
+
+            std::cout << ss.str() << std::endl;
+        }
+    }
+
+    //  When enabled, the driver acknowledges each transaction as soon as it fetches
+    //  it, so the sequence runs ahead of the cache (up to the depth of the
+    //  transaction FIFO), and it keeps the valid signal asserted while transactions
+    //  are available. This allows one request per cycle. The sequence shall run
+    //  ahead too (see hpdcache_test_sequence::set_run_ahead)
+    void set_pipelined(bool enable) { pipelined = enable; }
+
+    bool is_pipelined() const { return pipelined; }
+
 private:
 #if SC_VERSION_MAJOR < 3
     SC_HAS_PROCESS(hpdcache_test_driver);
@@ -62,6 +114,20 @@ private:
 
     typedef std::shared_ptr<hpdcache_test_transaction_req> transaction_ptr;
 
+    bool pipelined;
+    bool done;
+
+    uint64_t nb_cycles;
+    uint64_t nb_requests;
+    uint64_t nb_valid_cycles;
+    uint64_t nb_bubbles;
+    uint64_t first_req_cycle;
+    uint64_t last_req_cycle;
+
+    //  Number of drivers that still have transactions to send. The simulation
+    //  finishes when all drivers are done and there are no inflight requests
+    inline static unsigned nb_running_drivers = 0;
+
     static inline uint64_t core_get_req_tag(const transaction_ptr& t)
     {
         sc_bv<HPDCACHE_TAG_WIDTH> ret;
@@ -131,7 +197,47 @@ private:
         resp.rsp_rdata = bv.range(RDATA_POS + HPDCACHE_REQ_DATA_WIDTH - 1, RDATA_POS);
     }
 
-    void drive_request()
+    void count_cycles()
+    {
+        nb_cycles++;
+
+        //  in pipelined mode, the valid signal shall not be released while a
+        //  transaction is waiting in the FIFO
+        if (pipelined && !done && !core_req_valid_o.read() &&
+            (transaction_fifo_i->num_available() > 0))
+        {
+            nb_bubbles++;
+        }
+    }
+
+    void inject_fault(const transaction_ptr& t)
+    {
+        if (!t->req_fault.valid) return;
+
+        switch (t->req_fault.domain) {
+            case hpdcache_fault_injection::domain_e::CACHE_DIR:
+                faultInj.injectDirFault(
+                    t->req_fault.set, t->req_fault.way, t->req_fault.fault_mask.range(63, 0));
+                break;
+            case hpdcache_fault_injection::domain_e::CACHE_DAT:
+                faultInj.injectDatFault(t->req_fault.set,
+                                        t->req_fault.way,
+                                        t->req_fault.word,
+                                        t->req_fault.fault_mask.range(71, 0));
+                break;
+            default:
+                break;
+        }
+    }
+
+    void count_request()
+    {
+        if (nb_requests == 0) first_req_cycle = nb_cycles;
+        last_req_cycle = nb_cycles;
+        nb_requests++;
+    }
+
+    void drive_request_blocking()
     {
         transaction_ptr t;
         for (;;) {
@@ -139,29 +245,16 @@ private:
 
             if (t == nullptr) break;
 
-            if (t->req_fault.valid) {
-                switch (t->req_fault.domain) {
-                    case hpdcache_fault_injection::domain_e::CACHE_DIR:
-                        faultInj.injectDirFault(t->req_fault.set,
-                                                t->req_fault.way,
-                                                t->req_fault.fault_mask.range(63, 0));
-                        break;
-                    case hpdcache_fault_injection::domain_e::CACHE_DAT:
-                        faultInj.injectDatFault(t->req_fault.set,
-                                                t->req_fault.way,
-                                                t->req_fault.word,
-                                                t->req_fault.fault_mask.range(71, 0));
-                        break;
-                    default:
-                        break;
-                }
-            }
+            inject_fault(t);
 
             core_req_valid_o.write(true);
             core_req_o.write(core_req_to_bv(t));
-            do wait();
-            while (!core_req_ready_i.read());
+            do {
+                wait();
+                nb_valid_cycles++;
+            } while (!core_req_ready_i.read());
             core_req_valid_o.write(false);
+            count_request();
 
             // send the tag
             core_req_tag_o.write(core_get_req_tag(t));
@@ -173,13 +266,94 @@ private:
             //  send request to the scoreboard
             sb_core_req_o.write(*t);
         }
+    }
+
+    //  Get the next transaction from the sequence. The transaction is copied, so
+    //  it is acknowledged right away: the sequence may then release it and
+    //  prepare the next one while this one is presented to the cache
+    bool fetch_request(hpdcache_test_transaction_req& req, bool blocking)
+    {
+        std::shared_ptr<Transaction> p;
+        transaction_ptr t;
+
+        if (done) return false;
+
+        if (blocking) {
+            p = transaction_fifo_i.read();
+        } else if (!transaction_fifo_i.nb_read(p)) {
+            return false;
+        }
+
+        t = std::dynamic_pointer_cast<hpdcache_test_transaction_req>(p);
+        if (t == nullptr) {
+            done = true;
+            return false;
+        }
+
+        req = *t;
+        transaction_ret_o.write(t->get_id());
+        return true;
+    }
+
+    void drive_request_pipelined()
+    {
+        hpdcache_test_transaction_req req;
+        transaction_ptr t = std::make_shared<hpdcache_test_transaction_req>();
+        bool valid;
+
+        valid = fetch_request(req, true);
+        while (valid) {
+            *t = req;
+            inject_fault(t);
+
+            core_req_valid_o.write(true);
+            core_req_o.write(core_req_to_bv(t));
+            do {
+                wait();
+                nb_valid_cycles++;
+            } while (!core_req_ready_i.read());
+            count_request();
+
+            //  send the tag of the accepted request (second cycle of the request)
+            core_req_tag_o.write(core_get_req_tag(t));
+            core_req_pma_o.write(core_get_req_pma(t));
+            core_req_abort_o.write(t->is_aborted());
+
+            //  send request to the scoreboard
+            sb_core_req_o.write(req);
+
+            //  keep the valid signal asserted if the next request is already
+            //  available, otherwise release it and wait for the sequence
+            valid = fetch_request(req, false);
+            if (!valid) {
+                core_req_valid_o.write(false);
+                valid = fetch_request(req, true);
+            }
+        }
+        core_req_valid_o.write(false);
+    }
+
+    void drive_request()
+    {
+        if (pipelined) {
+            drive_request_pipelined();
+            if (nb_bubbles > 0) {
+                std::cout << "DRV_ERROR: " << name() << ": the valid signal was released during "
+                          << nb_bubbles << " cycles while a transaction was available"
+                          << std::endl;
+            }
+        } else {
+            drive_request_blocking();
+        }
+
+        nb_running_drivers--;
 
         // FIXME : I should find a better way to know when all transactions
         // have been completed. Otherwise, finish the simulation in a different
         // place (e.g. the scoreboard that knows all pending transactions)
         do {
             wait();
-        } while (!no_inflight_requests_i.read());
+        } while ((nb_running_drivers > 0) || !no_inflight_requests_i.read());
 
         Verilated::gotFinish(true);
     }
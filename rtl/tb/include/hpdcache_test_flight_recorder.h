@@ -0,0 +1,143 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Flight recorder of the waveforms. It keeps in memory the VCD
+ *               trace of the last cycles of the simulation, and writes it in a
+ *               file only when requested (e.g. on an error)
+ */
+#ifndef __HPDCACHE_TEST_FLIGHT_RECORDER_H__
+#define __HPDCACHE_TEST_FLIGHT_RECORDER_H__
+
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <verilated_vcd_c.h>
+
+/**
+ * @class hpdcache_test_flight_recorder
+ * @brief The trace is split in segments of a given nb of cycles (in the same
+ *        way as the rollover of the Verilator VCD writer): the first segment
+ *        holds the header (definitions of the signals), and each of the other
+ *        ones starts with a full dump of the signals. Only the header and the
+ *        last two segments are kept, so the trace written by flush() covers at
+ *        least the last window of cycles
+ */
+class hpdcache_test_flight_recorder
+{
+    //  In-memory file of the VCD writer. Each (re)open starts a new segment
+    class ring_file : public VerilatedVcdFile
+    {
+    public:
+        ring_file()
+          : opened_m(false)
+        {
+        }
+
+        bool open(const std::string&) override
+        {
+            if (opened_m) {
+                segments_m.emplace_back();
+                if (segments_m.size() > 2) segments_m.pop_front();
+            }
+            opened_m = true;
+            return true;
+        }
+
+        void close() override {}
+
+        ssize_t write(const char* bufp, ssize_t len) override
+        {
+            (segments_m.empty() ? header_m : segments_m.back()).append(bufp, len);
+            return len;
+        }
+
+        void write_to(std::ostream& os) const
+        {
+            os << header_m;
+            for (const std::string& s : segments_m) os << s;
+        }
+
+    private:
+        bool opened_m;
+        std::string header_m;
+        std::deque<std::string> segments_m;
+    };
+
+public:
+    hpdcache_test_flight_recorder(const std::string& name, uint64_t window)
+      : name_m(name)
+      , window_m(window)
+      , last_rollover_m(0)
+      , flushed_m(false)
+      , file_m(new ring_file())
+      , vcd_m(new VerilatedVcdC(file_m.get()))
+    {
+    }
+
+    ~hpdcache_test_flight_recorder()
+    {
+        //  the VCD writer uses the file, it shall be destroyed first
+        vcd_m.reset();
+    }
+
+    VerilatedVcdC* get_vcd() { return vcd_m.get(); }
+
+    //  Start the recording. The signals shall be registered before (trace()
+    //  function of the model)
+    void open()
+    {
+        vcd_m->set_time_unit("1ps");
+        vcd_m->set_time_resolution("1ps");
+        vcd_m->open(name_m.c_str());
+
+        //  the first segment only holds the header
+        vcd_m->openNext(false);
+    }
+
+    //  Record the signals at the given time (in picoseconds). A new segment
+    //  starts every window of cycles
+    void dump(uint64_t time_ps, uint64_t cycle)
+    {
+        if (flushed_m) return;
+        if ((cycle > 0) && (cycle % window_m == 0) && (cycle != last_rollover_m)) {
+            last_rollover_m = cycle;
+            vcd_m->openNext(false);
+        }
+        vcd_m->dump(time_ps);
+    }
+
+    //  Write the recorded trace. Only the first call has an effect: the
+    //  recording stops after it
+    void flush(const std::string& reason)
+    {
+        if (flushed_m) return;
+        flushed_m = true;
+
+        vcd_m->flush();
+        std::ofstream f(name_m);
+        if (!f) {
+            std::cout << "error: cannot create the waveform file " << name_m << std::endl;
+            return;
+        }
+        file_m->write_to(f);
+        std::cout << "Dumping the last " << window_m << " cycles (at least) of waves into "
+                  << name_m << " (" << reason << ")" << std::endl;
+    }
+
+private:
+    std::string name_m;
+    uint64_t window_m;
+    uint64_t last_rollover_m;
+    bool flushed_m;
+    std::unique_ptr<ring_file> file_m;
+    std::unique_ptr<VerilatedVcdC> vcd_m;
+};
+
+#endif /* __HPDCACHE_TEST_FLIGHT_RECORDER_H__ */
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
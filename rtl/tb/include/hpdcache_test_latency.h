@@ -0,0 +1,126 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Latency histogram used by the scoreboard to compute the
+ *               distribution of the latency of the requests
+ */
+#ifndef __HPDCACHE_TEST_LATENCY_H__
+#define __HPDCACHE_TEST_LATENCY_H__
+
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+/**
+ * @class hpdcache_test_latency
+ * @brief Distribution of latencies (in cycles). Latencies below LINEAR_BINS
+ *        are counted exactly, so the percentiles are exact in that range. The
+ *        bigger ones are counted in log2 buckets, and the percentiles falling
+ *        in those buckets are rounded up to the bound of the bucket
+ */
+class hpdcache_test_latency
+{
+public:
+    static constexpr unsigned LINEAR_BINS = 1024;
+    static constexpr unsigned LOG2_BINS = 64;
+
+    hpdcache_test_latency()
+      : linear_m(LINEAR_BINS, 0)
+      , log2_m(LOG2_BINS, 0)
+      , count_m(0)
+      , sum_m(0)
+      , max_m(0)
+    {
+    }
+
+    void record(uint64_t latency)
+    {
+        if (latency < LINEAR_BINS) linear_m[latency]++;
+        log2_m[log2_bucket(latency)]++;
+        count_m++;
+        sum_m += latency;
+        if (latency > max_m) max_m = latency;
+    }
+
+    uint64_t count() const { return count_m; }
+
+    uint64_t max() const { return max_m; }
+
+    double mean() const { return count_m > 0 ? (double)sum_m / count_m : 0; }
+
+    //  Smallest latency such that at least p percent of the latencies are
+    //  lower or equal
+    uint64_t percentile(double p) const
+    {
+        if (count_m == 0) return 0;
+
+        uint64_t rank = (uint64_t)((p / 100.0) * count_m + 0.5);
+        if (rank < 1) rank = 1;
+        if (rank > count_m) rank = count_m;
+
+        uint64_t n = 0;
+        for (unsigned i = 0; i < LINEAR_BINS; i++) {
+            n += linear_m[i];
+            if (n >= rank) return i;
+        }
+        for (unsigned b = log2_bucket(LINEAR_BINS); b < LOG2_BINS; b++) {
+            n += log2_m[b];
+            if (n >= rank) {
+                const uint64_t bound = (1ULL << b) - 1;
+                return bound < max_m ? bound : max_m;
+            }
+        }
+        return max_m;
+    }
+
+    //  Bucket b counts the latencies in [2^(b-1), 2^b - 1] (bucket 0 counts the
+    //  zero latencies)
+    const std::vector<uint64_t>& log2_histogram() const { return log2_m; }
+
+    //  Index of the last non-empty log2 bucket
+    unsigned log2_last() const
+    {
+        unsigned last = 0;
+        for (unsigned b = 0; b < LOG2_BINS; b++) {
+            if (log2_m[b] > 0) last = b;
+        }
+        return last;
+    }
+
+    void to_json(std::ostream& os) const
+    {
+        os << "{\"count\": " << count_m << ", \"mean\": " << std::fixed << std::setprecision(3)
+           << mean() << std::defaultfloat << ", \"p50\": " << percentile(50)
+           << ", \"p90\": " << percentile(90) << ", \"p99\": " << percentile(99)
+           << ", \"max\": " << max_m << ", \"log2_histogram\": [";
+        for (unsigned b = 0; b <= log2_last(); b++) {
+            os << (b > 0 ? ", " : "") << log2_m[b];
+        }
+        os << "]}";
+    }
+
+private:
+    std::vector<uint64_t> linear_m;
+    std::vector<uint64_t> log2_m;
+    uint64_t count_m;
+    uint64_t sum_m;
+    uint64_t max_m;
+
+    static inline unsigned log2_bucket(uint64_t latency)
+    {
+        unsigned b = 0;
+        while (latency > 0) {
+            latency >>= 1;
+            b++;
+        }
+        return b < LOG2_BINS ? b : LOG2_BINS - 1;
+    }
+};
+
+#endif /* __HPDCACHE_TEST_LATENCY_H__ */
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
@@ -0,0 +1,331 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Functional part of the memory response model of the HPDCACHE
+ *               testbench: content of the memory, error segments, exclusive
+ *               reservations and atomic operations. It does not depend on
+ *               SystemC, and it is shared by the memory response models of the
+ *               SystemC (hpdcache_test_mem_resp_model.h) and of the cc
+ *               (hpdcache_test_cc_mem_model.h) testbenches
+ */
+#ifndef __HPDCACHE_TEST_MEM_FUNC_MODEL_H__
+#define __HPDCACHE_TEST_MEM_FUNC_MODEL_H__
+
+#include "hpdcache_test_defs.h"
+#include "mem_model.h"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @class hpdcache_test_mem_func_model
+ * @brief The request methods are templates on the memory request of the
+ *        harness. It shall have the addr, len, size, id and atomic fields, the
+ *        is_ldex(), is_stex() and is_amo() methods, and the
+ *        HPDCACHE_MEM_ATOMIC_* constants. The data of the flits are arrays of
+ *        bytes (little-endian), with one bit of byte enable per byte
+ */
+class hpdcache_test_mem_func_model
+{
+public:
+    struct segment_t
+    {
+        uint64_t base_addr;
+        uint64_t end_addr;
+        bool error;
+
+        segment_t(uint64_t base, uint64_t end, bool error)
+          : base_addr(base)
+          , end_addr(end)
+          , error(error){};
+    };
+
+    static constexpr unsigned MEM_NOC_DATA_WORDS = HPDCACHE_MEM_DATA_WIDTH / 64;
+    static constexpr unsigned MEM_NOC_DATA_BYTES = HPDCACHE_MEM_DATA_WIDTH / 8;
+
+    //  Outcome of a write request
+    struct write_status_t
+    {
+        //  the request is in an error segment
+        bool error;
+
+        //  the request is a store-exclusive with a valid reservation
+        bool is_atomic;
+
+        //  old data of an AMO (response on the read channel)
+        uint8_t amo_data[MEM_NOC_DATA_BYTES];
+    };
+
+    hpdcache_test_mem_func_model(const std::string& nm)
+      : memory_m(new mem_model(nm.c_str(), mem_model::MEM_MODEL_INIT_RANDOM))
+    {
+        memset(excl_buf_m, 0, sizeof(excl_buf_m));
+    }
+
+    virtual ~hpdcache_test_mem_func_model() {}
+
+    void add_error_segment(const segment_t& s) { errorsegs_m.push_back(s); }
+
+    //  Seed of the initial (random) content of the memory
+    void set_mem_seed(uint64_t seed) { memory_m->setSeed(seed); }
+
+    //  Save (restore) the content of the memory and the exclusive reservations
+    //  in (from) a checkpoint. There shall be no pending transaction
+    void save_state(std::ostream& os) const
+    {
+        memory_m->saveState(os);
+        os.write(reinterpret_cast<const char*>(excl_buf_m), sizeof(excl_buf_m));
+    }
+
+    bool restore_state(std::istream& is)
+    {
+        if (!memory_m->restoreState(is)) return false;
+        is.read(reinterpret_cast<char*>(excl_buf_m), sizeof(excl_buf_m));
+        return bool(is);
+    }
+
+    static bool within_region(uint64_t base0, uint64_t end0, uint64_t base1, uint64_t end1)
+    {
+        if (end0 <= base1) return false;
+        if (base0 >= end1) return false;
+        return true;
+    }
+
+    bool within_error_region(uint64_t base, uint64_t end) const
+    {
+        for (const segment_t& s : errorsegs_m) {
+            if (within_region(s.base_addr, s.end_addr, base, end)) {
+                return s.error;
+            }
+        }
+        return false;
+    }
+
+    //  Nb of 64-bit words of each beat of a request
+    static size_t beat_words(unsigned size)
+    {
+        const size_t words = (size_t(1) << size) / 8;
+        return (words == 0) ? 1 : words;
+    }
+
+    //  Address of a beat of a burst of burst_bytes bytes, with beat_bytes bytes
+    //  per beat. The beats of a wrapping burst (critical-word-first refills)
+    //  wrap around the boundary of the total size of the burst
+    static uint64_t beat_addr(
+        uint64_t addr, uint64_t burst_bytes, uint64_t beat_bytes, bool wrap, unsigned beat)
+    {
+        const uint64_t step = uint64_t(beat) * beat_bytes;
+        if (!wrap) return addr + step;
+
+        const uint64_t burst_base = addr - (addr % burst_bytes);
+        return burst_base + (addr - burst_base + step) % burst_bytes;
+    }
+
+    //  Execute a read request: make the reservation of a load-exclusive. It
+    //  returns false, without reservation, if the request is in an error
+    //  segment
+    template<typename R>
+    bool read_access(const R& req)
+    {
+        const uint64_t end_addr = req.addr + (1ULL << req.size);
+
+        if (within_error_region(req.addr, end_addr)) return false;
+
+        if (req.is_ldex()) {
+            excl_reservation_buf_t& e = excl_buf_m[req.id];
+            e.valid = true;
+            e.base_addr = req.addr;
+            e.end_addr = end_addr;
+        }
+        return true;
+    }
+
+    //  Data of a beat of a read request (MEM_NOC_DATA_BYTES bytes). The bytes
+    //  out of the beat are zero
+    template<typename R>
+    void read_beat(const R& req, unsigned beat, uint8_t* data)
+    {
+        const size_t words = beat_words(req.size);
+        const uint64_t addr =
+            beat_addr(req.addr, uint64_t(req.len + 1) << req.size, words * 8, req.wrap, beat);
+        const bool debug = debug_enabled();
+
+        uint64_t ld_data[MEM_NOC_DATA_WORDS];
+        memory_m->readMemory(addr >> 3, ld_data, words);
+        memset(data, 0, MEM_NOC_DATA_BYTES);
+        for (size_t w = 0; w < words; w++) {
+            const uint64_t word_addr = (addr >> 3) + w;
+            memcpy(data + (word_addr % MEM_NOC_DATA_WORDS) * 8, &ld_data[w], 8);
+
+            if (debug) {
+                std::stringstream ss;
+                ss << "reading memory"
+                   << " / address = 0x" << std::hex << word_addr * 8 << std::dec
+                   << " / load data = 0x" << std::hex << ld_data[w] << std::dec;
+                print_debug(ss.str());
+            }
+        }
+    }
+
+    //  Execute a write request. The data (byte enable) of the len + 1 flits of
+    //  the burst are in data (be), with MEM_NOC_DATA_BYTES (MEM_NOC_DATA_BYTES /
+    //  8) bytes per flit
+    template<typename R>
+    write_status_t write_access(const R& req, const uint8_t* data, const uint8_t* be)
+    {
+        const unsigned bytes = (1U << req.size);
+        const uint64_t addr = req.addr;
+        const uint64_t end_addr = addr + uint64_t(req.len + 1) * bytes;
+        const uint64_t word_addr = addr >> 3;
+        const unsigned word = word_addr % MEM_NOC_DATA_WORDS;
+        const bool is_amo = req.is_amo();
+        const bool debug = debug_enabled();
+        write_status_t st;
+
+        st.error = within_error_region(addr, end_addr);
+        st.is_atomic = false;
+        memset(st.amo_data, 0, sizeof(st.amo_data));
+
+        //  a request in an error segment does not modify the memory
+        if (st.error) return st;
+
+        //  a store-exclusive writes the memory only if it has a valid
+        //  reservation
+        if (req.is_stex()) {
+            excl_reservation_buf_t& e = excl_buf_m[req.id];
+            if (e.valid) {
+                e.valid = false;
+                st.is_atomic = within_region(addr, end_addr, e.base_addr, e.end_addr);
+            }
+            if (!st.is_atomic) return st;
+        }
+
+        //  compute the AMO result
+        uint64_t amo_result = 0;
+        if (is_amo) {
+            const unsigned offset = (addr % 8) * 8;
+            uint64_t ld_data = memory_m->readMemory(word_addr);
+            uint64_t st_data;
+
+            memcpy(&st_data, data + word * 8, 8);
+            if (bytes == 4) {
+                ld_data = static_cast<uint32_t>(ld_data >> offset);
+                st_data = static_cast<uint32_t>(st_data >> offset);
+            }
+            amo_result = compute_amo<R>(req.atomic, ld_data, st_data, bytes);
+            ld_data <<= offset;
+            st_data <<= offset;
+            amo_result <<= offset;
+
+            //  the old data is sent on the read response channel
+            memcpy(st.amo_data + word * 8, &ld_data, 8);
+
+            if (debug) {
+                std::stringstream ss;
+                ss << "computing amo word"
+                   << " / load data = 0x" << std::hex << ld_data << std::dec
+                   << " / store data = 0x" << std::hex << st_data << std::dec
+                   << " / amo result = 0x" << std::hex << amo_result << std::dec;
+                print_debug(ss.str());
+            }
+        }
+
+        const size_t words = beat_words(req.size);
+
+        //  do the write operation on the memory array, with the byte enable of
+        //  each flit of the burst
+        uint64_t flit_addr = word_addr;
+        for (unsigned f = 0; f <= req.len; f++) {
+            const uint8_t* flit_data = data + f * MEM_NOC_DATA_BYTES;
+            const uint8_t* flit_be = be + f * (MEM_NOC_DATA_BYTES / 8);
+            const unsigned flit_word = flit_addr % MEM_NOC_DATA_WORDS;
+            for (size_t w = 0; w < words; w++) {
+                const unsigned i = flit_word + w;
+
+                //  skip the write operation if the byte enable is all 0
+                if (flit_be[i] == 0) continue;
+
+                uint64_t st_data = amo_result;
+                if (!is_amo) memcpy(&st_data, flit_data + i * 8, 8);
+                memory_m->writeMemory(flit_addr + w, st_data, mem_model::beToMask(flit_be[i]));
+
+                if (debug) {
+                    std::stringstream ss;
+                    ss << "writing memory"
+                       << " / address = 0x" << std::hex << ((flit_addr + w) * 8) << std::dec
+                       << " / store data = 0x" << std::hex << st_data << std::dec
+                       << " / store be = 0x" << std::hex << (unsigned)flit_be[i] << std::dec;
+                    print_debug(ss.str());
+                }
+            }
+            flit_addr += words;
+        }
+        return st;
+    }
+
+    template<typename R>
+    static uint64_t compute_amo(unsigned atop, uint64_t ld_data, uint64_t st_data, unsigned bytes)
+    {
+        bool umax = (ld_data > st_data);
+        bool smax;
+        if (bytes == 4) {
+            smax = ((int64_t)((int32_t)ld_data) > (int64_t)((int32_t)st_data));
+        } else {
+            smax = (((int64_t)ld_data) > ((int64_t)st_data));
+        }
+
+        switch (atop) {
+            case R::HPDCACHE_MEM_ATOMIC_ADD:
+                return ld_data + st_data;
+            case R::HPDCACHE_MEM_ATOMIC_CLR:
+                return ld_data & ~st_data;
+            case R::HPDCACHE_MEM_ATOMIC_SET:
+                return ld_data | st_data;
+            case R::HPDCACHE_MEM_ATOMIC_EOR:
+                return ld_data ^ st_data;
+            case R::HPDCACHE_MEM_ATOMIC_SMAX:
+                return smax ? ld_data : st_data;
+            case R::HPDCACHE_MEM_ATOMIC_UMAX:
+                return umax ? ld_data : st_data;
+            case R::HPDCACHE_MEM_ATOMIC_SMIN:
+                return smax ? st_data : ld_data;
+            case R::HPDCACHE_MEM_ATOMIC_UMIN:
+                return umax ? st_data : ld_data;
+            case R::HPDCACHE_MEM_ATOMIC_SWAP:
+                return st_data;
+        }
+
+        assert(false && "unknown atomic operation");
+        return 0;
+    }
+
+protected:
+    struct excl_reservation_buf_t
+    {
+        bool valid;
+        uint64_t base_addr;
+        uint64_t end_addr;
+    };
+
+    std::vector<segment_t> errorsegs_m;
+    std::unique_ptr<mem_model> memory_m;
+    excl_reservation_buf_t excl_buf_m[1 << HPDCACHE_MEM_ID_WIDTH];
+
+    //  Debug messages on the accesses to the memory array. The harness enables
+    //  them, and adds its timestamp
+    virtual bool debug_enabled() const { return false; }
+
+    virtual void print_debug(const std::string& msg) { std::cout << msg << std::endl; }
+};
+
+#endif /* __HPDCACHE_TEST_MEM_FUNC_MODEL_H__ */
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
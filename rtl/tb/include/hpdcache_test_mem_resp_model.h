@@ -30,10 +30,12 @@
 #include "hpdcache_test_mem_resp_model_base.h"
 #include "logger.h"
 #include "mem_model.h"
+#include <cstring>
 #include <iostream>
 #include <map>
 #include <scv.h>
 #include <systemc>
+#include <vector>
 
 #define DEBUG_HPDCACHE_TEST_MEM_RESP_MODEL 1
 
@@ -54,6 +56,7 @@ public:
     sc_in<sc_bv<2>> mem_req_read_command_i;
     sc_in<sc_bv<4>> mem_req_read_atomic_i;
     sc_in<bool> mem_req_read_cacheable_i;
+    sc_in<bool> mem_req_read_wrap_i;
 
     sc_in<bool> mem_resp_read_ready_i;
     sc_out<bool> mem_resp_read_valid_o;
@@ -116,218 +119,215 @@ public:
 
         SC_THREAD(write_response_process);
         sensitive << clk_i.pos();
+
+        SC_METHOD(cycle_process);
+        sensitive << clk_i.pos();
     }
 
 private:
     void readOperation()
     {
         hpdcache_test_transaction_mem_read_req req;
-        hpdcache_test_transaction_mem_read_resp resp;
+        mem_read_resp_flit_t flit;
+        hpdcache_test_transaction_mem_read_resp& resp = flit.resp;
 
         //  consume the request from the request ports
-        req.addr = mem_req_read_addr_i.read().to_uint();
+        req.addr = mem_req_read_addr_i.read().to_uint64();
         req.len = mem_req_read_len_i.read().to_uint();
         req.size = mem_req_read_size_i.read().to_uint();
         req.id = mem_req_read_id_i.read().to_uint();
         req.command = mem_req_read_command_i.read().to_uint();
         req.atomic = mem_req_read_atomic_i.read().to_uint();
         req.cacheable = mem_req_read_cacheable_i.read();
+        req.wrap = mem_req_read_wrap_i.read();
         sb_mem_read_req_o.write(req); // send request to scoreboard
 
-        ra_ready_delay->next();
-        for (int i = 0; i < ra_ready_delay->read(); i++) wait();
+        if (!timing_m) {
+            ra_ready_delay->next();
+            for (int i = 0; i < ra_ready_delay->read(); i++) wait();
+        }
 
         mem_req_read_ready_o.write(true);
+        inflight_reads_m++;
+        max_inflight_reads = std::max<uint64_t>(max_inflight_reads, inflight_reads_m);
         wait();
         mem_req_read_ready_o.write(false);
 
+        flit.seq = nb_seq_m++;
+        flit.bytes = std::min(1U << req.size, unsigned(HPDCACHE_MEM_DATA_WIDTH / 8));
+        flit.amo = false;
+
         //  check if the address is in an error segment. If it is, send a
         //  response with the error flag asserted
-        uint64_t addr = req.addr;
-        uint64_t end_addr = addr + (1ULL << req.size);
-        if (within_error_region(addr, end_addr)) {
+        uint64_t ready = nb_cycles_m;
+        if (!read_access(req)) {
             for (int i = 0; i < (req.len + 1); i++) {
                 resp.error = 1;
                 resp.id = req.id;
                 resp.last = (i == req.len);
-                while (!read_resp_fifo.nb_write(resp)) wait();
+                if (!timing_m) ready = next_random_ready(ready, rd_valid_delay);
+                flit.ready = ready;
+                push_read_resp(flit, req.addr);
             }
             return;
         }
 
-        //  do the read operation on the memory array
-        size_t words = (1 << req.size) / 8;
-        if (words == 0) words = 1;
-
-        if (req.is_ldex()) {
-            const uint64_t n = 1 << req.size;
-            excl_buf_m[req.id].valid = true;
-            excl_buf_m[req.id].base_addr = addr;
-            excl_buf_m[req.id].end_addr = addr + n;
+        //  with a timing model, the beats are sent one after the other once the
+        //  first one is available
+        uint64_t beat_cycles = 0;
+        if (timing_m) {
+            const uint64_t bytes = uint64_t(req.len + 1) << req.size;
+            ready = timing_m->access(nb_cycles_m, req.addr, bytes, false);
+            beat_cycles = timing_m->transfer_cycles(1ULL << req.size);
         }
 
+        //  do the read operation on the memory array
+        uint8_t data[MEM_NOC_DATA_BYTES];
         for (int i = 0; i < (req.len + 1); i++) {
-            for (int w = 0; w < words; w++) {
-                uint64_t word_addr = (addr >> 3) + w;
-                uint64_t ld_data = memory_m->readMemory(word_addr);
-                uint64_t r = word_addr % MEM_NOC_DATA_WORDS;
-                resp.data.range((r + 1) * 64 - 1, r * 64) = ld_data;
-
-#if DEBUG_HPDCACHE_TEST_MEM_RESP_MODEL
-                if (check_verbosity(sc_core::SC_DEBUG)) {
-                    std::cout << sc_time_stamp().to_string()
-                              << " / MEM_RESP_MODEL_DEBUG: reading memory"
-                              << " / address = 0x" << std::hex << word_addr * 8 << std::dec
-                              << " / load data = 0x" << std::hex << ld_data << std::dec
-                              << std::endl;
-                }
-#endif
-            }
+            read_beat(req, i, data);
+            hpdcache_test_bytes_to_bv(data, resp.data);
 
             //  send response
             resp.error = 0;
             resp.id = req.id;
             resp.last = (i == req.len);
-            while (!read_resp_fifo.nb_write(resp)) wait();
-
-            addr = ((addr >> 3) + words) << 3;
+            if (timing_m) {
+                flit.ready = ready + i * beat_cycles;
+            } else {
+                ready = next_random_ready(ready, rd_valid_delay);
+                flit.ready = ready;
+            }
+            push_read_resp(flit, req.addr);
         }
     }
 
-    void writeOperation(hpdcache_test_transaction_mem_write_req req)
+    void writeOperation(const hpdcache_test_transaction_mem_write_req& req)
     {
-        hpdcache_test_transaction_mem_write_resp resp;
-
-        unsigned int command = req.command;
-        unsigned bytes = (1ULL << req.size);
-        uint64_t addr = req.addr;
-        uint64_t end_addr = addr + bytes;
-        uint64_t word_addr = addr >> 3;
-        bool excl_ok = false;
-
-        unsigned int atop = req.atomic;
-        bool is_amo = ((command == hpdcache_mem_command_e::HPDCACHE_MEM_ATOMIC)
-                       && (atop != hpdcache_mem_atomic_e::HPDCACHE_MEM_ATOMIC_STEX));
+        mem_write_resp_flit_t flit;
+        mem_read_resp_flit_t read_flit;
+        hpdcache_test_transaction_mem_write_resp& resp = flit.resp;
+        hpdcache_test_transaction_mem_read_resp& read_resp = read_flit.resp;
+
+        const unsigned bytes = (1U << req.size);
+        const uint64_t addr = req.addr;
+        const bool is_amo = req.is_amo();
+
+        flit.seq = nb_seq_m++;
+        read_flit.seq = flit.seq;
+        read_flit.bytes = std::min(bytes, MEM_NOC_DATA_BYTES);
+        read_flit.amo = true;
+
+        //  do the write operation on the memory array
+        std::vector<uint8_t> data((req.len + 1) * MEM_NOC_DATA_BYTES);
+        std::vector<uint8_t> be((req.len + 1) * MEM_NOC_DATA_BYTES / 8);
+        for (unsigned f = 0; f <= req.len; f++) {
+            hpdcache_test_bv_to_bytes(req.data[f], data.data() + f * MEM_NOC_DATA_BYTES);
+            hpdcache_test_bv_to_bytes(req.be[f], be.data() + f * MEM_NOC_DATA_BYTES / 8);
+        }
+        const write_status_t st = write_access(req, data.data(), be.data());
 
-        //  check if the address is in an error segment. If it is, send a
-        //  response with the error flag asserted
-        if (within_error_region(addr, end_addr)) {
+        //  the request is in an error segment: send a response with the error
+        //  flag asserted
+        if (st.error) {
             if (is_amo) {
-                hpdcache_test_transaction_mem_read_resp read_resp;
                 read_resp.data = 0;
                 read_resp.error = 0;
                 read_resp.id = req.id;
                 read_resp.last = true;
-                while (!read_resp_fifo.nb_write(read_resp)) wait();
+                read_flit.ready = timing_m ? nb_cycles_m
+                                           : next_random_ready(nb_cycles_m, rd_valid_delay);
+                push_read_resp(read_flit, addr);
             }
 
             resp.is_atomic = 0;
             resp.error = 1;
             resp.id = req.id;
-            while (!write_resp_fifo.nb_write(resp)) wait();
+            flit.ready = timing_m ? nb_cycles_m : next_random_ready(nb_cycles_m, wb_valid_delay);
+            push_write_resp(flit, addr);
             return;
         }
 
-        if (req.is_stex()) {
-            excl_reservation_buf_t& e = excl_buf_m[req.id];
-            if (e.valid) {
-                e.valid = false;
-                excl_ok = within_region(addr, end_addr, e.base_addr, e.end_addr);
-            }
+        //  with a timing model, the write is acknowledged once its data is
+        //  transferred to the memory
+        uint64_t ready = nb_cycles_m;
+        uint64_t read_ready = nb_cycles_m;
+        if (timing_m) {
+            const uint64_t wbytes = uint64_t(req.len + 1) << req.size;
+            ready = timing_m->access(nb_cycles_m, addr, wbytes, true);
+            ready += timing_m->transfer_cycles(wbytes);
+            read_ready = ready;
+        } else {
+            ready = next_random_ready(ready, wb_valid_delay);
+            if (is_amo) read_ready = next_random_ready(read_ready, rd_valid_delay);
         }
 
-        //  compute the AMO result
-        uint64_t word = word_addr % MEM_NOC_DATA_WORDS;
-        uint64_t ld_data;
-        uint64_t st_data;
-        uint64_t amo_result;
-
+        //  send the old data for AMO on the read response channel
         if (is_amo) {
-            unsigned offset = (addr % 8) * 8;
-
-            ld_data = memory_m->readMemory(word_addr);
-            st_data = req.data.range((word + 1) * 64 - 1, word * 64).to_uint64();
-            if (bytes == 4) {
-                ld_data = static_cast<uint32_t>(ld_data >> offset);
-                st_data = static_cast<uint32_t>(st_data >> offset);
-            }
-            amo_result =
-                compute_amo(static_cast<hpdcache_mem_atomic_e>(atop), ld_data, st_data, bytes);
-            if (offset) {
-                ld_data <<= offset;
-                st_data <<= offset;
-                amo_result <<= offset;
-            }
-
-#if DEBUG_HPDCACHE_TEST_MEM_RESP_MODEL
-            if (check_verbosity(sc_core::SC_DEBUG)) {
-                std::cout << sc_time_stamp().to_string()
-                          << " / MEM_RESP_MODEL_DEBUG: computing amo word"
-                          << " / load data = 0x" << std::hex << ld_data << std::dec
-                          << " / store data = 0x" << std::hex << st_data << std::dec
-                          << " / amo result = 0x" << std::hex << amo_result << std::dec
-                          << std::endl;
-            }
-#endif
+            hpdcache_test_bytes_to_bv(st.amo_data, read_resp.data);
+            read_resp.error = 0;
+            read_resp.id = req.id;
+            read_resp.last = true;
+            read_flit.ready = read_ready;
+            push_read_resp(read_flit, addr);
         }
 
-        //  compute the number of words to write
-        if (!req.is_stex() || excl_ok) {
-            size_t words = bytes / 8;
-            if (words == 0) words = 1;
-
-            //  do the write operation on the memory array
-            for (int w = 0; w < words; w++) {
-                unsigned int i = word + w;
-                uint8_t be = req.be.range((i + 1) * 8 - 1, i * 8).to_uint();
-
-                //  skip the write operation if the byte enable is all 0
-                if (be == 0) continue;
-
-                st_data =
-                    is_amo ? amo_result : req.data.range((i + 1) * 64 - 1, i * 64).to_uint64();
-                memory_m->writeMemory(word_addr + w, st_data, mem_model::beToMask(be));
+        //  send the write acknowledge on the write response channel
+        resp.is_atomic = st.is_atomic;
+        resp.error = 0;
+        resp.id = req.id;
+        flit.ready = ready;
+        push_write_resp(flit, addr);
+    }
 
 #if DEBUG_HPDCACHE_TEST_MEM_RESP_MODEL
-                if (check_verbosity(sc_core::SC_DEBUG)) {
-                    std::cout << sc_time_stamp().to_string()
-                              << " / MEM_RESP_MODEL_DEBUG: writing memory"
-                              << " / address = 0x" << std::hex << ((word_addr + w) * 8) << std::dec
-                              << " / store data = 0x" << std::hex << st_data << std::dec
-                              << " / store be = 0x" << std::hex << (uint32_t)be << std::dec
-                              << std::endl;
-                }
-#endif
-            }
+    bool debug_enabled() const override { return check_verbosity(sc_core::SC_DEBUG); }
 
-            //  send the old data for AMO on the read response channel
-            if (is_amo) {
-                hpdcache_test_transaction_mem_read_resp read_resp;
-                read_resp.data = 0;
-                read_resp.data.range((word + 1) * 64 - 1, word * 64) = ld_data;
-                read_resp.error = 0;
-                read_resp.id = req.id;
-                read_resp.last = true;
-                while (!read_resp_fifo.nb_write(read_resp)) wait();
-            }
-        }
+    void print_debug(const std::string& msg) override
+    {
+        std::cout << sc_time_stamp().to_string() << " / MEM_RESP_MODEL_DEBUG: " << msg
+                  << std::endl;
+    }
+#endif
 
-        //  send the write acknowledge on the write response channel
-        resp.is_atomic = req.is_stex() && excl_ok;
-        resp.error = 0;
-        resp.id = req.id;
-        while (!write_resp_fifo.nb_write(resp)) wait();
+    //  Cycle of a response after a random delay from the given cycle
+    uint64_t next_random_ready(uint64_t from, scv_smart_ptr<int>& delay)
+    {
+        delay->next();
+        return from + delay->read();
     }
 
+    void cycle_process() { tick(); }
+
     void read_response_process()
     {
-        hpdcache_test_transaction_mem_read_resp read_resp;
+        mem_read_resp_flit_t flit;
+        const hpdcache_test_transaction_mem_read_resp& read_resp = flit.resp;
+        int burst_id = -1;
 
         mem_resp_read_valid_o.write(false);
         for (;;) {
-            while (!read_resp_fifo.nb_read(read_resp)) wait();
-            rd_valid_delay->next();
-            for (int i = 0; i < rd_valid_delay->read(); i++) wait();
+            //  the beats of a burst are not interleaved with other responses
+            uint32_t id = burst_id;
+            if (burst_id >= 0) {
+                if (read_resp_q[id].front().ready > nb_cycles_m) {
+                    wait();
+                    continue;
+                }
+            } else if (!select_resp(read_resp_q, read_resp_ids, id)) {
+                wait();
+                continue;
+            }
+            if (!consume_tokens(read_resp_q[id].front().bytes)) {
+                nb_bw_limit_cycles++;
+                wait();
+                continue;
+            }
+
+            flit = pop_resp(read_resp_q, read_resp_ids, id, read_seq_end, nb_read_reordered);
+            burst_id = read_resp.last ? -1 : int(id);
+            nb_read_bytes += flit.bytes;
+            if (read_resp.last && !flit.amo) inflight_reads_m--;
+
             sb_mem_read_resp_o.write(read_resp); // send response to scoreboard
             mem_resp_read_valid_o.write(true);
             mem_resp_read_error_o.write(read_resp.error);
@@ -342,13 +342,19 @@ private:
 
     void write_response_process()
     {
-        hpdcache_test_transaction_mem_write_resp resp;
+        mem_write_resp_flit_t flit;
+        const hpdcache_test_transaction_mem_write_resp& resp = flit.resp;
 
         mem_resp_write_valid_o.write(false);
         for (;;) {
-            while (!write_resp_fifo.nb_read(resp)) wait();
-            wb_valid_delay->next();
-            for (int i = 0; i < wb_valid_delay->read(); i++) wait();
+            uint32_t id;
+            if (!select_resp(write_resp_q, write_resp_ids, id)) {
+                wait();
+                continue;
+            }
+            flit = pop_resp(write_resp_q, write_resp_ids, id, write_seq_end, nb_write_reordered);
+            inflight_writes_m--;
+
             sb_mem_write_resp_o.write(resp); // send response to scoreboard
             mem_resp_write_valid_o.write(true);
             mem_resp_write_is_atomic_o.write(resp.is_atomic);
@@ -364,9 +370,10 @@ private:
     {
         mem_req_read_ready_o.write(false);
         for (;;) {
-            if (mem_req_read_valid_i.read()) {
+            if (mem_req_read_valid_i.read() && can_accept_read()) {
                 readOperation();
             } else {
+                if (mem_req_read_valid_i.read()) nb_read_limit_cycles++;
                 wait();
             }
         }
@@ -381,18 +388,29 @@ private:
         for (;;) {
             mem_req_write_ready_o.write(false);
 
-            //  Wait for a write request
-            while (!mem_req_write_valid_i.read()) wait();
+            //  Wait for a write request, and for the end of an outstanding write
+            //  when their number is at the limit
+            for (;;) {
+                if (mem_req_write_valid_i.read()) {
+                    if (can_accept_write()) break;
+                    nb_write_limit_cycles++;
+                }
+                wait();
+            }
 
             //  Wait for a random delay before setting the ready signal
-            wa_ready_delay->next();
-            for (int i = 0; i < wa_ready_delay->read(); ++i) wait();
+            if (!timing_m) {
+                wa_ready_delay->next();
+                for (int i = 0; i < wa_ready_delay->read(); ++i) wait();
+            }
 
             //  Set the ready signal
             mem_req_write_ready_o.write(true);
+            inflight_writes_m++;
+            max_inflight_writes = std::max<uint64_t>(max_inflight_writes, inflight_writes_m);
 
             //  Forward the request to the write process
-            r.addr = mem_req_write_addr_i.read().to_uint();
+            r.addr = mem_req_write_addr_i.read().to_uint64();
             r.len = mem_req_write_len_i.read().to_uint();
             r.size = mem_req_write_size_i.read().to_uint();
             r.id = mem_req_write_id_i.read().to_uint();
@@ -418,8 +436,19 @@ private:
             while (!mem_req_write_data_valid_i.read()) wait();
 
             //  Wait for a random delay before setting the ready signal
-            wd_ready_delay->next();
-            for (int i = 0; i < wd_ready_delay->read(); ++i) wait();
+            if (!timing_m) {
+                wd_ready_delay->next();
+                for (int i = 0; i < wd_ready_delay->read(); ++i) wait();
+            }
+
+            //  The data takes its bytes from the bandwidth of the memory
+            const sc_bv<HPDCACHE_MEM_DATA_WIDTH / 8> be = mem_req_write_be_i.read();
+            unsigned bytes = 0;
+            for (int i = 0; i < be.length(); i++) bytes += be.get_bit(i);
+            while (!consume_tokens(bytes)) {
+                nb_bw_limit_cycles++;
+                wait();
+            }
 
             //  Set the ready signal
             mem_req_write_data_ready_o.write(true);
@@ -441,14 +470,21 @@ private:
 
         for (;;) {
             while (!write_req_fifo.nb_read(req_meta)) wait();
-            while (!write_req_data_fifo.nb_read(req_data)) wait();
-            wait();
 
-            if (req_meta.len != 0) {
-                std::cout << sc_time_stamp().to_string()
-                          << " / Error: this model currently supports single"
-                          << " flit transactions" << std::endl;
+            //  collect the len + 1 data flits of the burst. Only the last one
+            //  shall have the last flag (checked by the scoreboard)
+            req.data.resize(req_meta.len + 1);
+            req.be.resize(req_meta.len + 1);
+            req.bad_last_flit = -1;
+            for (uint32_t i = 0; i <= req_meta.len; i++) {
+                while (!write_req_data_fifo.nb_read(req_data)) wait();
+                req.data[i] = req_data.data;
+                req.be[i] = req_data.be;
+                if ((req_data.last != (i == req_meta.len)) && (req.bad_last_flit < 0)) {
+                    req.bad_last_flit = i;
+                }
             }
+            wait();
 
             req.addr = req_meta.addr;
             req.len = req_meta.len;
@@ -457,8 +493,6 @@ private:
             req.command = req_meta.command;
             req.atomic = req_meta.atomic;
             req.cacheable = req_meta.cacheable;
-            req.data = req_data.data;
-            req.be = req_data.be;
             req.last = req_data.last;
 
             //  send request to scoreboard
@@ -27,33 +27,45 @@
 #define __HPDCACHE_TEST_MEM_RESP_MODEL_BASE_H__
 
 #include "hpdcache_test_defs.h"
+#include "hpdcache_test_mem_func_model.h"
+#include "hpdcache_test_mem_timing.h"
 #include "logger.h"
 #include "mem_model.h"
+#include <deque>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
 #include <scv.h>
 #include <systemc>
 
-class hpdcache_test_mem_resp_model_base
+class hpdcache_test_mem_resp_model_base : public hpdcache_test_mem_func_model
 {
 public:
-    struct segment_t
+    //  Order of the responses of different IDs
+    //
+    //  - inorder: in the order of the requests
+    //  - ready: the oldest ready response first (the latencies reorder them)
+    //  - random: a random ready response
+    //  - hash: as ready, with an additional latency given by a hash of the
+    //    address (e.g. memory slices at different distances in the NoC)
+    enum order_e
     {
-        uint64_t base_addr;
-        uint64_t end_addr;
-        bool error;
-
-        segment_t(uint64_t base, uint64_t end, bool error)
-          : base_addr(base)
-          , end_addr(end)
-          , error(error){};
+        ORDER_INORDER,
+        ORDER_READY,
+        ORDER_RANDOM,
+        ORDER_HASH
     };
 
-    struct excl_reservation_buf_t
+    //  Limits of the memory. A value of zero means no limit
+    struct limits_t
     {
-        bool valid;
-        uint64_t base_addr;
-        uint64_t end_addr;
+        unsigned max_reads;
+        unsigned max_writes;
+        unsigned bytes_per_cycle;
+        unsigned burst_bytes;
     };
 
     using hpdcache_mem_atomic_e = hpdcache_test_transaction_mem_req::hpdcache_mem_atomic_e;
@@ -112,14 +124,75 @@ protected:
         }
     };
 
-    sc_fifo<hpdcache_test_transaction_mem_read_resp> read_resp_fifo;
+    //  Response, the cycle from which it may be sent, and the arrival order of
+    //  its request
+    class mem_read_resp_flit_t
+    {
+    public:
+        hpdcache_test_transaction_mem_read_resp resp;
+        uint64_t ready;
+        uint64_t seq;
+        unsigned bytes;
+        bool amo;
+
+        friend std::ostream& operator<<(std::ostream& os, const mem_read_resp_flit_t& r)
+        {
+            os << r.resp.to_string() << " / READY = " << r.ready;
+            return os;
+        }
+    };
+
+    class mem_write_resp_flit_t
+    {
+    public:
+        hpdcache_test_transaction_mem_write_resp resp;
+        uint64_t ready;
+        uint64_t seq;
+
+        friend std::ostream& operator<<(std::ostream& os, const mem_write_resp_flit_t& r)
+        {
+            os << r.resp.to_string() << " / READY = " << r.ready;
+            return os;
+        }
+    };
+
+    //  The responses are queued per ID: the responses of an ID are sent in
+    //  order, and the order between IDs is given by order_m
+    std::vector<std::deque<mem_read_resp_flit_t>> read_resp_q;
+    std::vector<std::deque<mem_write_resp_flit_t>> write_resp_q;
+    std::set<uint32_t> read_resp_ids;
+    std::set<uint32_t> write_resp_ids;
     sc_fifo<mem_write_req_flit_t> write_req_fifo;
     sc_fifo<mem_write_req_data_flit_t> write_req_data_fifo;
-    sc_fifo<hpdcache_test_transaction_mem_write_resp> write_resp_fifo;
 
-    std::vector<segment_t> errorsegs;
-    mem_model* memory_m;
-    excl_reservation_buf_t excl_buf_m[1 << HPDCACHE_MEM_ID_WIDTH];
+    //  Timing model of the memory. When null, the latencies are drawn from the
+    //  random delay distributions
+    std::unique_ptr<hpdcache_test_mem_timing> timing_m;
+    uint64_t nb_cycles_m;
+    uint64_t nb_seq_m;
+
+    order_e order_m;
+    unsigned hash_cycles_m;
+    std::mt19937_64 order_rng_m;
+
+    //  Outstanding transactions and bandwidth (token bucket) limits
+    limits_t limits_m;
+    uint64_t tokens_m;
+    unsigned inflight_reads_m;
+    unsigned inflight_writes_m;
+
+    uint64_t max_inflight_reads;
+    uint64_t max_inflight_writes;
+    uint64_t sum_inflight_reads;
+    uint64_t sum_inflight_writes;
+    uint64_t nb_read_bytes;
+    uint64_t nb_read_limit_cycles;
+    uint64_t nb_write_limit_cycles;
+    uint64_t nb_bw_limit_cycles;
+    uint64_t read_seq_end;
+    uint64_t write_seq_end;
+    uint64_t nb_read_reordered;
+    uint64_t nb_write_reordered;
 
     scv_smart_ptr<int> ra_ready_delay;
     scv_smart_ptr<int> rd_valid_delay;
@@ -127,22 +200,37 @@ protected:
     scv_smart_ptr<int> wd_ready_delay;
     scv_smart_ptr<int> wb_valid_delay;
 
-    static constexpr unsigned int MEM_NOC_DATA_WORDS = HPDCACHE_MEM_DATA_WIDTH / 64;
-
-    bool check_verbosity(sc_core::sc_verbosity verbosity)
+    bool check_verbosity(sc_core::sc_verbosity verbosity) const
     {
         return (sc_core::sc_report_handler::get_verbosity_level() >= verbosity);
     }
 
 public:
     hpdcache_test_mem_resp_model_base(const std::string& nm)
-      : read_resp_fifo(2)
-      , write_resp_fifo(2)
+      : hpdcache_test_mem_func_model("_" + nm)
+      , read_resp_q(1 << HPDCACHE_MEM_ID_WIDTH)
+      , write_resp_q(1 << HPDCACHE_MEM_ID_WIDTH)
+      , nb_cycles_m(0)
+      , nb_seq_m(0)
+      , order_m(ORDER_INORDER)
+      , hash_cycles_m(16)
+      , limits_m{ 0, 0, 0, 0 }
+      , tokens_m(0)
+      , inflight_reads_m(0)
+      , inflight_writes_m(0)
+      , max_inflight_reads(0)
+      , max_inflight_writes(0)
+      , sum_inflight_reads(0)
+      , sum_inflight_writes(0)
+      , nb_read_bytes(0)
+      , nb_read_limit_cycles(0)
+      , nb_write_limit_cycles(0)
+      , nb_bw_limit_cycles(0)
+      , read_seq_end(0)
+      , write_seq_end(0)
+      , nb_read_reordered(0)
+      , nb_write_reordered(0)
     {
-        std::string mem_model_name;
-        mem_model_name = mem_model_name + "_" + nm;
-        memory_m = new mem_model(mem_model_name.c_str(), mem_model::MEM_MODEL_INIT_RANDOM);
-
         // set default values for delay distributions
         scv_bag<pair<int, int>> ra_delay_distribution;
         ra_delay_distribution.push(pair<int, int>(0, 2), 90);
@@ -175,9 +263,210 @@ public:
         wb_valid_delay->set_mode(wb_delay_distribution);
     }
 
-    ~hpdcache_test_mem_resp_model_base() { delete memory_m; }
+    ~hpdcache_test_mem_resp_model_base()
+    {
+        if (check_verbosity(sc_core::SC_LOW)) {
+            std::stringstream ss;
+            ss << "MEMORY MODEL STATISTICS" << std::endl
+               << "--------------------------------------------------" << std::endl
+               << "MEM.MAX_READS           : " << limits_m.max_reads << std::endl
+               << "MEM.MAX_WRITES          : " << limits_m.max_writes << std::endl
+               << "MEM.BYTES_PER_CYCLE     : " << limits_m.bytes_per_cycle << std::endl
+               << "MEM.MAX_INFLIGHT_READS  : " << max_inflight_reads << std::endl
+               << "MEM.MAX_INFLIGHT_WRITES : " << max_inflight_writes << std::endl
+               << "MEM.NB_READ_BYTES       : " << nb_read_bytes << std::endl
+               << "MEM.READ_LIMIT_CYCLES   : " << nb_read_limit_cycles << std::endl
+               << "MEM.WRITE_LIMIT_CYCLES  : " << nb_write_limit_cycles << std::endl
+               << "MEM.BW_LIMIT_CYCLES     : " << nb_bw_limit_cycles << std::endl
+               << "MEM.READ_REORDERED      : " << nb_read_reordered << std::endl
+               << "MEM.WRITE_REORDERED     : " << nb_write_reordered << std::endl
+               << std::endl
+
+               << "Computed values" << std::endl
+               << "---------------" << std::endl
+               << "Mean inflight reads     : "
+               << (nb_cycles_m > 0 ? (double)sum_inflight_reads / nb_cycles_m : 0) << std::endl
+               << "Mean inflight writes    : "
+               << (nb_cycles_m > 0 ? (double)sum_inflight_writes / nb_cycles_m : 0) << std::endl
+               << "Read bytes per cycle    : "
+               << (nb_cycles_m > 0 ? (double)nb_read_bytes / nb_cycles_m : 0) << std::endl;
+
+            if (timing_m) {
+                ss << std::endl;
+                timing_m->print_stats(ss);
+            }
+            std::cout << ss.str() << std::endl;
+        }
+    }
+
+    //  Latencies given by a DRAM timing model instead of the random delay
+    //  distributions. The handshakes on the request channels are then
+    //  immediate, and the responses are sent when the data is available
+    void set_timing(const hpdcache_test_mem_timing::config_t& cfg)
+    {
+        timing_m.reset(new hpdcache_test_mem_timing(cfg));
+    }
+
+    //  Order of the responses of different IDs. With the hash order, the
+    //  additional latency is between 0 and hash_cycles - 1. The seed
+    //  initializes the generator of the random order
+    void set_order(order_e order, unsigned hash_cycles = 16, uint64_t seed = 0)
+    {
+        order_m = order;
+        hash_cycles_m = std::max(hash_cycles, 1U);
+        order_rng_m.seed(seed ^ 0x6f726465725f726eULL);
+    }
+
+    //  Save (restore) the state of the memory model in (from) a checkpoint:
+    //  the content of the memory, the cycle counter and the arrival order of
+    //  the requests, the token bucket, the generator of the random order and
+    //  the state of the DRAM timing model. There shall be no pending
+    //  transaction. The restored run shall use the same timing model, limits
+    //  and order, and the random delay distributions restart from its seed
+    void save_state(std::ostream& os) const
+    {
+        hpdcache_test_mem_func_model::save_state(os);
+
+        const std::string cfg = config_to_string();
+        const uint64_t cfg_size = cfg.size();
+        os.write(reinterpret_cast<const char*>(&cfg_size), sizeof(cfg_size));
+        os.write(cfg.data(), cfg_size);
+
+        os.write(reinterpret_cast<const char*>(&nb_cycles_m), sizeof(nb_cycles_m));
+        os.write(reinterpret_cast<const char*>(&nb_seq_m), sizeof(nb_seq_m));
+        os.write(reinterpret_cast<const char*>(&tokens_m), sizeof(tokens_m));
+
+        std::stringstream rng;
+        rng << order_rng_m;
+        const std::string rng_state = rng.str();
+        const uint64_t rng_size = rng_state.size();
+        os.write(reinterpret_cast<const char*>(&rng_size), sizeof(rng_size));
+        os.write(rng_state.data(), rng_size);
+
+        if (timing_m) timing_m->save_state(os);
+    }
+
+    bool restore_state(std::istream& is)
+    {
+        if (!hpdcache_test_mem_func_model::restore_state(is)) return false;
+
+        uint64_t cfg_size = 0;
+        is.read(reinterpret_cast<char*>(&cfg_size), sizeof(cfg_size));
+        if (!is || (cfg_size > 4096)) return false;
+        std::string cfg(cfg_size, '\0');
+        is.read(&cfg[0], cfg_size);
+        if (!is) return false;
+        if (cfg != config_to_string()) {
+            std::cout << "error: the checkpoint has been saved with another configuration of the"
+                      << " memory model" << std::endl
+                      << "    checkpoint : " << cfg << std::endl
+                      << "    testbench  : " << config_to_string() << std::endl;
+            exit(EXIT_FAILURE);
+        }
+
+        is.read(reinterpret_cast<char*>(&nb_cycles_m), sizeof(nb_cycles_m));
+        is.read(reinterpret_cast<char*>(&nb_seq_m), sizeof(nb_seq_m));
+        is.read(reinterpret_cast<char*>(&tokens_m), sizeof(tokens_m));
+
+        uint64_t rng_size = 0;
+        is.read(reinterpret_cast<char*>(&rng_size), sizeof(rng_size));
+        if (!is || (rng_size > 65536)) return false;
+        std::string rng_state(rng_size, '\0');
+        is.read(&rng_state[0], rng_size);
+        std::stringstream rng(rng_state);
+        rng >> order_rng_m;
+        if (!is || !rng) return false;
+
+        if (timing_m && !timing_m->restore_state(is)) return false;
+        return bool(is);
+    }
+
+    //  Order from a specification string: inorder, ready, random or
+    //  hash[,<cycles>]. It returns false, with a message in err, when the
+    //  string is not valid
+    static bool parse_order(const std::string& spec,
+                            order_e& order,
+                            unsigned& hash_cycles,
+                            std::string& err)
+    {
+        const size_t comma = spec.find(',');
+        const std::string name = spec.substr(0, comma);
+
+        hash_cycles = 16;
+        if (name == "inorder") {
+            order = ORDER_INORDER;
+        } else if (name == "ready") {
+            order = ORDER_READY;
+        } else if (name == "random") {
+            order = ORDER_RANDOM;
+        } else if (name == "hash") {
+            order = ORDER_HASH;
+        } else {
+            err = "unknown memory response order '" + name + "' (inorder, ready, random or hash)";
+            return false;
+        }
+
+        if (comma != std::string::npos) {
+            char* end;
+            const char* arg = spec.c_str() + comma + 1;
+            hash_cycles = strtoul(arg, &end, 0);
+            if ((order != ORDER_HASH) || (*end != '\0') || (end == arg) || (hash_cycles == 0)) {
+                err = "only the hash order takes a (non zero) nb of cycles";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //  Limits of the outstanding reads and writes, and of the bandwidth of the
+    //  memory (read and write data bytes per cycle). The size of the token
+    //  bucket (burst_bytes) is at least the width of the data bus
+    void set_limits(const limits_t& l)
+    {
+        limits_m = l;
+        limits_m.burst_bytes =
+            std::max({ l.burst_bytes, l.bytes_per_cycle, unsigned(HPDCACHE_MEM_DATA_WIDTH / 8) });
+        tokens_m = limits_m.burst_bytes;
+    }
+
+    //  Limits from a specification string:
+    //
+    //      <key>=<value>[,<key>=<value>]*
+    //
+    //  with the keys reads, writes, bw (bytes per cycle) and burst (bytes). It
+    //  returns false, with a message in err, when the string is not valid
+    static bool parse_limits(const std::string& spec, limits_t& l, std::string& err)
+    {
+        std::stringstream ss(spec);
+        std::string tok;
+
+        l = { 0, 0, 0, 0 };
+        while (std::getline(ss, tok, ',')) {
+            const size_t eq = tok.find('=');
+            const std::string key = tok.substr(0, eq);
+            char* end = nullptr;
+            unsigned long val = 0;
+            if (eq != std::string::npos) val = strtoul(tok.c_str() + eq + 1, &end, 0);
+            if ((eq == std::string::npos) || (*end != '\0') || (end == tok.c_str() + eq + 1)) {
+                err = "memory limit '" + tok + "' shall be <key>=<integer>";
+                return false;
+            }
 
-    void add_error_segment(const segment_t& s) { errorsegs.push_back(s); }
+            if (key == "reads") {
+                l.max_reads = val;
+            } else if (key == "writes") {
+                l.max_writes = val;
+            } else if (key == "bw") {
+                l.bytes_per_cycle = val;
+            } else if (key == "burst") {
+                l.burst_bytes = val;
+            } else {
+                err = "unknown memory limit '" + key + "' (reads, writes, bw or burst)";
+                return false;
+            }
+        }
+        return true;
+    }
 
     void set_ra_ready_delay_distribution(scv_bag<pair<int, int>>& dist)
     {
@@ -214,59 +503,133 @@ public:
 
     scv_smart_ptr<int> get_wb_valid_delay_distribution() { return wb_valid_delay; }
 
-    bool within_region(uint64_t base0, uint64_t end0, uint64_t base1, uint64_t end1)
+    bool can_accept_read() const
+    {
+        return (limits_m.max_reads == 0) || (inflight_reads_m < limits_m.max_reads);
+    }
+
+    bool can_accept_write() const
+    {
+        return (limits_m.max_writes == 0) || (inflight_writes_m < limits_m.max_writes);
+    }
+
+    //  Take the given nb of bytes from the token bucket. It returns false if
+    //  there are not enough tokens
+    bool consume_tokens(unsigned bytes)
     {
-        if (end0 <= base1) return false;
-        if (base0 >= end1) return false;
+        if (limits_m.bytes_per_cycle == 0) return true;
+        if (tokens_m < bytes) return false;
+        tokens_m -= bytes;
         return true;
     }
 
-    bool within_error_region(uint64_t base, uint64_t end)
+    //  Called once per cycle: refill the token bucket, and account the
+    //  outstanding transactions
+    void tick()
     {
-        for (const segment_t& s : errorsegs) {
-            if (within_region(s.base_addr, s.end_addr, base, end)) {
-                return s.error;
-            }
+        nb_cycles_m++;
+        if (limits_m.bytes_per_cycle > 0) {
+            tokens_m = std::min<uint64_t>(tokens_m + limits_m.bytes_per_cycle,
+                                          limits_m.burst_bytes);
         }
-        return false;
+        sum_inflight_reads += inflight_reads_m;
+        sum_inflight_writes += inflight_writes_m;
     }
 
-    uint64_t compute_amo(hpdcache_test_transaction_mem_req::hpdcache_mem_atomic_e atop,
-                         uint64_t ld_data,
-                         uint64_t st_data,
-                         unsigned bytes)
+    //  Timing model, limits and order of the memory model
+    std::string config_to_string() const
     {
-        bool umax = (ld_data > st_data);
-        bool smax;
-        if (bytes == 4) {
-            smax = ((int64_t)((int32_t)ld_data) > (int64_t)((int32_t)st_data));
-        } else {
-            smax = (((int64_t)ld_data) > ((int64_t)st_data));
+        std::stringstream ss;
+        ss << "timing=" << (timing_m ? timing_m->to_string() : "random")
+           << " limits=" << limits_m.max_reads << "," << limits_m.max_writes << ","
+           << limits_m.bytes_per_cycle << "," << limits_m.burst_bytes << " order=" << order_m
+           << "," << hash_cycles_m;
+        return ss.str();
+    }
+
+    //  Additional latency of a response in the hash order. All the responses
+    //  of a cacheline have the same latency
+    uint64_t hash_cycles(uint64_t addr) const
+    {
+        if (order_m != ORDER_HASH) return 0;
+        uint64_t h = (addr >> HPDCACHE_CL_OFFSET_WIDTH) * 0x9e3779b97f4a7c15ULL;
+        return (h >> 32) % hash_cycles_m;
+    }
+
+    void push_read_resp(mem_read_resp_flit_t f, uint64_t addr)
+    {
+        f.ready += hash_cycles(addr);
+        read_resp_q[f.resp.id].push_back(f);
+        read_resp_ids.insert(f.resp.id);
+    }
+
+    void push_write_resp(mem_write_resp_flit_t f, uint64_t addr)
+    {
+        f.ready += hash_cycles(addr);
+        write_resp_q[f.resp.id].push_back(f);
+        write_resp_ids.insert(f.resp.id);
+    }
+
+    //  Select the ID of the next response according to the order of the
+    //  responses. It returns false if no response can be sent
+    template<typename F>
+    bool select_resp(const std::vector<std::deque<F>>& q,
+                     const std::set<uint32_t>& ids,
+                     uint32_t& id)
+    {
+        bool found = false;
+        uint64_t oldest = 0;
+
+        if (order_m == ORDER_INORDER) {
+            //  the oldest response, once it is ready
+            for (uint32_t i : ids) {
+                if (!found || (q[i].front().seq < oldest)) {
+                    found = true;
+                    oldest = q[i].front().seq;
+                    id = i;
+                }
+            }
+            return found && (q[id].front().ready <= nb_cycles_m);
+        }
+
+        if (order_m == ORDER_RANDOM) {
+            std::vector<uint32_t> ready;
+            for (uint32_t i : ids) {
+                if (q[i].front().ready <= nb_cycles_m) ready.push_back(i);
+            }
+            if (ready.empty()) return false;
+            id = ready[order_rng_m() % ready.size()];
+            return true;
         }
 
-        switch (atop) {
-            case hpdcache_mem_atomic_e::HPDCACHE_MEM_ATOMIC_ADD:
-                return ld_data + st_data;
-            case hpdcache_mem_atomic_e::HPDCACHE_MEM_ATOMIC_CLR:
-                return ld_data & ~st_data;
-            case hpdcache_mem_atomic_e::HPDCACHE_MEM_ATOMIC_SET:
-                return ld_data | st_data;
-            case hpdcache_mem_atomic_e::HPDCACHE_MEM_ATOMIC_EOR:
-                return ld_data ^ st_data;
-            case hpdcache_mem_atomic_e::HPDCACHE_MEM_ATOMIC_SMAX:
-                return smax ? ld_data : st_data;
-            case hpdcache_mem_atomic_e::HPDCACHE_MEM_ATOMIC_UMAX:
-                return umax ? ld_data : st_data;
-            case hpdcache_mem_atomic_e::HPDCACHE_MEM_ATOMIC_SMIN:
-                return smax ? st_data : ld_data;
-            case hpdcache_mem_atomic_e::HPDCACHE_MEM_ATOMIC_UMIN:
-                return umax ? st_data : ld_data;
-            case hpdcache_mem_atomic_e::HPDCACHE_MEM_ATOMIC_SWAP:
-                return st_data;
+        //  the oldest ready response
+        for (uint32_t i : ids) {
+            const F& f = q[i].front();
+            if (f.ready > nb_cycles_m) continue;
+            if (!found || (f.seq < oldest)) {
+                found = true;
+                oldest = f.seq;
+                id = i;
+            }
         }
+        return found;
+    }
 
-        sc_assert(false && "unknown atomic operation");
-        return 0;
+    //  Take the first response of an ID. A response is reordered when the
+    //  response of a younger request was sent before it
+    template<typename F>
+    static F pop_resp(std::vector<std::deque<F>>& q,
+                      std::set<uint32_t>& ids,
+                      uint32_t id,
+                      uint64_t& seq_end,
+                      uint64_t& nb_reordered)
+    {
+        F f = q[id].front();
+        q[id].pop_front();
+        if (q[id].empty()) ids.erase(id);
+        if (f.seq + 1 < seq_end) nb_reordered++;
+        seq_end = std::max(seq_end, f.seq + 1);
+        return f;
     }
 };
 
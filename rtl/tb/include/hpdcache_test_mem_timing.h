@@ -0,0 +1,345 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Timing model of a DRAM subsystem for the memory model of the
+ *               HPDCACHE testbench. It models the channels, the banks with
+ *               their row buffer (open-page policy), the tRCD/tCAS/tRP
+ *               timings, the periodic refresh, and the occupancy of the data
+ *               bus of each channel. All the timings are in clock cycles of
+ *               the cache
+ */
+#ifndef __HPDCACHE_TEST_MEM_TIMING_H__
+#define __HPDCACHE_TEST_MEM_TIMING_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class hpdcache_test_mem_timing
+{
+public:
+    struct config_t
+    {
+        std::string name;
+        unsigned channels;
+        unsigned banks;
+        unsigned row_bytes;
+        unsigned interleave_bytes;
+        unsigned bus_bytes_per_cycle;
+        unsigned tRCD;
+        unsigned tCAS;
+        unsigned tRP;
+        unsigned tREFI;
+        unsigned tRFC;
+    };
+
+    //  Configuration from a specification string:
+    //
+    //      <ddr4|hbm2>[,<key>=<value>]*
+    //
+    //  The name selects the preset, and the keys (channels, banks, row,
+    //  interleave, bus, trcd, tcas, trp, trefi, trfc) override its parameters.
+    //  It returns false, with a message in err, when the string is not valid
+    static bool parse(const std::string& spec, config_t& cfg, std::string& err)
+    {
+        std::stringstream ss(spec);
+        std::string tok;
+
+        std::getline(ss, tok, ',');
+        if (!preset(tok, cfg)) {
+            err = "unknown memory timing preset '" + tok + "' (ddr4 or hbm2)";
+            return false;
+        }
+
+        while (std::getline(ss, tok, ',')) {
+            const size_t eq = tok.find('=');
+            if (eq == std::string::npos) {
+                err = "memory timing parameter '" + tok + "' shall be <key>=<value>";
+                return false;
+            }
+
+            const std::string key = tok.substr(0, eq);
+            char* end;
+            const unsigned long val = strtoul(tok.c_str() + eq + 1, &end, 0);
+            if ((*end != '\0') || (end == tok.c_str() + eq + 1)) {
+                err = "memory timing parameter '" + key + "' needs an integer value";
+                return false;
+            }
+
+            unsigned* p = param(cfg, key);
+            if (p == nullptr) {
+                err = "unknown memory timing parameter '" + key + "'";
+                return false;
+            }
+            *p = val;
+        }
+
+        if ((cfg.channels == 0) || (cfg.banks == 0) || (cfg.bus_bytes_per_cycle == 0)) {
+            err = "the channels, banks and bus parameters shall not be zero";
+            return false;
+        }
+        if ((cfg.interleave_bytes == 0) || (cfg.row_bytes % cfg.interleave_bytes)) {
+            err = "the row size shall be a multiple of the (non zero) interleave";
+            return false;
+        }
+        if ((cfg.tREFI > 0) && (cfg.tRFC >= cfg.tREFI)) {
+            err = "the refresh time (trfc) shall be smaller than its period (trefi)";
+            return false;
+        }
+        return true;
+    }
+
+    explicit hpdcache_test_mem_timing(const config_t& cfg)
+      : cfg_m(cfg)
+      , channels_m(cfg.channels)
+      , nb_reads(0)
+      , nb_writes(0)
+      , nb_row_hits(0)
+      , nb_row_misses(0)
+      , nb_row_conflicts(0)
+      , nb_refresh_stalls(0)
+      , nb_bus_busy_cycles(0)
+      , sum_latency(0)
+    {
+        for (channel_t& ch : channels_m) {
+            ch.bus_free = 0;
+            ch.refresh_epoch = 0;
+            ch.banks.resize(cfg.banks);
+        }
+    }
+
+    const config_t& get_config() const { return cfg_m; }
+
+    //  Number of cycles needed to transfer the given number of bytes on the
+    //  data bus of a channel
+    uint64_t transfer_cycles(uint64_t bytes) const
+    {
+        const uint64_t n = (bytes + cfg_m.bus_bytes_per_cycle - 1) / cfg_m.bus_bytes_per_cycle;
+        return std::max<uint64_t>(n, 1);
+    }
+
+    //  Access of the given number of bytes at the given address, issued at
+    //  cycle now. It returns the cycle where the first data is transferred on
+    //  the data bus. The data bus of the channel is then occupied for
+    //  transfer_cycles(bytes)
+    uint64_t access(uint64_t now, uint64_t addr, uint64_t bytes, bool is_write)
+    {
+        const uint64_t block = addr / cfg_m.interleave_bytes;
+        const uint64_t blocks_per_row = cfg_m.row_bytes / cfg_m.interleave_bytes;
+        channel_t& ch = channels_m[block % cfg_m.channels];
+        bank_t& bank = ch.banks[(block / cfg_m.channels) % cfg_m.banks];
+        const uint64_t row = block / cfg_m.channels / cfg_m.banks / blocks_per_row;
+
+        uint64_t t = std::max(now, bank.ready);
+        const uint64_t xfer = transfer_cycles(bytes);
+        uint64_t start;
+        for (;;) {
+            t = refresh(ch, t);
+
+            if (bank.open && (bank.row == row)) {
+                start = t + cfg_m.tCAS;
+            } else if (!bank.open) {
+                start = t + cfg_m.tRCD + cfg_m.tCAS;
+            } else {
+                start = t + cfg_m.tRP + cfg_m.tRCD + cfg_m.tCAS;
+            }
+            start = std::max(start, ch.bus_free);
+
+            //  the transfer on the data bus shall not overlap a refresh: the
+            //  access is then issued again after it (unless the transfer is
+            //  longer than the interval between two refreshes)
+            if ((cfg_m.tREFI == 0) || (xfer > cfg_m.tREFI - cfg_m.tRFC)) break;
+            const uint64_t next = (start / cfg_m.tREFI + 1) * cfg_m.tREFI;
+            if (in_refresh(start)) {
+                t = start;
+            } else if (start + xfer > next) {
+                t = next;
+            } else {
+                break;
+            }
+        }
+
+        if (bank.open && (bank.row == row)) {
+            nb_row_hits++;
+        } else if (!bank.open) {
+            nb_row_misses++;
+        } else {
+            nb_row_conflicts++;
+        }
+        bank.open = true;
+        bank.row = row;
+
+        //  the column commands of a bank are pipelined: the next one may be
+        //  issued once this one released the data bus
+        ch.bus_free = start + xfer;
+        bank.ready = start + xfer - cfg_m.tCAS;
+        nb_bus_busy_cycles += xfer;
+
+        if (is_write) {
+            nb_writes++;
+        } else {
+            nb_reads++;
+        }
+        sum_latency += start - now;
+        return start;
+    }
+
+    //  Save (restore) the state of the banks and of the data buses in (from) a
+    //  checkpoint. The statistics are not saved
+    void save_state(std::ostream& os) const
+    {
+        for (const channel_t& ch : channels_m) {
+            os.write(reinterpret_cast<const char*>(&ch.bus_free), sizeof(ch.bus_free));
+            os.write(reinterpret_cast<const char*>(&ch.refresh_epoch), sizeof(ch.refresh_epoch));
+            for (const bank_t& b : ch.banks) {
+                os.write(reinterpret_cast<const char*>(&b.open), sizeof(b.open));
+                os.write(reinterpret_cast<const char*>(&b.row), sizeof(b.row));
+                os.write(reinterpret_cast<const char*>(&b.ready), sizeof(b.ready));
+            }
+        }
+    }
+
+    bool restore_state(std::istream& is)
+    {
+        for (channel_t& ch : channels_m) {
+            is.read(reinterpret_cast<char*>(&ch.bus_free), sizeof(ch.bus_free));
+            is.read(reinterpret_cast<char*>(&ch.refresh_epoch), sizeof(ch.refresh_epoch));
+            for (bank_t& b : ch.banks) {
+                is.read(reinterpret_cast<char*>(&b.open), sizeof(b.open));
+                is.read(reinterpret_cast<char*>(&b.row), sizeof(b.row));
+                is.read(reinterpret_cast<char*>(&b.ready), sizeof(b.ready));
+            }
+        }
+        return bool(is);
+    }
+
+    //  Parameters of the model, to check that a checkpoint is restored with
+    //  the same ones
+    std::string to_string() const
+    {
+        std::stringstream ss;
+        ss << cfg_m.name << ",channels=" << cfg_m.channels << ",banks=" << cfg_m.banks
+           << ",row=" << cfg_m.row_bytes << ",interleave=" << cfg_m.interleave_bytes
+           << ",bus=" << cfg_m.bus_bytes_per_cycle << ",trcd=" << cfg_m.tRCD
+           << ",tcas=" << cfg_m.tCAS << ",trp=" << cfg_m.tRP << ",trefi=" << cfg_m.tREFI
+           << ",trfc=" << cfg_m.tRFC;
+        return ss.str();
+    }
+
+    void print_stats(std::ostream& os) const
+    {
+        const uint64_t nb_accesses = nb_reads + nb_writes;
+
+        os << "MEMORY TIMING STATISTICS (" << cfg_m.name << ")" << std::endl
+           << "--------------------------------------------------" << std::endl
+           << "MEM.NB_READS            : " << nb_reads << std::endl
+           << "MEM.NB_WRITES           : " << nb_writes << std::endl
+           << "MEM.NB_ROW_HITS         : " << nb_row_hits << std::endl
+           << "MEM.NB_ROW_MISSES       : " << nb_row_misses << std::endl
+           << "MEM.NB_ROW_CONFLICTS    : " << nb_row_conflicts << std::endl
+           << "MEM.NB_REFRESH_STALLS   : " << nb_refresh_stalls << std::endl
+           << "MEM.NB_BUS_BUSY_CYCLES  : " << nb_bus_busy_cycles << std::endl
+           << std::endl
+
+           << "Computed values" << std::endl
+           << "---------------" << std::endl
+           << "Row hit rate            : "
+           << (nb_accesses > 0 ? (double)nb_row_hits / nb_accesses : 0) << std::endl
+           << "Mean access latency     : "
+           << (nb_accesses > 0 ? (double)sum_latency / nb_accesses : 0) << std::endl;
+    }
+
+private:
+    struct bank_t
+    {
+        bool open = false;
+        uint64_t row = 0;
+        uint64_t ready = 0;
+    };
+
+    struct channel_t
+    {
+        uint64_t bus_free;
+        uint64_t refresh_epoch; //  index of the last refresh seen (t / tREFI)
+        std::vector<bank_t> banks;
+    };
+
+    config_t cfg_m;
+    std::vector<channel_t> channels_m;
+
+    uint64_t nb_reads;
+    uint64_t nb_writes;
+    uint64_t nb_row_hits;
+    uint64_t nb_row_misses;
+    uint64_t nb_row_conflicts;
+    uint64_t nb_refresh_stalls;
+    uint64_t nb_bus_busy_cycles;
+    uint64_t sum_latency;
+
+    //  True if the commands are blocked by a refresh at cycle t. A refresh
+    //  starts at each multiple of tREFI (but the first) and lasts tRFC
+    bool in_refresh(uint64_t t) const
+    {
+        return (cfg_m.tREFI > 0) && (t >= cfg_m.tREFI) && ((t % cfg_m.tREFI) < cfg_m.tRFC);
+    }
+
+    //  Apply the refreshes of a channel up to cycle t: each refresh closes all
+    //  the rows of the channel, even if no access fell into its window. It
+    //  returns the first cycle, from t, where a command may be issued
+    uint64_t refresh(channel_t& ch, uint64_t t)
+    {
+        if (cfg_m.tREFI == 0) return t;
+
+        const uint64_t epoch = t / cfg_m.tREFI;
+        if (epoch > ch.refresh_epoch) {
+            ch.refresh_epoch = epoch;
+            for (bank_t& b : ch.banks) b.open = false;
+        }
+        if (in_refresh(t)) {
+            nb_refresh_stalls++;
+            return t + cfg_m.tRFC - (t % cfg_m.tREFI);
+        }
+        return t;
+    }
+
+    static bool preset(const std::string& name, config_t& cfg)
+    {
+        if (name == "ddr4") {
+            //  a single channel of DDR4 with 16 banks and pages of 8 KiB
+            cfg = { name, 1, 16, 8192, 8192, 32, 14, 14, 14, 7800, 350 };
+            return true;
+        }
+        if (name == "hbm2") {
+            //  8 channels of HBM2 interleaved every 256 bytes, with pages of 1 KiB
+            cfg = { name, 8, 16, 1024, 256, 32, 14, 14, 14, 3900, 260 };
+            return true;
+        }
+        return false;
+    }
+
+    static unsigned* param(config_t& cfg, const std::string& key)
+    {
+        if (key == "channels") return &cfg.channels;
+        if (key == "banks") return &cfg.banks;
+        if (key == "row") return &cfg.row_bytes;
+        if (key == "interleave") return &cfg.interleave_bytes;
+        if (key == "bus") return &cfg.bus_bytes_per_cycle;
+        if (key == "trcd") return &cfg.tRCD;
+        if (key == "tcas") return &cfg.tCAS;
+        if (key == "trp") return &cfg.tRP;
+        if (key == "trefi") return &cfg.tREFI;
+        if (key == "trfc") return &cfg.tRFC;
+        return nullptr;
+    }
+};
+
+#endif /* __HPDCACHE_TEST_MEM_TIMING_H__ */
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
@@ -12,21 +12,25 @@
 #ifndef __HPDCACHE_TEST_SCOREBOARD_H__
 #define __HPDCACHE_TEST_SCOREBOARD_H__
 
+#include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
-#include <map>
 #include <memory>
 #include <sstream>
 #include <systemc>
+#include <vector>
 #include <verilated.h>
 
 #include "generic_cache_directory_plru.h"
 #include "hpdcache_test_amo.h"
 #include "hpdcache_test_defs.h"
 #include "hpdcache_test_driver.h"
+#include "hpdcache_test_latency.h"
 #include "hpdcache_test_mem_resp_model_base.h"
+#include "hpdcache_test_scoreboard_base.h"
 #include "hpdcache_test_sequence.h"
 #include "logger.h"
-#include "ram_model.h"
 
 // FIXME currently this cannot be set because there are some race conditions
 // badly handled. The race conditions are when there is a refill on a given
@@ -37,11 +41,14 @@
 //
 // #define ENABLE_CACHE_DIR_VERIF 1
 
-class hpdcache_test_scoreboard : public sc_module
+class hpdcache_test_scoreboard
+  : public sc_module
+  , public hpdcache_test_scoreboard_base
 {
 public:
     sc_in<bool> clk_i;
 
+    //  These ports can be bound to several FIFOs (one per requester agent)
     sc_fifo_in<hpdcache_test_transaction_req> core_req_i;
     sc_fifo_in<hpdcache_test_transaction_resp> core_resp_i;
 
@@ -77,45 +84,23 @@ public:
       , mem_read_resp_i("mem_read_resp_i")
       , mem_write_req_i("mem_write_req_i")
       , mem_write_resp_i("mem_write_resp_i")
-      , nb_cycles(0)
-      , nb_cycles_effective(0)
-      , nb_core_req(0)
-      , nb_core_req_need_rsp(0)
-      , nb_core_resp(0)
-      , nb_mem_read_req(0)
-      , nb_mem_read_resp(0)
-      , nb_mem_write_req(0)
-      , nb_mem_write_resp(0)
-      , nb_error(0)
-      , sb_error_limit_m(0)
-      , evt_cache_write_miss(0)
-      , evt_cache_read_miss(0)
-      , evt_cache_dir_unc_err(0)
-      , evt_cache_dir_cor_err(0)
-      , evt_cache_dat_unc_err(0)
-      , evt_cache_dat_cor_err(0)
-      , evt_scrub_complete(0)
-      , evt_uncached_req(0)
-      , evt_cmo_req(0)
-      , evt_write_req(0)
-      , evt_read_req(0)
-      , evt_prefetch_req(0)
-      , evt_req_on_hold(0)
-      , evt_rtab_rollback(0)
-      , evt_stall_refill(0)
-      , evt_stall(0)
-      , seq(nullptr)
+      , perf_period_m(0)
+      , perf_next_m(0)
+      , perf_last_cycle_m(0)
+      , perf_json_m(false)
+      , perf_first_m(true)
+      , chrome_first_m(true)
+      , seqs(NREQUESTERS, nullptr)
+      , req_stats_m(NREQUESTERS)
+      , core_req_rr_m(0)
+      , core_resp_rr_m(0)
       , mem_resp_model(nullptr)
-      , sc_is_atomic(false)
-      ,
 #if ENABLE_CACHE_DIR_VERIF
-      cache_dir_m(std::make_shared<GenericCacheDirectoryPlru>("hpdcache_dir",
-                                                              HPDCACHE_NWAYS,
-                                                              HPDCACHE_NSETS,
-                                                              HPDCACHE_NWORDS * 8))
-      ,
+      , cache_dir_m(std::make_shared<GenericCacheDirectoryPlru>("hpdcache_dir",
+                                                                HPDCACHE_NWAYS,
+                                                                HPDCACHE_NSETS,
+                                                                HPDCACHE_NWORDS * 8))
 #endif
-      ram_m(std::make_shared<ram_t>("ram"))
     {
         SC_THREAD(core_req_process);
         SC_THREAD(core_resp_process);
@@ -134,224 +119,161 @@ public:
     ~hpdcache_test_scoreboard()
     {
         std::stringstream ss;
-        if (nb_core_resp != nb_core_req_need_rsp) {
-            ss.str("");
-            ss << "number of responses (" << nb_core_resp
-               << ") is different than the number of requests (" << nb_core_req_need_rsp << ")";
-            print_error(ss.str());
-        }
-        if (evt_cache_write_miss > evt_write_req) {
-            ss.str("");
-            ss << "number of write misses (" << evt_cache_write_miss
-               << ") is bigger than the number of write requests (" << evt_write_req << ")";
-            print_error(ss.str());
-        }
-        if (evt_cache_read_miss > evt_read_req) {
-            ss.str("");
-            ss << "number of read misses (" << evt_cache_read_miss
-               << ") is bigger than the number of read requests (" << evt_read_req << ")";
-            print_error(ss.str());
-        }
-        if (seq->ids_size() > 0) {
-            ss.str("");
-            ss << "unresponded ids:";
-            for (auto it : seq->get_ids()) {
-                ss << " 0x" << std::hex << it << std::dec;
+
+        check_end();
+        for (unsigned sid = 0; sid < NREQUESTERS; sid++) {
+            if (seqs[sid] && seqs[sid]->ids_size() > 0) {
+                ss.str("");
+                ss << "unresponded ids (sid = " << sid << "):";
+                for (auto it : seqs[sid]->get_ids()) {
+                    ss << " 0x" << std::hex << it << std::dec;
+                }
+                print_error(ss.str());
             }
-            print_error(ss.str());
         }
 
         if (check_verbosity(sc_core::SC_LOW)) {
             ss.str("");
-            ss << "SCOREBOARD STATISTICS" << std::endl
-               << "Status" << std::endl
-               << "--------------------------------------------------" << std::endl
-               << "SB.NB_ERROR             : " << nb_error << std::endl
-               << std::endl
-
-               << "Instrumentation" << std::endl
-               << "--------------------------------------------------" << std::endl
-               << "SB.NB_CYCLES            : " << nb_cycles_effective << std::endl
-               << "SB.NB_CORE_REQ          : " << nb_core_req << std::endl
-               << "SB.NB_CORE_RESP         : " << nb_core_resp << std::endl
-               << "SB.NB_MEM_READ_REQ      : " << nb_mem_read_req << std::endl
-               << "SB.NB_MEM_READ_RESP     : " << nb_mem_read_resp << std::endl
-               << "SB.NB_MEM_WRITE_REQ     : " << nb_mem_write_req << std::endl
-               << "SB.NB_MEM_WRITE_RESP    : " << nb_mem_write_resp << std::endl
-               << "CACHE.WRITE_MISSES      : " << evt_cache_write_miss << std::endl
-               << "CACHE.READ_MISSES       : " << evt_cache_read_miss << std::endl
-               << "CACHE.DIR_UNC_ERRORS    : " << evt_cache_dir_unc_err << std::endl
-               << "CACHE.DIR_COR_ERRORS    : " << evt_cache_dir_cor_err << std::endl
-               << "CACHE.DAT_UNC_ERRORS    : " << evt_cache_dat_unc_err << std::endl
-               << "CACHE.DAT_COR_ERRORS    : " << evt_cache_dat_cor_err << std::endl
-               << "CACHE.SCRUBBER_COMPLETE : " << evt_scrub_complete << std::endl
-               << "CACHE.UNCACHED_REQUESTS : " << evt_uncached_req << std::endl
-               << "CACHE.CMO_REQUESTS      : " << evt_cmo_req << std::endl
-               << "CACHE.WRITE_REQUESTS    : " << evt_write_req << std::endl
-               << "CACHE.READ_REQUESTS     : " << evt_read_req << std::endl
-               << "CACHE.PREFETCH_REQUESTS : " << evt_prefetch_req << std::endl
-               << "CACHE.ON_HOLD_REQUESTS  : " << evt_req_on_hold << std::endl
-               << "CACHE.RTAB_ROLLBACK     : " << evt_rtab_rollback << std::endl
-               << "CACHE.STALL_REFILL      : " << evt_stall_refill << std::endl
-               << "CACHE.STALL             : " << evt_stall << std::endl
-               << std::endl
-
-               << "Computed values" << std::endl
-               << "---------------" << std::endl
-               << "Cycles per request      : "
-               << (nb_core_req > 0 ? (double)nb_cycles_effective / nb_core_req : 0) << std::endl
-               << "Read miss rate          : "
-               << (evt_read_req > 0 ? (double)evt_cache_read_miss / evt_read_req : 0) << std::endl
-               << "Write miss rate         : "
-               << (evt_write_req > 0 ? (double)evt_cache_write_miss / evt_write_req : 0)
-               << std::endl;
+            print_stats(ss);
+            print_requester_stats(ss);
 
             std::cout << ss.str() << std::endl;
         }
+
+        if (!latency_file_m.empty()) {
+            write_latency_file();
+        }
+
+        if (perf_file_m.is_open()) {
+            if (nb_cycles > perf_last_cycle_m) write_perf_sample();
+            if (perf_json_m) perf_file_m << std::endl << "]" << std::endl;
+            perf_file_m.close();
+        }
+
+        if (chrome_file_m.is_open()) {
+            chrome_file_m << std::endl << "]}" << std::endl;
+            chrome_file_m.close();
+        }
     }
 
-    void set_sequence(std::shared_ptr<hpdcache_test_sequence> p) { seq = p; }
+    //  Set the sequence generating the requests with the given source ID. The
+    //  scoreboard releases the transaction IDs of that sequence once the
+    //  corresponding requests are completed
+    void set_sequence(std::shared_ptr<hpdcache_test_sequence> p, unsigned sid = 0)
+    {
+        assert(sid < NREQUESTERS);
+        seqs[sid] = p;
+    }
 
     void set_mem_resp_model(std::shared_ptr<hpdcache_test_mem_resp_model_base> p)
     {
         mem_resp_model = p;
+        mem_model_m = p.get();
     }
 
-    void set_error_limit(size_t error_limit) { sb_error_limit_m = error_limit; }
-
-private:
-    uint64_t nb_cycles;
-    uint64_t nb_cycles_effective;
-    uint64_t nb_core_req;
-    uint64_t nb_core_req_need_rsp;
-    uint64_t nb_core_resp;
-    uint64_t nb_mem_read_req;
-    uint64_t nb_mem_read_resp;
-    uint64_t nb_mem_write_req;
-    uint64_t nb_mem_write_resp;
-
-    size_t nb_error;
-    size_t sb_error_limit_m;
-
-    uint64_t evt_cache_write_miss;
-    uint64_t evt_cache_read_miss;
-    uint64_t evt_cache_dir_unc_err;
-    uint64_t evt_cache_dir_cor_err;
-    uint64_t evt_cache_dat_unc_err;
-    uint64_t evt_cache_dat_cor_err;
-    uint64_t evt_scrub_complete;
-    uint64_t evt_uncached_req;
-    uint64_t evt_cmo_req;
-    uint64_t evt_write_req;
-    uint64_t evt_read_req;
-    uint64_t evt_prefetch_req;
-    uint64_t evt_req_on_hold;
-    uint64_t evt_rtab_rollback;
-    uint64_t evt_stall_refill;
-    uint64_t evt_stall;
-
-    std::shared_ptr<hpdcache_test_sequence> seq;
-    std::shared_ptr<hpdcache_test_mem_resp_model_base> mem_resp_model;
-
-    static constexpr unsigned int CORE_REQ_WORDS = HPDCACHE_REQ_WORDS;
-    static constexpr unsigned int CORE_REQ_WORD_BYTES = HPDCACHE_WORD_WIDTH / 8;
-    static constexpr unsigned int CORE_REQ_BYTES = CORE_REQ_WORDS * CORE_REQ_WORD_BYTES;
+    //  Write the latency distributions in the given file (JSON) at the end of
+    //  the simulation
+    void set_latency_file(const std::string& name) { latency_file_m = name; }
 
-    struct inflight_entry_t
+    //  Write the variation of the performance counters every given nb of
+    //  cycles in a file. The format is JSON if the name of the file ends with
+    //  .json, CSV otherwise
+    void set_perf_sampling(uint64_t period, const std::string& name)
     {
-        uint64_t time;
-        uint32_t tid;
-        uint64_t addr;
-        bool need_rsp;
-        bool hit;
-        bool is_read;
-        bool is_write;
-        bool is_amo;
-        bool is_amo_sc;
-        bool is_amo_lr;
-        bool is_atomic;
-        bool is_error;
-        unsigned op;
-        bool is_uncacheable;
-        uint8_t bytes;
-        uint64_t wdata[CORE_REQ_WORDS];
-        uint8_t be[CORE_REQ_WORDS];
-        uint64_t rdata[CORE_REQ_WORDS];
-        uint8_t rv[CORE_REQ_WORDS];
-
-        const std::string to_string() const
-        {
-            std::stringstream ss;
-            ss << "@0x" << std::hex << addr << std::dec << (hit ? " / hit" : " / miss")
-               << (is_read     ? " / read"
-                   : is_write  ? " / write"
-                   : is_amo    ? " / amo"
-                   : is_amo_sc ? " / sc"
-                   : is_amo_lr ? " / lr"
-                               : "")
-               << " / " << hpdcache_test_transaction_req::op_to_string(op)
-               << (is_uncacheable ? " / uncacheable" : "") << " / bytes = " << (unsigned)bytes;
-
-            return ss.str();
+        perf_file_m.open(name);
+        if (!perf_file_m) {
+            std::cout << "error: cannot create the performance counters file " << name
+                      << std::endl;
+            exit(EXIT_FAILURE);
         }
 
-        friend std::ostream& operator<<(std::ostream& os, const inflight_entry_t& req)
-        {
-            os << req.to_string();
-            return os;
-        }
-    };
+        perf_period_m = period;
+        perf_next_m = period;
+        perf_json_m = (name.size() >= 5) && (name.compare(name.size() - 5, 5, ".json") == 0);
+        for (unsigned i = 0; i < NB_PERF_COUNTERS; i++) perf_last_m[i] = 0;
 
-    struct inflight_mem_entry_t
-    {
-        uint64_t addr;
-        uint8_t bytes;
-        bool is_uncacheable;
-        bool is_error;
-        const inflight_entry_t* core_req_ptr;
-    };
+        if (perf_json_m) {
+            perf_file_m << "[";
+        } else {
+            perf_file_m << "cycle,cycles,core_req_total";
+            for (unsigned i = 0; i < NB_PERF_COUNTERS; i++) {
+                perf_file_m << "," << perf_counter_name(i);
+            }
+            perf_file_m << std::endl;
+        }
+    }
 
-    struct lrsc_reservation_buf_t
+    //  Write the lifetime of the core requests and of the memory transactions
+    //  in a file with the trace event format (JSON) of chrome://tracing and
+    //  Perfetto. Timestamps are in cycles (shown as microseconds)
+    void set_chrome_trace_file(const std::string& name)
     {
-        bool valid;
-        uint64_t base_addr;
-        uint64_t end_addr;
-        bool is_atomic;
-    };
+        chrome_file_m.open(name);
+        if (!chrome_file_m) {
+            std::cout << "error: cannot create the transaction trace file " << name << std::endl;
+            exit(EXIT_FAILURE);
+        }
 
-    static inline bool within_region(uint64_t addr, uint64_t base, uint64_t end)
-    {
-        if (addr < base) return false;
-        if (addr > end) return false;
-        return true;
+        chrome_file_m << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+        for (unsigned sid = 0; sid < NREQUESTERS; sid++) {
+            std::stringstream ss;
+            ss << "core requests (sid " << sid << ")";
+            write_chrome_process_name(sid, ss.str());
+        }
+        write_chrome_process_name(CHROME_PID_MEM_READ, "memory reads");
+        write_chrome_process_name(CHROME_PID_MEM_WRITE, "memory writes");
     }
 
-    static inline uint64_t get_nline(uint64_t addr) { return addr >> HPDCACHE_CL_OFFSET_WIDTH; }
-
-    static inline uint64_t get_offset(uint64_t addr)
+private:
+    std::string latency_file_m;
+
+    //  Periodic sampling of the performance counters (see set_perf_sampling)
+    static constexpr unsigned NB_PERF_COUNTERS = 20;
+    std::ofstream perf_file_m;
+    uint64_t perf_period_m;
+    uint64_t perf_next_m;
+    uint64_t perf_last_cycle_m;
+    bool perf_json_m;
+    bool perf_first_m;
+    uint64_t perf_last_m[NB_PERF_COUNTERS];
+
+    //  Transaction lifetime trace (see set_chrome_trace_file). There is one
+    //  process per requester, where each transaction ID is a thread, and one
+    //  process for each memory channel, where each memory ID is a thread
+    static constexpr unsigned CHROME_PID_MEM_READ = NREQUESTERS;
+    static constexpr unsigned CHROME_PID_MEM_WRITE = NREQUESTERS + 1;
+    std::ofstream chrome_file_m;
+    bool chrome_first_m;
+
+    //  Per-requester statistics (indexed by source ID)
+    struct requester_stats_t
     {
-        return addr & ((1ULL << HPDCACHE_CL_OFFSET_WIDTH) - 1);
-    }
+        uint64_t nb_req;
+        uint64_t nb_resp;
+        hpdcache_test_latency latency;
+        uint64_t first_cycle;
+        uint64_t last_cycle;
+
+        requester_stats_t()
+          : nb_req(0)
+          , nb_resp(0)
+          , first_cycle(0)
+          , last_cycle(0)
+        {
+        }
+    };
 
-    typedef std::map<uint32_t, inflight_entry_t> inflight_map_t;
-    typedef std::pair<uint32_t, inflight_entry_t> inflight_map_pair_t;
-    typedef std::map<uint64_t, inflight_mem_entry_t> inflight_mem_map_t;
-    typedef std::pair<uint32_t, inflight_mem_entry_t> inflight_mem_map_pair_t;
-    typedef ram_model<SCOREBOARD_RAM_SIZE> ram_t;
+    std::vector<std::shared_ptr<hpdcache_test_sequence>> seqs;
+    std::vector<requester_stats_t> req_stats_m;
+
+    unsigned core_req_rr_m;
+    unsigned core_resp_rr_m;
+    std::shared_ptr<hpdcache_test_mem_resp_model_base> mem_resp_model;
 
 #if ENABLE_CACHE_DIR_VERIF
     std::shared_ptr<GenericCacheDirectoryPlru> cache_dir_m;
 #endif
 
-    inflight_map_t inflight_m;
-    inflight_mem_map_t inflight_mem_read_m;
-    inflight_mem_map_t inflight_mem_write_m;
-    lrsc_reservation_buf_t lrsc_buf_m;
-    std::shared_ptr<ram_t> ram_m;
-
-    sc_fifo<inflight_entry_t> inflight_amo_req_m;
-    bool sc_is_atomic;
-
 #if SC_VERSION_MAJOR < 3
     SC_HAS_PROCESS(hpdcache_test_scoreboard);
 #endif
@@ -375,70 +297,280 @@ private:
         if (evt_rtab_rollback_i.read()) evt_rtab_rollback++;
         if (evt_stall_refill_i.read()) evt_stall_refill++;
         if (evt_stall_i.read()) evt_stall++;
+
+        if (perf_period_m && (nb_cycles >= perf_next_m)) {
+            write_perf_sample();
+            perf_next_m += perf_period_m;
+        }
+    }
+
+    static const char* perf_counter_name(unsigned i)
+    {
+        static const char* const names[NB_PERF_COUNTERS] = {
+            "core_req",       "core_resp",    "mem_read_req",  "mem_write_req", "write_miss",
+            "read_miss",      "dir_unc_err",  "dir_cor_err",   "dat_unc_err",   "dat_cor_err",
+            "scrub_complete", "uncached_req", "cmo_req",       "write_req",     "read_req",
+            "prefetch_req",   "req_on_hold",  "rtab_rollback", "stall_refill",  "stall"
+        };
+        return names[i];
+    }
+
+    void get_perf_counters(uint64_t* v) const
+    {
+        const uint64_t counters[NB_PERF_COUNTERS] = {
+            nb_core_req,           nb_core_resp,          nb_mem_read_req,
+            nb_mem_write_req,      evt_cache_write_miss,  evt_cache_read_miss,
+            evt_cache_dir_unc_err, evt_cache_dir_cor_err, evt_cache_dat_unc_err,
+            evt_cache_dat_cor_err, evt_scrub_complete,    evt_uncached_req,
+            evt_cmo_req,           evt_write_req,         evt_read_req,
+            evt_prefetch_req,      evt_req_on_hold,       evt_rtab_rollback,
+            evt_stall_refill,      evt_stall
+        };
+        for (unsigned i = 0; i < NB_PERF_COUNTERS; i++) v[i] = counters[i];
+    }
+
+    void write_chrome_event(const std::string& event)
+    {
+        chrome_file_m << (chrome_first_m ? "" : ",") << std::endl << "  " << event;
+        chrome_first_m = false;
+    }
+
+    void write_chrome_process_name(unsigned pid, const std::string& name)
+    {
+        std::stringstream ss;
+        ss << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << pid
+           << ", \"args\": {\"name\": \"" << name << "\"}}";
+        write_chrome_event(ss.str());
     }
 
-    void check_inflight_requests()
+    //  Write a complete event (span) from cycle begin to cycle end
+    void write_chrome_span(unsigned pid,
+                           unsigned tid,
+                           const std::string& name,
+                           uint64_t begin,
+                           uint64_t end,
+                           uint64_t addr,
+                           const char* args = "")
     {
+        if (!chrome_file_m.is_open()) return;
+
+        std::stringstream ss;
+        ss << "{\"name\": \"" << name << "\", \"ph\": \"X\", \"pid\": " << pid
+           << ", \"tid\": " << tid << ", \"ts\": " << begin << ", \"dur\": " << end - begin
+           << ", \"args\": {\"addr\": \"0x" << std::hex << addr << std::dec << "\"" << args
+           << "}}";
+        write_chrome_event(ss.str());
+    }
 
-        const bool no_inflight =
-            inflight_mem_write_m.empty() && inflight_mem_read_m.empty() && inflight_m.empty();
+    //  Write the variation of the counters since the previous sample. The
+    //  total nb of core requests allows to locate the sample in a trace
+    void write_perf_sample()
+    {
+        uint64_t v[NB_PERF_COUNTERS];
+        get_perf_counters(v);
+
+        const uint64_t cycles = nb_cycles - perf_last_cycle_m;
+        if (perf_json_m) {
+            perf_file_m << (perf_first_m ? "" : ",") << std::endl
+                        << "  {\"cycle\": " << nb_cycles << ", \"cycles\": " << cycles
+                        << ", \"core_req_total\": " << nb_core_req;
+            for (unsigned i = 0; i < NB_PERF_COUNTERS; i++) {
+                perf_file_m << ", \"" << perf_counter_name(i) << "\": " << v[i] - perf_last_m[i];
+            }
+            perf_file_m << "}";
+        } else {
+            perf_file_m << nb_cycles << "," << cycles << "," << nb_core_req;
+            for (unsigned i = 0; i < NB_PERF_COUNTERS; i++) {
+                perf_file_m << "," << v[i] - perf_last_m[i];
+            }
+            perf_file_m << std::endl;
+        }
 
-        no_inflight_requests_o.write(no_inflight);
+        for (unsigned i = 0; i < NB_PERF_COUNTERS; i++) perf_last_m[i] = v[i];
+        perf_last_cycle_m = nb_cycles;
+        perf_first_m = false;
     }
 
-    static uint64_t align_to(uint64_t val, uint64_t align) { return (val / align) * align; }
+    void check_inflight_requests() { no_inflight_requests_o.write(no_inflight()); }
 
-    bool check_verbosity(sc_core::sc_verbosity verbosity)
+    bool check_verbosity(sc_core::sc_verbosity verbosity) const
     {
         return (sc_core::sc_report_handler::get_verbosity_level() >= verbosity);
     }
 
-    void print_error(const std::string& msg)
+    //  Hooks of the checks (see hpdcache_test_scoreboard_base)
+    //  {{{
+    std::string timestamp() const override { return sc_time_stamp().to_string(); }
+
+#if DEBUG_HPDCACHE_TEST_SCOREBOARD
+    bool debug_enabled() const override { return check_verbosity(sc_core::SC_DEBUG); }
+#endif
+
+    const char* op_to_string(unsigned op) const override
+    {
+        return hpdcache_test_transaction_req::op_to_string(op);
+    }
+
+    uint64_t compute_amo(unsigned op,
+                         uint64_t ld_data,
+                         uint64_t st_data,
+                         unsigned bytes) const override
+    {
+        return hpdcache_test_amo::compute_amo(op, ld_data, st_data, bytes);
+    }
+
+    void on_core_resp(const inflight_entry_t& e) override
+    {
+        requester_stats_t& st = req_stats_m[e.sid];
+        st.nb_resp++;
+        st.latency.record(nb_cycles - e.time);
+        write_chrome_span(e.sid,
+                          e.tid,
+                          hpdcache_test_transaction_req::op_to_string(e.op),
+                          e.time,
+                          nb_cycles,
+                          e.addr,
+                          e.is_uncacheable ? ", \"class\": \"uncached\""
+                          : e.is_miss      ? ", \"class\": \"miss\""
+                                           : ", \"class\": \"hit\"");
+    }
+
+    void on_mem_read_done(unsigned id, const inflight_mem_entry_t& e) override
+    {
+        write_chrome_span(CHROME_PID_MEM_READ,
+                          id,
+                          e.is_uncacheable ? "read (uncached)" : "read",
+                          e.time,
+                          nb_cycles,
+                          e.addr);
+    }
+
+    void on_mem_write_done(unsigned id, const inflight_mem_entry_t& e) override
     {
-        std::cout << sc_time_stamp().to_string() << " / SB_ERROR: " << msg << std::endl;
+        write_chrome_span(CHROME_PID_MEM_WRITE,
+                          id,
+                          e.is_uncacheable ? "write (uncached)" : "write",
+                          e.time,
+                          nb_cycles,
+                          e.addr);
+    }
+    //  }}}
 
-        nb_error++;
-        if (sb_error_limit_m > 0 && (nb_error >= sb_error_limit_m)) {
-            std::cout << "SB_ERROR: number of errors exceeded the limit (" << sb_error_limit_m
-                      << ")" << std::endl;
+    void print_requester_stats(std::stringstream& ss)
+    {
+        unsigned nb_active = 0;
+        for (const auto& st : req_stats_m) {
+            if (st.nb_req > 0) nb_active++;
+        }
 
-            std::exit(1);
+        //  Only meaningful when several requesters are active
+        if (nb_active < 2) return;
+
+        ss << std::endl
+           << "Requesters" << std::endl
+           << "--------------------------------------------------" << std::endl
+           << "SID  REQUESTS  RESPONSES  REQ/CYCLE  AVG_LATENCY  P99_LATENCY  MAX_LATENCY"
+           << std::endl;
+        for (unsigned sid = 0; sid < NREQUESTERS; sid++) {
+            const requester_stats_t& st = req_stats_m[sid];
+            if (st.nb_req == 0) continue;
+
+            ss << std::setw(3) << sid << "  " << std::setw(8) << st.nb_req << "  "
+               << std::setw(9) << st.nb_resp << "  " << std::setw(9) << std::fixed
+               << std::setprecision(3)
+               << (nb_cycles_effective > 0 ? (double)st.nb_req / nb_cycles_effective : 0)
+               << "  " << std::setw(11) << std::setprecision(1) << st.latency.mean() << "  "
+               << std::setw(11) << st.latency.percentile(99) << "  " << std::setw(11)
+               << st.latency.max() << std::endl;
         }
+        ss << std::defaultfloat;
     }
 
-    void print_debug(const std::string& msg)
+    void write_latency_file()
     {
-        std::cout << sc_time_stamp().to_string() << " / SB_DEBUG: " << msg << std::endl;
+        std::ofstream f(latency_file_m);
+        if (!f) {
+            print_error("cannot create the latency file " + latency_file_m);
+            return;
+        }
+
+        f << "{" << std::endl << "  \"all\": ";
+        latency_all_m.to_json(f);
+        f << "," << std::endl << "  \"classes\": {";
+        const char* sep = "";
+        for (const auto& c : latency_class_m) {
+            f << sep << std::endl << "    \"" << c.first << "\": ";
+            c.second.to_json(f);
+            sep = ",";
+        }
+        f << std::endl << "  }," << std::endl << "  \"load_miss_fill\": ";
+        latency_fill_m.to_json(f);
+        f << "," << std::endl << "  \"requesters\": {";
+        sep = "";
+        for (unsigned sid = 0; sid < NREQUESTERS; sid++) {
+            if (req_stats_m[sid].latency.count() == 0) continue;
+            f << sep << std::endl << "    \"" << sid << "\": ";
+            req_stats_m[sid].latency.to_json(f);
+            sep = ",";
+        }
+        f << std::endl << "  }" << std::endl << "}" << std::endl;
+    }
+
+    //  Read a transaction from any of the FIFOs bound to a multi-port. FIFOs
+    //  are scanned in round-robin order to avoid starving any requester
+    template<typename T>
+    T read_any(sc_fifo_in<T>& port, unsigned& rr)
+    {
+        const int n = port.size();
+        T ret;
+
+        if (n == 1) return port->read();
+
+        for (;;) {
+            sc_event_or_list written;
+            for (int k = 0; k < n; k++) {
+                const int i = (rr + k) % n;
+                if (port[i]->nb_read(ret)) {
+                    rr = (i + 1) % n;
+                    return ret;
+                }
+                written |= port[i]->data_written_event();
+            }
+            wait(written);
+        }
+    }
+
+    void deallocate_id(unsigned sid, unsigned tid) override
+    {
+        if ((sid >= NREQUESTERS) || !seqs[sid]) {
+            std::stringstream ss;
+            ss << "no sequence associated to source ID " << sid;
+            print_error(ss.str());
+            return;
+        }
+        seqs[sid]->deallocate_id(tid);
     }
 
     void core_req_process()
     {
         hpdcache_test_transaction_req req;
         for (;;) {
-            req = core_req_i.read();
-            nb_core_req++;
+            req = read_any(core_req_i, core_req_rr_m);
 
             if (check_verbosity(sc_core::SC_MEDIUM)) {
                 std::cout << sc_time_stamp().to_string() << " / " << req << std::endl;
             }
 
-            //  count the number of requests that need a response
-            if (req.req_need_rsp) nb_core_req_need_rsp++;
+            const uint32_t req_sid = req.req_sid.to_uint();
+            const uint64_t req_addr = req.req_addr.to_uint64();
 
-            uint32_t req_id = req.req_tid.to_uint();
-            uint64_t req_addr = req.req_addr.to_uint64();
+            requester_stats_t& st = req_stats_m[req_sid];
+            if (st.nb_req == 0) st.first_cycle = nb_cycles;
+            st.last_cycle = nb_cycles;
+            st.nb_req++;
 
-            inflight_map_t::const_iterator it = inflight_m.find(req_id);
-            if (it != inflight_m.end()) {
-                std::stringstream ss;
-                ss << "core request ID "
-                   << "0x" << std::hex << req_id << std::dec << " matches an inflight request";
-                print_error(ss.str());
-                continue;
-            }
-
-            if (req.is_cmo()) {
 #if ENABLE_CACHE_DIR_VERIF
+            if (req.is_cmo()) {
                 switch (req.req_size.to_uint()) {
                     case hpdcache_test_transaction_req::HPDCACHE_CMO_INVAL_NLINE: {
                         cache_dir_m->inval(req_addr);
@@ -463,13 +595,8 @@ private:
                         break;
                     }
                 }
-#endif
-                if (!req.req_need_rsp) {
-                    //  release response ID on the sequence
-                    seq->deallocate_id(req_id);
-                    continue;
-                }
             }
+#endif
 
             bool hit = false;
 
@@ -484,8 +611,8 @@ private:
 #endif
 
             inflight_entry_t e;
-            e.time = nb_cycles;
-            e.tid = req_id;
+            e.sid = req_sid;
+            e.tid = req.req_tid.to_uint();
             e.addr = req_addr;
             e.need_rsp = req.req_need_rsp;
             e.hit = hit;
@@ -494,306 +621,31 @@ private:
             e.is_amo = req.is_amo();
             e.is_amo_lr = req.is_amo_lr();
             e.is_amo_sc = req.is_amo_sc();
+            e.is_cmo = req.is_cmo();
+            e.is_prefetch = req.is_cmo_prefetch();
             e.is_uncacheable = req.req_uncacheable;
-            e.is_error = false;
             e.bytes = 1 << req.req_size.to_uint();
             e.op = req.req_op.to_uint();
-            if (req.is_store() || req.is_amo_sc() || req.is_amo()) {
-                for (int i = 0; i < CORE_REQ_WORDS; i++) {
-                    e.wdata[i] =
-                        req.req_wdata
-                            .range((i + 1) * HPDCACHE_WORD_WIDTH - 1, i * HPDCACHE_WORD_WIDTH)
-                            .to_uint64();
-                    e.be[i] =
-                        req.req_be.range((i + 1) * CORE_REQ_WORD_BYTES - 1, i * CORE_REQ_WORD_BYTES)
-                            .to_uint();
-                }
-            }
-
-            //  Look for the request address into the error memory segments
-            if (mem_resp_model && (!req.is_cmo() || req.is_cmo_prefetch())) {
-                e.is_error = mem_resp_model->within_error_region(e.addr, e.addr + e.bytes);
-            }
-
-            uint64_t aligned_addr = align_to(req_addr, HPDCACHE_REQ_DATA_WIDTH / 8);
-            if (!e.is_error && (req.is_load() || req.is_amo_lr() || req.is_amo())) {
-                ram_m->read(reinterpret_cast<uint8_t*>(e.rdata),
-                            HPDCACHE_REQ_DATA_WIDTH / 8,
-                            aligned_addr,
-                            e.rv);
-
-#if DEBUG_HPDCACHE_TEST_SCOREBOARD
-                if (check_verbosity(sc_core::SC_DEBUG)) {
-                    for (int i = 0; i < CORE_REQ_WORDS; i++) {
-                        if (e.rv[i]) {
-                            std::stringstream ss;
-                            ss << "check response for @0x" << std::hex
-                               << aligned_addr + i * CORE_REQ_WORD_BYTES << std::dec
-                               << " / expected = 0x" << std::hex << e.rdata[i] << std::dec
-                               << " / valid = 0x" << std::hex << (unsigned)e.rv[i] << std::dec;
-
-                            print_debug(ss.str());
-                        }
-                    }
-                }
-#endif
-            }
-
-            //  Compute if the SC address matches the one of a previous LR reservation
-            if (req.is_amo_lr()) {
-                if (!e.is_error) {
-                    if (check_verbosity(sc_core::SC_DEBUG)) {
-                        print_debug("making LR reservation");
-                    }
-                    lrsc_buf_m.valid = true;
-                    lrsc_buf_m.base_addr = e.addr;
-                    lrsc_buf_m.end_addr = e.addr + 8;
-                    lrsc_buf_m.is_atomic = false; // initialization
-                } else {
-                    if (check_verbosity(sc_core::SC_DEBUG)) {
-                        print_debug("invalidating previous LR reservation");
-                    }
-                    lrsc_buf_m.valid = false;
-                }
-            }
-
-            //  Manage invalidation of the LR/SC reservation buffer
-            if (req.is_amo() || req.is_amo_sc() || req.is_store()) {
-                uint64_t lrsc_rsrv_nline;
-                uint64_t lrsc_rsrv_word;
-                uint64_t lrsc_entry_nline;
-                uint64_t lrsc_entry_words;
-                uint64_t lrsc_entry_base;
-                uint64_t lrsc_entry_end;
-                bool addr_match;
-
-                //  Compute if the address matches the one of a previous LR reservation
-                lrsc_rsrv_nline = get_nline(lrsc_buf_m.base_addr);
-                lrsc_rsrv_word = get_offset(lrsc_buf_m.base_addr) >> 3;
-                lrsc_entry_nline = get_nline(e.addr);
-                lrsc_entry_words = e.bytes < 8 ? 1 : e.bytes >> 3;
-                lrsc_entry_base = get_offset(e.addr) >> 3;
-                lrsc_entry_end = lrsc_entry_base + lrsc_entry_words;
-
-                addr_match = lrsc_buf_m.valid && (lrsc_rsrv_nline == lrsc_entry_nline)
-                             && (lrsc_rsrv_word >= lrsc_entry_base)
-                             && (lrsc_rsrv_word < lrsc_entry_end);
-
-                if (req.is_amo_sc()) {
-                    //  SC can get an error response only if there is a valid
-                    //  reservation, otherwise the response shall be SC_FAILURE (but
-                    //  without error)
-                    e.is_error = e.is_error && addr_match;
-
-                    //  If there is a previous reservation (previous LR) on the address
-                    //  accessed by a SC operation, then the access MAY be atomic. The
-                    //  scoreboard needs to wait for the acknowledgement from the memory to
-                    //  actually know the atomicity of the access.
-                    e.is_atomic = addr_match;
-                }
-
-                // Invalidate the active reservation (independently of the address match in
-                // case of SC because as specified in the RISC-V ISA, one condition to be
-                // fulfilled by a SC to succeed is that there is no other SC is between the LR
-                // and itself in program order).
-                if (addr_match || req.is_amo_sc()) {
-                    if (check_verbosity(sc_core::SC_DEBUG)) {
-                        print_debug("invalidate LR reservation");
-                    }
-                    lrsc_buf_m.valid = false;
-                }
-            }
-
-            if (req.is_amo() || req.is_amo_lr() || (req.is_amo_sc() && e.is_atomic)) {
-                if (check_verbosity(sc_core::SC_DEBUG)) {
-                    print_debug("atomic operation shall be forwarded to memory");
-                }
-                //  Share transaction information with the memory interface threads
-                if (!inflight_amo_req_m.nb_write(e)) {
-                    print_error("inflight AMO request fifo is full");
-                    continue;
-                }
-            }
-
-            //  keep track of written data
-            if (req.is_store() && !e.is_error) {
-                ram_m->write(reinterpret_cast<uint8_t*>(e.wdata),
-                             reinterpret_cast<uint8_t*>(e.be),
-                             HPDCACHE_REQ_DATA_WIDTH / 8,
-                             aligned_addr);
-
-#if DEBUG_HPDCACHE_TEST_SCOREBOARD
-                if (check_verbosity(sc_core::SC_DEBUG)) {
-                    for (int i = 0; i < CORE_REQ_WORDS; i++) {
-                        if (e.be[i]) {
-                            std::stringstream ss;
-                            ss << "store sb.mem @0x" << std::hex
-                               << aligned_addr + i * CORE_REQ_WORD_BYTES << std::dec << " = 0x"
-                               << std::hex << e.wdata[i] << std::dec << " / be = 0x" << std::hex
-                               << (unsigned)e.be[i] << std::dec;
-
-                            print_debug(ss.str());
-                        }
-                    }
-                }
-#endif
-            }
+            hpdcache_test_bv_to_bytes(req.req_wdata, e.wdata);
+            hpdcache_test_bv_to_bytes(req.req_be, e.be);
 
-            if (req.req_need_rsp) {
-                //  add new core request into the table of inflight requests
-                inflight_m.insert(inflight_map_pair_t(req_id, e));
-            } else {
-                //  deallocate the ID immediately for requests with no response
-                seq->deallocate_id(req_id);
-            }
+            check_core_req(e);
         }
     }
 
     void core_resp_process()
     {
         hpdcache_test_transaction_resp resp;
+        uint8_t rdata[CORE_REQ_BYTES];
         for (;;) {
-            resp = core_resp_i.read();
-            nb_core_resp++;
-
-            nb_cycles_effective = nb_cycles;
+            resp = read_any(core_resp_i, core_resp_rr_m);
 
             if (check_verbosity(sc_core::SC_MEDIUM)) {
                 std::cout << sc_time_stamp().to_string() << " / " << resp << std::endl;
             }
 
-            //  check if there is a matching request for the received response
-            inflight_map_t::const_iterator it = inflight_m.find(resp.rsp_tid.to_uint());
-            if (it == inflight_m.end()) {
-                std::stringstream ss;
-                ss << "core response ID "
-                   << "0x" << std::hex << resp.rsp_tid.to_uint() << std::dec
-                   << " does not match any inflight request";
-                print_error(ss.str());
-                continue;
-            }
-
-            const inflight_entry_t& e = it->second;
-
-#if DEBUG_HPDCACHE_TEST_SCOREBOARD
-            if (check_verbosity(sc_core::SC_DEBUG)) {
-                print_debug(e.to_string());
-            }
-#endif
-
-            if (!e.is_write && (resp.rsp_error != e.is_error)) {
-                print_error("unexpected value in the error flag of the response");
-                continue;
-            }
-
-            if (!e.is_error) {
-                const uint64_t aligned_addr = align_to(e.addr, CORE_REQ_BYTES);
-                const int _word = (e.addr / CORE_REQ_WORD_BYTES) % CORE_REQ_WORDS;
-                const int _byte = e.addr % CORE_REQ_BYTES;
-
-                //  check the response status for SC operations
-                bool sc_ok;
-                if (e.is_amo_sc) {
-                    uint64_t sc_resp = resp.rsp_rdata
-                                           .range((_word + 1) * HPDCACHE_WORD_WIDTH - 1,
-                                                  _word * HPDCACHE_WORD_WIDTH)
-                                           .to_uint64();
-                    if (e.bytes == 4) {
-                        sc_resp = (uint32_t)sc_resp;
-                    }
-
-                    sc_ok = e.is_atomic && sc_is_atomic;
-                    if (sc_ok) {
-                        ram_m->write(reinterpret_cast<const uint8_t*>(&e.wdata[_word]),
-                                     reinterpret_cast<const uint8_t*>(&e.be[_word]),
-                                     CORE_REQ_WORD_BYTES,
-                                     align_to(e.addr, CORE_REQ_WORD_BYTES));
-
-                        //  check response status
-                        if (sc_resp != 0) {
-                            print_error("response shall be SC_SUCCESS");
-                        }
-                    } else if (sc_resp != 1) {
-                        print_error("response shall be SC_FAILURE");
-                    }
-                }
-
-                //  check the response data
-                if (e.is_read || e.is_amo || e.is_amo_lr) {
-                    uint64_t rdata[CORE_REQ_WORDS];
-                    for (int i = 0; i < CORE_REQ_WORDS; i++) {
-                        rdata[i] =
-                            resp.rsp_rdata
-                                .range((i + 1) * HPDCACHE_WORD_WIDTH - 1, i * HPDCACHE_WORD_WIDTH)
-                                .to_uint64();
-                    }
-
-                    //  check the received data
-                    //  {{{
-                    for (int i = _byte; i < (_byte + e.bytes); i++) {
-                        const uint8_t recv = reinterpret_cast<const uint8_t*>(rdata)[i];
-                        const uint8_t expc = reinterpret_cast<const uint8_t*>(e.rdata)[i];
-                        const uint8_t rv =
-                            reinterpret_cast<const uint8_t*>(e.rv)[i / CORE_REQ_WORD_BYTES];
-
-                        if ((rv >> (i % CORE_REQ_WORD_BYTES)) & 0x1) {
-                            if (recv != expc) {
-                                std::stringstream ss;
-                                ss << "response data is wrong"
-                                   << " / @0x" << std::hex << aligned_addr + i << std::dec
-                                   << " / actual = 0x" << std::hex << (unsigned)recv << std::dec
-                                   << " / expected = 0x" << std::hex << (unsigned)expc << std::dec;
-                                print_error(ss.str());
-                            }
-                        }
-                    }
-                    //  }}}
-
-                    //  update the memory with the computed AMO word
-                    //  {{{
-                    if (e.is_amo) {
-                        unsigned offset = (e.addr % CORE_REQ_WORD_BYTES) * CORE_REQ_WORD_BYTES;
-                        uint64_t amo_new = e.wdata[_word];
-                        uint64_t amo_old = rdata[_word];
-
-                        if (e.bytes == 4) {
-                            amo_new = static_cast<uint32_t>(amo_new >> offset);
-                            amo_old = static_cast<uint32_t>(amo_old >> offset);
-                        }
-                        uint64_t amo_res =
-                            hpdcache_test_amo::compute_amo(e.op, amo_old, amo_new, e.bytes);
-                        uint8_t amo_be = e.be[_word];
-
-                        amo_res = (amo_res << offset);
-                        ram_m->write(reinterpret_cast<uint8_t*>(&amo_res),
-                                     reinterpret_cast<uint8_t*>(&amo_be),
-                                     CORE_REQ_WORD_BYTES,
-                                     align_to(e.addr, CORE_REQ_WORD_BYTES));
-
-#if DEBUG_HPDCACHE_TEST_SCOREBOARD
-                        if (check_verbosity(sc_core::SC_DEBUG)) {
-                            if (amo_be) {
-                                std::stringstream ss;
-                                ss << hpdcache_test_transaction_req::op_to_string(e.op)
-                                   << " sb.mem @0x" << std::hex
-                                   << align_to(e.addr, CORE_REQ_WORD_BYTES) << std::dec << " = 0x"
-                                   << std::hex << amo_res << std::dec << " / be = 0x" << std::hex
-                                   << (unsigned)amo_be << std::dec;
-
-                                print_debug(ss.str());
-                            }
-                        }
-#endif
-                    }
-                    //  }}}
-                }
-            }
-
-            //  remove request from the inflight table
-            inflight_m.erase(it);
-
-            //  release response ID on the sequence
-            seq->deallocate_id(resp.rsp_tid.to_uint());
+            hpdcache_test_bv_to_bytes(resp.rsp_rdata, rdata);
+            check_core_resp(resp.rsp_sid.to_uint(), resp.rsp_tid.to_uint(), resp.rsp_error, rdata);
         }
     }
 
@@ -802,93 +654,31 @@ private:
         hpdcache_test_transaction_mem_read_req req;
         for (;;) {
             req = mem_read_req_i.read();
-            nb_mem_read_req++;
 
             if (check_verbosity(sc_core::SC_MEDIUM)) {
                 std::cout << sc_time_stamp().to_string() << " / " << req << std::endl;
             }
 
-            uint32_t req_id = req.id;
-
-            inflight_mem_map_t::const_iterator it = inflight_mem_read_m.find(req_id);
-            if (it != inflight_mem_read_m.end()) {
-                std::stringstream ss;
-                ss << "memory read request ID "
-                   << "0x" << std::hex << req_id << std::dec << " matches an inflight request";
-                print_error(ss.str());
-                continue;
-            }
-
-            //  find the associated core request
-            const inflight_entry_t* core_req = nullptr;
-            for (const auto& cr : inflight_m) {
-                const inflight_entry_t& _cr = cr.second;
-                if (get_nline(_cr.addr) == get_nline(req.addr)) {
-                    //  get first occurrence
-                    if (core_req == nullptr) {
-                        core_req = &_cr;
-                        continue;
-                    }
-
-                    //  if multiple occurrences, get the oldest
-                    if (_cr.time < core_req->time) {
-                        core_req = &_cr;
-                    }
-                }
-            }
-
-            const uint64_t bytes = (1ULL << req.size);
-
-            //  add new memory read request into the table of inflight memory requests
-            inflight_mem_entry_t e;
-            e.addr = req.addr;
-            e.bytes = bytes;
-            e.is_uncacheable = !req.cacheable;
-            e.is_error = mem_resp_model->within_error_region(e.addr, e.addr + bytes);
-            e.core_req_ptr = core_req;
-
-            inflight_mem_read_m.insert(inflight_mem_map_pair_t(req_id, e));
-
-            if (req.is_ldex()) {
-                inflight_entry_t inflight_ret;
-                if (inflight_amo_req_m.num_available() > 1) {
-                    print_error("there shall be a single inflight atomic operation");
-                }
-                if (!inflight_amo_req_m.nb_read(inflight_ret)) {
-                    print_error("unexpected load-exclusive request");
-                    continue;
-                }
-            }
+            check_mem_read_req(req);
         }
     }
 
     void mem_read_resp_process()
     {
         hpdcache_test_transaction_mem_read_resp resp;
+        uint8_t data[MEM_BYTES];
         for (;;) {
             resp = mem_read_resp_i.read();
-            nb_mem_read_resp++;
 
             if (check_verbosity(sc_core::SC_MEDIUM)) {
                 std::cout << sc_time_stamp().to_string() << " / " << resp << std::endl;
             }
 
-            inflight_mem_map_t::const_iterator it = inflight_mem_read_m.find(resp.id);
-            if (it == inflight_mem_read_m.end()) {
-                std::stringstream ss;
-                ss << "memory read response ID "
-                   << "0x" << std::hex << resp.id << std::dec
-                   << " does not match any inflight request";
-                print_error(ss.str());
-                continue;
-            }
-
-            //  get a pointer to the originating core request
-            const inflight_mem_entry_t* mem_req = &it->second;
-            const inflight_entry_t* core_req = mem_req->core_req_ptr;
-
 #if ENABLE_CACHE_DIR_VERIF
-            if (!mem_req->is_uncacheable) {
+            inflight_mem_map_t::iterator it = inflight_mem_read_m.find(resp.id);
+            inflight_mem_entry_t* mem_req =
+                (it != inflight_mem_read_m.end()) ? &it->second : nullptr;
+            if (mem_req && !mem_req->is_uncacheable) {
                 bool hit = cache_dir_m->hit(mem_req->addr, nullptr, nullptr);
                 if (hit) {
                     print_error("memory read miss response while there is a corresponding line in "
@@ -937,61 +727,9 @@ private:
 #endif
             }
 #endif
-            if (!resp.error) {
-                const int MEM_WORDS = HPDCACHE_MEM_DATA_WIDTH / 64;
-                const int MEM_BYTES = HPDCACHE_MEM_DATA_WIDTH / 8;
-                const uint64_t aligned_addr = align_to(mem_req->addr, MEM_BYTES);
-                const int _word = (mem_req->addr / MEM_BYTES) % MEM_WORDS;
-                const int _byte = mem_req->addr % MEM_BYTES;
-
-                //  update uninitialized bytes of the scoreboard memory with the
-                //  response from the external memory
-                //  {{{
-                uint64_t rdata[MEM_WORDS];
-                for (int i = 0; i < MEM_WORDS; i++) {
-                    rdata[i] = resp.data.range((i + 1) * 64 - 1, i * 64).to_uint64();
-                }
-
-                uint8_t unset[MEM_WORDS];
-                memset(unset, 0, sizeof(unset));
-                for (int i = 0; i < MEM_BYTES; i++) {
-                    unset[i / 8] |= (ram_m->getBmap(aligned_addr + i) ? 0x0 : 0x1) << (i % 8);
-                }
-
-                uint8_t be[MEM_WORDS];
-                int bytes = mem_req->bytes;
-                memset(be, 0, sizeof(be));
-                for (int i = _word; bytes > 0; i++) {
-                    uint8_t mask = static_cast<uint8_t>(((1UL << bytes) - 1) << (_byte - i * 8));
-                    be[i] = mask & unset[i];
-                    bytes -= 8;
-                }
-
-                ram_m->write(reinterpret_cast<uint8_t*>(rdata),
-                             reinterpret_cast<uint8_t*>(be),
-                             MEM_BYTES,
-                             aligned_addr);
 
-#if DEBUG_HPDCACHE_TEST_SCOREBOARD
-                if (check_verbosity(sc_core::SC_DEBUG)) {
-                    for (int i = 0; i < MEM_WORDS; i++) {
-                        if (be[i]) {
-                            std::stringstream ss;
-                            ss << "update sb.mem @0x" << std::hex << aligned_addr + i * 8
-                               << std::dec << " = 0x" << std::hex << rdata[i] << std::dec
-                               << " / be = 0x" << std::hex << (unsigned)be[i] << std::dec;
-                            print_debug(ss.str());
-                        }
-                    }
-                }
-#endif
-                //  }}}
-            }
-
-            //  remove request from the inflight table
-            if (resp.last) {
-                inflight_mem_read_m.erase(it);
-            }
+            hpdcache_test_bv_to_bytes(resp.data, data);
+            check_mem_read_resp(resp.id, resp.error, resp.last, data);
         }
     }
 
@@ -1000,84 +738,12 @@ private:
         hpdcache_test_transaction_mem_write_req req;
         for (;;) {
             req = mem_write_req_i.read();
-            nb_mem_write_req++;
 
             if (check_verbosity(sc_core::SC_MEDIUM)) {
                 std::cout << sc_time_stamp().to_string() << " / " << req << std::endl;
             }
 
-            uint32_t req_id = req.id;
-            uint64_t bytes = (1ULL << req.size);
-
-            inflight_mem_map_t::const_iterator it = inflight_mem_write_m.find(req_id);
-            if (it != inflight_mem_write_m.end()) {
-                std::stringstream ss;
-                ss << "memory write request ID "
-                   << "0x" << std::hex << req_id << std::dec << " matches an inflight request";
-                print_error(ss.str());
-                continue;
-            }
-
-            //  find the associated core request
-            const inflight_entry_t* core_req = nullptr;
-            for (const auto& cr : inflight_m) {
-                const inflight_entry_t& _cr = cr.second;
-                if (get_nline(_cr.addr) == get_nline(req.addr)) {
-                    //  get first occurrence
-                    if (core_req == nullptr) {
-                        core_req = &_cr;
-                        continue;
-                    }
-
-                    //  if multiple occurrences, get the oldest
-                    if (_cr.time < core_req->time) {
-                        core_req = &_cr;
-                    }
-                }
-            }
-
-            //  add new memory write request into the table of inflight memory requests
-            inflight_mem_entry_t e;
-            e.addr = req.addr;
-            e.bytes = bytes;
-            e.is_uncacheable = !req.cacheable;
-            e.is_error = mem_resp_model->within_error_region(e.addr, e.addr + bytes);
-            e.core_req_ptr = core_req;
-
-            inflight_mem_write_m.insert(inflight_mem_map_pair_t(req_id, e));
-
-            if (req.is_amo()) {
-                inflight_entry_t inflight_ret;
-                if (inflight_amo_req_m.num_available() > 1) {
-                    print_error("there shall be a single inflight atomic operation");
-                }
-                if (!inflight_amo_req_m.nb_read(inflight_ret)) {
-                    print_error("unexpected AMO request");
-                    continue;
-                }
-                if (core_req == nullptr) {
-                    print_error("memory AMO request with no associated core request");
-                }
-                inflight_mem_read_m.insert(inflight_mem_map_pair_t(req_id, e));
-            }
-
-            if (req.is_stex()) {
-                inflight_entry_t inflight_ret;
-                if (inflight_amo_req_m.num_available() > 1) {
-                    print_error("there shall be a single inflight atomic operation");
-                }
-                if (!inflight_amo_req_m.nb_read(inflight_ret)) {
-                    print_error("unexpected store-exclusive request");
-                    continue;
-                }
-                if (!inflight_ret.is_atomic) {
-                    print_error("store exclusive access with no valid reservation");
-                    continue;
-                }
-                if (core_req == nullptr) {
-                    print_error("memory store-conditional request with no associated core request");
-                }
-            }
+            check_mem_write_req(req);
         }
     }
 
@@ -1086,26 +752,12 @@ private:
         hpdcache_test_transaction_mem_write_resp resp;
         for (;;) {
             resp = mem_write_resp_i.read();
-            nb_mem_write_resp++;
 
             if (check_verbosity(sc_core::SC_MEDIUM)) {
                 std::cout << sc_time_stamp().to_string() << " / " << resp << std::endl;
             }
 
-            inflight_mem_map_t::const_iterator it = inflight_mem_write_m.find(resp.id);
-            if (it == inflight_mem_write_m.end()) {
-                std::stringstream ss;
-                ss << "memory write response ID "
-                   << "0x" << std::hex << resp.id << std::dec
-                   << " does not match any inflight request";
-                print_error(ss.str());
-                continue;
-            }
-
-            sc_is_atomic = resp.is_atomic;
-
-            //  remove request from the inflight table
-            inflight_mem_write_m.erase(it);
+            check_mem_write_resp(resp.id, resp.is_atomic);
         }
     }
 };
@@ -0,0 +1,1028 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Checks of the scoreboard of the HPDCACHE testbench. It does not
+ *               depend on SystemC, and it is shared by the scoreboards of the
+ *               SystemC (hpdcache_test_scoreboard.h) and of the cc
+ *               (hpdcache_test_cc_scoreboard.h) testbenches. These convert the
+ *               transactions of their harness and call the check_* methods
+ */
+#ifndef __HPDCACHE_TEST_SCOREBOARD_BASE_H__
+#define __HPDCACHE_TEST_SCOREBOARD_BASE_H__
+
+#include "hpdcache_test_defs.h"
+#include "hpdcache_test_latency.h"
+#include "hpdcache_test_mem_func_model.h"
+#include "ram_model.h"
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class hpdcache_test_scoreboard_base
+{
+public:
+    hpdcache_test_scoreboard_base()
+      : nb_cycles(0)
+      , nb_cycles_effective(0)
+      , nb_core_req(0)
+      , nb_core_req_need_rsp(0)
+      , nb_core_resp(0)
+      , nb_mem_read_req(0)
+      , nb_mem_read_resp(0)
+      , nb_mem_write_req(0)
+      , nb_mem_write_resp(0)
+      , nb_miss_compulsory(0)
+      , nb_miss_capacity(0)
+      , nb_miss_conflict(0)
+      , nb_error(0)
+      , sb_error_limit_m(0)
+      , evt_cache_write_miss(0)
+      , evt_cache_read_miss(0)
+      , evt_cache_dir_unc_err(0)
+      , evt_cache_dir_cor_err(0)
+      , evt_cache_dat_unc_err(0)
+      , evt_cache_dat_cor_err(0)
+      , evt_scrub_complete(0)
+      , evt_uncached_req(0)
+      , evt_cmo_req(0)
+      , evt_write_req(0)
+      , evt_read_req(0)
+      , evt_prefetch_req(0)
+      , evt_req_on_hold(0)
+      , evt_rtab_rollback(0)
+      , evt_stall_refill(0)
+      , evt_stall(0)
+      , mem_model_m(nullptr)
+      , sc_is_atomic(false)
+      , ram_m(std::make_shared<ram_t>("ram"))
+    {
+        memset(&lrsc_buf_m, 0, sizeof(lrsc_buf_m));
+    }
+
+    virtual ~hpdcache_test_scoreboard_base() {}
+
+    void set_error_limit(size_t error_limit) { sb_error_limit_m = error_limit; }
+
+    size_t get_nb_error() const { return nb_error; }
+
+    //  Function called on each error (e.g. to dump the recorded waveforms)
+    void set_error_handler(std::function<void()> f) { error_handler_m = f; }
+
+    bool no_inflight() const
+    {
+        return inflight_mem_write_m.empty() && inflight_mem_read_m.empty() && inflight_m.empty();
+    }
+
+    //  Save (restore) the shadow memory, the LR/SC reservation and the shadow
+    //  caches of the miss classification in (from) a checkpoint. There shall
+    //  be no inflight transaction. The statistics are not saved: they only
+    //  cover the simulation after the restore
+    void save_state(std::ostream& os) const
+    {
+        ram_m->saveState(os);
+        os.write(reinterpret_cast<const char*>(&lrsc_buf_m), sizeof(lrsc_buf_m));
+
+        const uint64_t nb_seen = shadow_seen_m.size();
+        os.write(reinterpret_cast<const char*>(&nb_seen), sizeof(nb_seen));
+        for (uint64_t nline : shadow_seen_m) {
+            os.write(reinterpret_cast<const char*>(&nline), sizeof(nline));
+        }
+
+        //  most recently used first
+        const uint64_t nb_lru = shadow_lru_m.size();
+        os.write(reinterpret_cast<const char*>(&nb_lru), sizeof(nb_lru));
+        for (uint64_t nline : shadow_lru_m) {
+            os.write(reinterpret_cast<const char*>(&nline), sizeof(nline));
+        }
+    }
+
+    bool restore_state(std::istream& is)
+    {
+        uint64_t n = 0, nline = 0;
+
+        if (!ram_m->restoreState(is)) return false;
+        is.read(reinterpret_cast<char*>(&lrsc_buf_m), sizeof(lrsc_buf_m));
+
+        shadow_seen_m.clear();
+        is.read(reinterpret_cast<char*>(&n), sizeof(n));
+        for (uint64_t i = 0; (i < n) && is; i++) {
+            is.read(reinterpret_cast<char*>(&nline), sizeof(nline));
+            shadow_seen_m.insert(nline);
+        }
+
+        shadow_lru_m.clear();
+        shadow_fa_m.clear();
+        is.read(reinterpret_cast<char*>(&n), sizeof(n));
+        for (uint64_t i = 0; (i < n) && is; i++) {
+            is.read(reinterpret_cast<char*>(&nline), sizeof(nline));
+            shadow_fa_m[nline] = shadow_lru_m.insert(shadow_lru_m.end(), nline);
+        }
+        return bool(is);
+    }
+
+protected:
+    static constexpr unsigned CORE_REQ_WORDS = HPDCACHE_REQ_WORDS;
+    static constexpr unsigned CORE_REQ_WORD_BYTES = HPDCACHE_WORD_WIDTH / 8;
+    static constexpr unsigned CORE_REQ_BYTES = CORE_REQ_WORDS * CORE_REQ_WORD_BYTES;
+    static constexpr unsigned MEM_WORDS = HPDCACHE_MEM_DATA_WIDTH / 64;
+    static constexpr unsigned MEM_BYTES = HPDCACHE_MEM_DATA_WIDTH / 8;
+
+    //  Depth of the queue of the atomic operations forwarded to the memory
+    static constexpr size_t AMO_FIFO_DEPTH = 16;
+
+    //  Core request. The data, the byte enable and the valid bits of the
+    //  expected data are arrays of bytes (little-endian) with one bit of byte
+    //  enable (valid) per byte
+    struct inflight_entry_t
+    {
+        uint64_t time;
+        uint32_t sid;
+        uint32_t tid;
+        uint64_t addr;
+        bool need_rsp;
+        bool hit;
+        bool is_read;
+        bool is_write;
+        bool is_amo;
+        bool is_amo_sc;
+        bool is_amo_lr;
+        bool is_atomic;
+        bool is_cmo;
+        bool is_prefetch;
+        bool is_error;
+        bool is_miss;
+        uint64_t refill_time;
+        unsigned op;
+        bool is_uncacheable;
+        unsigned bytes;
+        uint8_t wdata[CORE_REQ_BYTES];
+        uint8_t be[CORE_REQ_BYTES / 8];
+        uint8_t rdata[CORE_REQ_BYTES];
+        uint8_t rv[CORE_REQ_BYTES / 8];
+    };
+
+    struct inflight_mem_entry_t
+    {
+        uint64_t time;
+        uint64_t addr;
+        uint32_t bytes;
+        uint32_t burst_bytes;
+        uint32_t beats;
+        bool is_wrap;
+        bool is_uncacheable;
+        bool is_error;
+        const inflight_entry_t* core_req_ptr;
+    };
+
+    struct lrsc_reservation_buf_t
+    {
+        bool valid;
+        uint64_t base_addr;
+        uint64_t end_addr;
+        bool is_atomic;
+    };
+
+    typedef std::map<uint32_t, inflight_entry_t> inflight_map_t;
+    typedef std::map<uint64_t, inflight_mem_entry_t> inflight_mem_map_t;
+    typedef ram_model ram_t;
+
+    uint64_t nb_cycles;
+    uint64_t nb_cycles_effective;
+    uint64_t nb_core_req;
+    uint64_t nb_core_req_need_rsp;
+    uint64_t nb_core_resp;
+    uint64_t nb_mem_read_req;
+    uint64_t nb_mem_read_resp;
+    uint64_t nb_mem_write_req;
+    uint64_t nb_mem_write_resp;
+    uint64_t nb_miss_compulsory;
+    uint64_t nb_miss_capacity;
+    uint64_t nb_miss_conflict;
+
+    size_t nb_error;
+    size_t sb_error_limit_m;
+    std::function<void()> error_handler_m;
+
+    uint64_t evt_cache_write_miss;
+    uint64_t evt_cache_read_miss;
+    uint64_t evt_cache_dir_unc_err;
+    uint64_t evt_cache_dir_cor_err;
+    uint64_t evt_cache_dat_unc_err;
+    uint64_t evt_cache_dat_cor_err;
+    uint64_t evt_scrub_complete;
+    uint64_t evt_uncached_req;
+    uint64_t evt_cmo_req;
+    uint64_t evt_write_req;
+    uint64_t evt_read_req;
+    uint64_t evt_prefetch_req;
+    uint64_t evt_req_on_hold;
+    uint64_t evt_rtab_rollback;
+    uint64_t evt_stall_refill;
+    uint64_t evt_stall;
+
+    //  Memory model giving the error segments (optional)
+    const hpdcache_test_mem_func_model* mem_model_m;
+
+    //  Latency of the responded requests: all of them, and broken down by
+    //  class (operation, hit/miss and cacheability, see latency_class())
+    hpdcache_test_latency latency_all_m;
+    std::map<std::string, hpdcache_test_latency> latency_class_m;
+
+    //  Latency of the load misses from the first beat of the refill of their
+    //  cacheline to their response (shorter with critical-word-first refills)
+    hpdcache_test_latency latency_fill_m;
+
+    //  Shadow caches used to classify the misses (refills) of the HPDcache: an
+    //  infinite cache (set of the cachelines refilled at least once) and a
+    //  fully-associative LRU cache with the same capacity as the HPDcache. The
+    //  LRU order is a list (most recently used first) indexed by cacheline
+    static constexpr size_t SHADOW_FA_LINES = HPDCACHE_SETS * HPDCACHE_WAYS;
+    typedef std::list<uint64_t> shadow_lru_t;
+    std::unordered_set<uint64_t> shadow_seen_m;
+    shadow_lru_t shadow_lru_m;
+    std::unordered_map<uint64_t, shadow_lru_t::iterator> shadow_fa_m;
+
+    inflight_map_t inflight_m;
+    inflight_mem_map_t inflight_mem_read_m;
+    inflight_mem_map_t inflight_mem_write_m;
+    lrsc_reservation_buf_t lrsc_buf_m;
+    std::deque<inflight_entry_t> inflight_amo_req_m;
+    bool sc_is_atomic;
+    std::shared_ptr<ram_t> ram_m;
+
+    //  Hooks of the harness
+    //  {{{
+    //  Prefix of the messages (current time)
+    virtual std::string timestamp() const = 0;
+
+    virtual bool debug_enabled() const { return false; }
+
+    virtual const char* op_to_string(unsigned op) const = 0;
+
+    //  Result of an AMO of the core (operation of the core request)
+    virtual uint64_t compute_amo(unsigned op,
+                                 uint64_t ld_data,
+                                 uint64_t st_data,
+                                 unsigned bytes) const = 0;
+
+    //  Release a transaction ID on the sequence of the requester
+    virtual void deallocate_id(unsigned sid, unsigned tid) = 0;
+
+    //  Called on each response matching an inflight request, and once each
+    //  memory transaction is completed
+    virtual void on_core_resp(const inflight_entry_t&) {}
+    virtual void on_mem_read_done(unsigned, const inflight_mem_entry_t&) {}
+    virtual void on_mem_write_done(unsigned, const inflight_mem_entry_t&) {}
+    //  }}}
+
+    static uint32_t get_inflight_key(uint32_t sid, uint32_t tid)
+    {
+        //  Requests from different requesters may use the same transaction ID.
+        //  Inflight requests are thus identified by the pair (SID, TID)
+        return (sid << HPDCACHE_REQ_TRANS_ID_WIDTH) | tid;
+    }
+
+    static uint64_t get_nline(uint64_t addr) { return addr >> HPDCACHE_CL_OFFSET_WIDTH; }
+
+    static uint64_t get_offset(uint64_t addr)
+    {
+        return addr & ((1ULL << HPDCACHE_CL_OFFSET_WIDTH) - 1);
+    }
+
+    static uint64_t align_to(uint64_t val, uint64_t align) { return (val / align) * align; }
+
+    static uint64_t load_word(const uint8_t* buf)
+    {
+        uint64_t ret;
+        memcpy(&ret, buf, 8);
+        return ret;
+    }
+
+    static bool get_bit(const uint8_t* bmap, unsigned i) { return (bmap[i / 8] >> (i % 8)) & 1; }
+
+    const std::string entry_to_string(const inflight_entry_t& e) const
+    {
+        std::stringstream ss;
+        ss << "@0x" << std::hex << e.addr << std::dec << (e.hit ? " / hit" : " / miss")
+           << (e.is_read     ? " / read"
+               : e.is_write  ? " / write"
+               : e.is_amo    ? " / amo"
+               : e.is_amo_sc ? " / sc"
+               : e.is_amo_lr ? " / lr"
+                             : "")
+           << " / " << op_to_string(e.op) << (e.is_uncacheable ? " / uncacheable" : "")
+           << " / bytes = " << e.bytes;
+        return ss.str();
+    }
+
+    //  Core request. The harness fills the sid, tid, addr, need_rsp, hit, op,
+    //  bytes, is_uncacheable, wdata and be fields, and the type of the request
+    //  (is_read to is_prefetch)
+    void check_core_req(inflight_entry_t e)
+    {
+        nb_core_req++;
+
+        //  count the number of requests that need a response
+        if (e.need_rsp) nb_core_req_need_rsp++;
+
+        const uint32_t req_key = get_inflight_key(e.sid, e.tid);
+        if (inflight_m.find(req_key) != inflight_m.end()) {
+            std::stringstream ss;
+            ss << "core request ID "
+               << "0x" << std::hex << e.tid << std::dec << " (sid = " << e.sid << ")"
+               << " matches an inflight request";
+            print_error(ss.str());
+            return;
+        }
+
+        if (e.is_cmo && !e.need_rsp) {
+            //  release response ID on the sequence
+            deallocate_id(e.sid, e.tid);
+            return;
+        }
+
+        if ((e.is_read || e.is_write || e.is_amo || e.is_amo_lr || e.is_amo_sc)
+            && !e.is_uncacheable) {
+            shadow_access(e.addr);
+        }
+
+        e.time = nb_cycles;
+        e.is_atomic = false;
+        e.is_error = false;
+        e.is_miss = !e.is_uncacheable && refill_pending(e.addr);
+        e.refill_time = 0;
+        memset(e.rdata, 0, sizeof(e.rdata));
+        memset(e.rv, 0, sizeof(e.rv));
+        if (!e.is_write && !e.is_amo_sc && !e.is_amo) {
+            memset(e.wdata, 0, sizeof(e.wdata));
+            memset(e.be, 0, sizeof(e.be));
+        }
+
+        //  Look for the request address into the error memory segments
+        if (mem_model_m && (!e.is_cmo || e.is_prefetch)) {
+            e.is_error = mem_model_m->within_error_region(e.addr, e.addr + e.bytes);
+        }
+
+        const uint64_t aligned_addr = align_to(e.addr, CORE_REQ_BYTES);
+        if (!e.is_error && (e.is_read || e.is_amo_lr || e.is_amo)) {
+            ram_m->read(e.rdata, CORE_REQ_BYTES, aligned_addr, e.rv);
+
+            if (debug_enabled()) {
+                for (unsigned i = 0; i < CORE_REQ_WORDS; i++) {
+                    if (e.rv[i]) {
+                        std::stringstream ss;
+                        ss << "check response for @0x" << std::hex
+                           << aligned_addr + i * CORE_REQ_WORD_BYTES << std::dec
+                           << " / expected = 0x" << std::hex
+                           << load_word(e.rdata + i * CORE_REQ_WORD_BYTES) << std::dec
+                           << " / valid = 0x" << std::hex << (unsigned)e.rv[i] << std::dec;
+                        print_debug(ss.str());
+                    }
+                }
+            }
+        }
+
+        //  Make (or invalidate) the LR reservation
+        if (e.is_amo_lr) {
+            if (!e.is_error) {
+                if (debug_enabled()) print_debug("making LR reservation");
+                lrsc_buf_m.valid = true;
+                lrsc_buf_m.base_addr = e.addr;
+                lrsc_buf_m.end_addr = e.addr + 8;
+                lrsc_buf_m.is_atomic = false;
+            } else {
+                if (debug_enabled()) print_debug("invalidating previous LR reservation");
+                lrsc_buf_m.valid = false;
+            }
+        }
+
+        //  Manage invalidation of the LR/SC reservation buffer
+        if (e.is_amo || e.is_amo_sc || e.is_write) {
+            const uint64_t rsrv_word = get_offset(lrsc_buf_m.base_addr) >> 3;
+            const uint64_t entry_words = e.bytes < 8 ? 1 : e.bytes >> 3;
+            const uint64_t entry_base = get_offset(e.addr) >> 3;
+            const bool addr_match = lrsc_buf_m.valid
+                                    && (get_nline(lrsc_buf_m.base_addr) == get_nline(e.addr))
+                                    && (rsrv_word >= entry_base)
+                                    && (rsrv_word < entry_base + entry_words);
+
+            if (e.is_amo_sc) {
+                //  SC can get an error response only if there is a valid
+                //  reservation, otherwise the response shall be SC_FAILURE (but
+                //  without error)
+                e.is_error = e.is_error && addr_match;
+
+                //  If there is a previous reservation (previous LR) on the
+                //  address accessed by a SC operation, then the access MAY be
+                //  atomic. The scoreboard needs to wait for the acknowledgement
+                //  from the memory to actually know the atomicity of the access
+                e.is_atomic = addr_match;
+            }
+
+            //  Invalidate the active reservation (independently of the address
+            //  match in case of SC because as specified in the RISC-V ISA, one
+            //  condition to be fulfilled by a SC to succeed is that there is no
+            //  other SC is between the LR and itself in program order)
+            if (addr_match || e.is_amo_sc) {
+                if (debug_enabled()) print_debug("invalidate LR reservation");
+                lrsc_buf_m.valid = false;
+            }
+        }
+
+        if (e.is_amo || e.is_amo_lr || (e.is_amo_sc && e.is_atomic)) {
+            if (debug_enabled()) print_debug("atomic operation shall be forwarded to memory");
+
+            //  Share transaction information with the memory interface
+            if (inflight_amo_req_m.size() >= AMO_FIFO_DEPTH) {
+                print_error("inflight AMO request fifo is full");
+                return;
+            }
+            inflight_amo_req_m.push_back(e);
+        }
+
+        //  keep track of written data
+        if (e.is_write && !e.is_error) {
+            ram_m->write(e.wdata, e.be, CORE_REQ_BYTES, aligned_addr);
+
+            if (debug_enabled()) {
+                for (unsigned i = 0; i < CORE_REQ_WORDS; i++) {
+                    if (e.be[i]) {
+                        std::stringstream ss;
+                        ss << "store sb.mem @0x" << std::hex
+                           << aligned_addr + i * CORE_REQ_WORD_BYTES << std::dec << " = 0x"
+                           << std::hex << load_word(e.wdata + i * CORE_REQ_WORD_BYTES)
+                           << std::dec << " / be = 0x" << std::hex << (unsigned)e.be[i]
+                           << std::dec;
+                        print_debug(ss.str());
+                    }
+                }
+            }
+        }
+
+        if (e.need_rsp) {
+            //  add new core request into the table of inflight requests
+            inflight_m.insert(std::make_pair(req_key, e));
+        } else {
+            //  deallocate the ID immediately for requests with no response
+            deallocate_id(e.sid, e.tid);
+        }
+    }
+
+    //  Core response, with the CORE_REQ_BYTES bytes of its data
+    void check_core_resp(unsigned sid, unsigned tid, bool error, const uint8_t* rdata)
+    {
+        nb_core_resp++;
+        nb_cycles_effective = nb_cycles;
+
+        //  check if there is a matching request for the received response
+        inflight_map_t::iterator it = inflight_m.find(get_inflight_key(sid, tid));
+        if (it == inflight_m.end()) {
+            std::stringstream ss;
+            ss << "core response ID "
+               << "0x" << std::hex << tid << std::dec << " (sid = " << sid << ")"
+               << " does not match any inflight request";
+            print_error(ss.str());
+            return;
+        }
+
+        const inflight_entry_t& e = it->second;
+
+        const uint64_t latency = nb_cycles - e.time;
+        latency_all_m.record(latency);
+        latency_class_m[latency_class(e)].record(latency);
+        if (e.is_read && e.is_miss && (e.refill_time > 0)) {
+            latency_fill_m.record(nb_cycles - e.refill_time);
+        }
+        on_core_resp(e);
+
+        if (debug_enabled()) print_debug(entry_to_string(e));
+
+        if (!e.is_write && (error != e.is_error)) {
+            print_error("unexpected value in the error flag of the response");
+            return;
+        }
+
+        if (!e.is_error) {
+            const uint64_t aligned_addr = align_to(e.addr, CORE_REQ_BYTES);
+            const uint64_t word_addr = align_to(e.addr, CORE_REQ_WORD_BYTES);
+            const unsigned word = (e.addr / CORE_REQ_WORD_BYTES) % CORE_REQ_WORDS;
+            const unsigned byte = e.addr % CORE_REQ_BYTES;
+
+            //  check the response status for SC operations
+            if (e.is_amo_sc) {
+                uint64_t sc_resp = load_word(rdata + word * CORE_REQ_WORD_BYTES);
+                if (e.bytes == 4) sc_resp = (uint32_t)sc_resp;
+
+                if (e.is_atomic && sc_is_atomic) {
+                    ram_m->write(e.wdata + word * CORE_REQ_WORD_BYTES,
+                                 e.be + word,
+                                 CORE_REQ_WORD_BYTES,
+                                 word_addr);
+                    if (sc_resp != 0) print_error("response shall be SC_SUCCESS");
+                } else if (sc_resp != 1) {
+                    print_error("response shall be SC_FAILURE");
+                }
+            }
+
+            //  check the response data
+            if (e.is_read || e.is_amo || e.is_amo_lr) {
+                for (unsigned i = byte; i < (byte + e.bytes); i++) {
+                    if (!get_bit(e.rv, i)) continue;
+                    if (rdata[i] != e.rdata[i]) {
+                        std::stringstream ss;
+                        ss << "response data is wrong"
+                           << " / @0x" << std::hex << aligned_addr + i << std::dec
+                           << " / actual = 0x" << std::hex << (unsigned)rdata[i] << std::dec
+                           << " / expected = 0x" << std::hex << (unsigned)e.rdata[i] << std::dec;
+                        print_error(ss.str());
+                    }
+                }
+
+                //  update the memory with the computed AMO word
+                if (e.is_amo) {
+                    const unsigned offset = (e.addr % CORE_REQ_WORD_BYTES) * 8;
+                    uint64_t amo_new = load_word(e.wdata + word * CORE_REQ_WORD_BYTES);
+                    uint64_t amo_old = load_word(rdata + word * CORE_REQ_WORD_BYTES);
+
+                    if (e.bytes == 4) {
+                        amo_new = static_cast<uint32_t>(amo_new >> offset);
+                        amo_old = static_cast<uint32_t>(amo_old >> offset);
+                    }
+                    const uint64_t amo_res = compute_amo(e.op, amo_old, amo_new, e.bytes)
+                                             << offset;
+                    const uint8_t amo_be = e.be[word];
+                    ram_m->write(reinterpret_cast<const uint8_t*>(&amo_res),
+                                 &amo_be,
+                                 CORE_REQ_WORD_BYTES,
+                                 word_addr);
+
+                    if (debug_enabled() && amo_be) {
+                        std::stringstream ss;
+                        ss << op_to_string(e.op) << " sb.mem @0x" << std::hex << word_addr
+                           << std::dec << " = 0x" << std::hex << amo_res << std::dec
+                           << " / be = 0x" << std::hex << (unsigned)amo_be << std::dec;
+                        print_debug(ss.str());
+                    }
+                }
+            }
+        }
+
+        //  remove request from the inflight table, and release response ID on
+        //  the sequence
+        inflight_m.erase(it);
+        deallocate_id(sid, tid);
+    }
+
+    //  Memory read request. R is the memory request of the harness (see
+    //  hpdcache_test_mem_func_model)
+    template<typename R>
+    void check_mem_read_req(const R& req)
+    {
+        nb_mem_read_req++;
+
+        if (inflight_mem_read_m.find(req.id) != inflight_mem_read_m.end()) {
+            std::stringstream ss;
+            ss << "memory read request ID "
+               << "0x" << std::hex << req.id << std::dec << " matches an inflight request";
+            print_error(ss.str());
+            return;
+        }
+
+        //  find the associated core request. The cacheable requests to the
+        //  same cacheline wait for the refill: they are misses
+        const inflight_entry_t* core_req = nullptr;
+        for (auto& cr : inflight_m) {
+            inflight_entry_t& _cr = cr.second;
+            if (get_nline(_cr.addr) == get_nline(req.addr)) {
+                if (req.cacheable && !_cr.is_uncacheable) _cr.is_miss = true;
+
+                //  get the oldest occurrence
+                if ((core_req == nullptr) || (_cr.time < core_req->time)) core_req = &_cr;
+            }
+        }
+
+        if (req.cacheable) shadow_refill(req.addr);
+
+        //  AXI only allows wrapping bursts of 2, 4, 8 or 16 beats
+        const bool wrap_len = (req.len == 1) || (req.len == 3) || (req.len == 7) || (req.len == 15);
+        if (req.wrap && !wrap_len) {
+            std::stringstream ss;
+            ss << "wrapping memory read request ID "
+               << "0x" << std::hex << req.id << std::dec << " with an illegal length (len = "
+               << req.len << ")";
+            print_error(ss.str());
+        }
+
+        //  add new memory read request into the table of inflight memory
+        //  requests
+        const uint64_t bytes = (1ULL << req.size);
+        inflight_mem_read_m.insert(
+            std::make_pair(req.id, mem_entry(req, bytes, (req.len + 1) * bytes, core_req)));
+
+        if (req.is_ldex()) {
+            if (inflight_amo_req_m.size() > 1) {
+                print_error("there shall be a single inflight atomic operation");
+            }
+            if (inflight_amo_req_m.empty()) {
+                print_error("unexpected load-exclusive request");
+                return;
+            }
+            inflight_amo_req_m.pop_front();
+        }
+    }
+
+    //  Beat of a memory read response, with the MEM_BYTES bytes of its data
+    void check_mem_read_resp(unsigned id, bool error, bool last, const uint8_t* data)
+    {
+        nb_mem_read_resp++;
+
+        inflight_mem_map_t::iterator it = inflight_mem_read_m.find(id);
+        if (it == inflight_mem_read_m.end()) {
+            std::stringstream ss;
+            ss << "memory read response ID "
+               << "0x" << std::hex << id << std::dec << " does not match any inflight request";
+            print_error(ss.str());
+            return;
+        }
+
+        inflight_mem_entry_t& mem_req = it->second;
+
+        //  address of the beat
+        const uint64_t beat_addr = hpdcache_test_mem_func_model::beat_addr(
+            mem_req.addr, mem_req.burst_bytes, mem_req.bytes, mem_req.is_wrap, mem_req.beats);
+
+        //  the first beat of a refill starts the refill of the pending misses
+        if ((mem_req.beats++ == 0) && !mem_req.is_uncacheable) {
+            for (auto& cr : inflight_m) {
+                inflight_entry_t& _cr = cr.second;
+                if (_cr.is_miss && (_cr.refill_time == 0)
+                    && (get_nline(_cr.addr) == get_nline(mem_req.addr)))
+                {
+                    _cr.refill_time = nb_cycles;
+                }
+            }
+        }
+
+        if (!error) {
+            const uint64_t aligned_addr = align_to(beat_addr, MEM_BYTES);
+            const unsigned first = beat_addr % MEM_BYTES;
+            const unsigned last_byte = std::min<uint64_t>(first + mem_req.bytes, MEM_BYTES);
+
+            //  update uninitialized bytes of the scoreboard memory with the
+            //  response from the external memory
+            uint8_t set[MEM_BYTES / 8];
+            uint8_t be[MEM_BYTES / 8];
+            ram_m->getBmap(set, MEM_BYTES, aligned_addr);
+            memset(be, 0, sizeof(be));
+            for (unsigned i = first; i < last_byte; i++) {
+                if (!get_bit(set, i)) be[i / 8] |= (1 << (i % 8));
+            }
+            ram_m->write(data, be, MEM_BYTES, aligned_addr);
+
+            if (debug_enabled()) {
+                for (unsigned i = 0; i < MEM_WORDS; i++) {
+                    if (be[i]) {
+                        std::stringstream ss;
+                        ss << "update sb.mem @0x" << std::hex << aligned_addr + i * 8 << std::dec
+                           << " = 0x" << std::hex << load_word(data + i * 8) << std::dec
+                           << " / be = 0x" << std::hex << (unsigned)be[i] << std::dec;
+                        print_debug(ss.str());
+                    }
+                }
+            }
+        }
+
+        //  remove request from the inflight table
+        if (last) {
+            on_mem_read_done(id, mem_req);
+            inflight_mem_read_m.erase(it);
+        }
+    }
+
+    //  Memory write request. R is the memory request of the harness (see
+    //  hpdcache_test_mem_func_model)
+    template<typename R>
+    void check_mem_write_req(const R& req)
+    {
+        nb_mem_write_req++;
+
+        if (req.bad_last_flit >= 0) {
+            std::stringstream ss;
+            ss << "unexpected last flag on flit " << req.bad_last_flit
+               << " of the memory write request ID 0x" << std::hex << req.id << std::dec;
+            print_error(ss.str());
+        }
+
+        if (inflight_mem_write_m.find(req.id) != inflight_mem_write_m.end()) {
+            std::stringstream ss;
+            ss << "memory write request ID "
+               << "0x" << std::hex << req.id << std::dec << " matches an inflight request";
+            print_error(ss.str());
+            return;
+        }
+
+        //  find the associated core request
+        const inflight_entry_t* core_req = nullptr;
+        for (const auto& cr : inflight_m) {
+            const inflight_entry_t& _cr = cr.second;
+            if (get_nline(_cr.addr) == get_nline(req.addr)) {
+                //  get the oldest occurrence
+                if ((core_req == nullptr) || (_cr.time < core_req->time)) core_req = &_cr;
+            }
+        }
+
+        //  add new memory write request into the table of inflight memory
+        //  requests
+        const uint64_t bytes = uint64_t(req.len + 1) << req.size;
+        const inflight_mem_entry_t e = mem_entry(req, bytes, bytes, core_req);
+        inflight_mem_write_m.insert(std::make_pair(req.id, e));
+
+        if (req.is_amo()) {
+            if (inflight_amo_req_m.size() > 1) {
+                print_error("there shall be a single inflight atomic operation");
+            }
+            if (inflight_amo_req_m.empty()) {
+                print_error("unexpected AMO request");
+                return;
+            }
+            inflight_amo_req_m.pop_front();
+            if (core_req == nullptr) {
+                print_error("memory AMO request with no associated core request");
+            }
+            inflight_mem_read_m.insert(std::make_pair(req.id, e));
+        }
+
+        if (req.is_stex()) {
+            if (inflight_amo_req_m.size() > 1) {
+                print_error("there shall be a single inflight atomic operation");
+            }
+            if (inflight_amo_req_m.empty()) {
+                print_error("unexpected store-exclusive request");
+                return;
+            }
+            const bool is_atomic = inflight_amo_req_m.front().is_atomic;
+            inflight_amo_req_m.pop_front();
+            if (!is_atomic) {
+                print_error("store exclusive access with no valid reservation");
+                return;
+            }
+            if (core_req == nullptr) {
+                print_error("memory store-conditional request with no associated core request");
+            }
+        }
+    }
+
+    void check_mem_write_resp(unsigned id, bool is_atomic)
+    {
+        nb_mem_write_resp++;
+
+        inflight_mem_map_t::iterator it = inflight_mem_write_m.find(id);
+        if (it == inflight_mem_write_m.end()) {
+            std::stringstream ss;
+            ss << "memory write response ID "
+               << "0x" << std::hex << id << std::dec << " does not match any inflight request";
+            print_error(ss.str());
+            return;
+        }
+
+        sc_is_atomic = is_atomic;
+
+        //  remove request from the inflight table
+        on_mem_write_done(id, it->second);
+        inflight_mem_write_m.erase(it);
+    }
+
+    //  Checks at the end of the simulation
+    void check_end()
+    {
+        std::stringstream ss;
+        if (nb_core_resp != nb_core_req_need_rsp) {
+            ss.str("");
+            ss << "number of responses (" << nb_core_resp
+               << ") is different than the number of requests (" << nb_core_req_need_rsp << ")";
+            print_error(ss.str());
+        }
+        if (evt_cache_write_miss > evt_write_req) {
+            ss.str("");
+            ss << "number of write misses (" << evt_cache_write_miss
+               << ") is bigger than the number of write requests (" << evt_write_req << ")";
+            print_error(ss.str());
+        }
+        if (evt_cache_read_miss > evt_read_req) {
+            ss.str("");
+            ss << "number of read misses (" << evt_cache_read_miss
+               << ") is bigger than the number of read requests (" << evt_read_req << ")";
+            print_error(ss.str());
+        }
+    }
+
+    void print_stats(std::stringstream& ss) const
+    {
+        ss << "SCOREBOARD STATISTICS" << std::endl
+           << "Status" << std::endl
+           << "--------------------------------------------------" << std::endl
+           << "SB.NB_ERROR             : " << nb_error << std::endl
+           << std::endl
+
+           << "Instrumentation" << std::endl
+           << "--------------------------------------------------" << std::endl
+           << "SB.NB_CYCLES            : " << nb_cycles_effective << std::endl
+           << "SB.NB_CORE_REQ          : " << nb_core_req << std::endl
+           << "SB.NB_CORE_RESP         : " << nb_core_resp << std::endl
+           << "SB.NB_MEM_READ_REQ      : " << nb_mem_read_req << std::endl
+           << "SB.NB_MEM_READ_RESP     : " << nb_mem_read_resp << std::endl
+           << "SB.NB_MEM_WRITE_REQ     : " << nb_mem_write_req << std::endl
+           << "SB.NB_MEM_WRITE_RESP    : " << nb_mem_write_resp << std::endl
+           << "SB.NB_MISS_COMPULSORY   : " << nb_miss_compulsory << std::endl
+           << "SB.NB_MISS_CAPACITY     : " << nb_miss_capacity << std::endl
+           << "SB.NB_MISS_CONFLICT     : " << nb_miss_conflict << std::endl
+           << "CACHE.WRITE_MISSES      : " << evt_cache_write_miss << std::endl
+           << "CACHE.READ_MISSES       : " << evt_cache_read_miss << std::endl
+           << "CACHE.DIR_UNC_ERRORS    : " << evt_cache_dir_unc_err << std::endl
+           << "CACHE.DIR_COR_ERRORS    : " << evt_cache_dir_cor_err << std::endl
+           << "CACHE.DAT_UNC_ERRORS    : " << evt_cache_dat_unc_err << std::endl
+           << "CACHE.DAT_COR_ERRORS    : " << evt_cache_dat_cor_err << std::endl
+           << "CACHE.SCRUBBER_COMPLETE : " << evt_scrub_complete << std::endl
+           << "CACHE.UNCACHED_REQUESTS : " << evt_uncached_req << std::endl
+           << "CACHE.CMO_REQUESTS      : " << evt_cmo_req << std::endl
+           << "CACHE.WRITE_REQUESTS    : " << evt_write_req << std::endl
+           << "CACHE.READ_REQUESTS     : " << evt_read_req << std::endl
+           << "CACHE.PREFETCH_REQUESTS : " << evt_prefetch_req << std::endl
+           << "CACHE.ON_HOLD_REQUESTS  : " << evt_req_on_hold << std::endl
+           << "CACHE.RTAB_ROLLBACK     : " << evt_rtab_rollback << std::endl
+           << "CACHE.STALL_REFILL      : " << evt_stall_refill << std::endl
+           << "CACHE.STALL             : " << evt_stall << std::endl
+           << std::endl
+
+           << "Computed values" << std::endl
+           << "---------------" << std::endl
+           << "Cycles per request      : "
+           << (nb_core_req > 0 ? (double)nb_cycles_effective / nb_core_req : 0) << std::endl
+           << "Read miss rate          : "
+           << (evt_read_req > 0 ? (double)evt_cache_read_miss / evt_read_req : 0) << std::endl
+           << "Write miss rate         : "
+           << (evt_write_req > 0 ? (double)evt_cache_write_miss / evt_write_req : 0) << std::endl
+           << "Compulsory misses       : " << miss_share(nb_miss_compulsory) << std::endl
+           << "Capacity misses         : " << miss_share(nb_miss_capacity) << std::endl
+           << "Conflict misses         : " << miss_share(nb_miss_conflict) << std::endl;
+
+        print_latency_stats(ss);
+    }
+
+    void print_error(const std::string& msg)
+    {
+        std::cout << timestamp() << " / SB_ERROR: " << msg << std::endl;
+
+        if (error_handler_m) error_handler_m();
+
+        nb_error++;
+        if (sb_error_limit_m > 0 && (nb_error >= sb_error_limit_m)) {
+            std::cout << "SB_ERROR: number of errors exceeded the limit (" << sb_error_limit_m
+                      << ")" << std::endl;
+
+            std::exit(1);
+        }
+    }
+
+    void print_debug(const std::string& msg) const
+    {
+        std::cout << timestamp() << " / SB_DEBUG: " << msg << std::endl;
+    }
+
+private:
+    template<typename R>
+    inflight_mem_entry_t mem_entry(const R& req,
+                                   uint64_t bytes,
+                                   uint64_t burst_bytes,
+                                   const inflight_entry_t* core_req) const
+    {
+        inflight_mem_entry_t e;
+        e.time = nb_cycles;
+        e.addr = req.addr;
+        e.bytes = bytes;
+        e.burst_bytes = burst_bytes;
+        e.beats = 0;
+        e.is_wrap = req.wrap;
+        e.is_uncacheable = !req.cacheable;
+        e.is_error = mem_model_m && mem_model_m->within_error_region(e.addr, e.addr + bytes);
+        e.core_req_ptr = core_req;
+        return e;
+    }
+
+    //  Check if there is an inflight refill of the cacheline of a given address
+    bool refill_pending(uint64_t addr) const
+    {
+        for (const auto& m : inflight_mem_read_m) {
+            if (!m.second.is_uncacheable && (get_nline(m.second.addr) == get_nline(addr))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //  Update the recency of a cacheline accessed by the core in the shadow
+    //  fully-associative cache. Cachelines are only allocated on refills
+    bool shadow_access(uint64_t addr)
+    {
+        auto it = shadow_fa_m.find(get_nline(addr));
+        if (it == shadow_fa_m.end()) return false;
+        shadow_lru_m.splice(shadow_lru_m.begin(), shadow_lru_m, it->second);
+        return true;
+    }
+
+    //  Classify a refill (3C model): compulsory if the cacheline was never
+    //  refilled, capacity if it is not in the shadow fully-associative cache,
+    //  conflict otherwise. Then allocate the cacheline in the shadow caches
+    void shadow_refill(uint64_t addr)
+    {
+        const uint64_t nline = get_nline(addr);
+        if (shadow_access(addr)) {
+            nb_miss_conflict++;
+            return;
+        }
+        if (shadow_seen_m.insert(nline).second) {
+            nb_miss_compulsory++;
+        } else {
+            nb_miss_capacity++;
+        }
+        if (shadow_lru_m.size() == SHADOW_FA_LINES) {
+            shadow_fa_m.erase(shadow_lru_m.back());
+            shadow_lru_m.pop_back();
+        }
+        shadow_lru_m.push_front(nline);
+        shadow_fa_m[nline] = shadow_lru_m.begin();
+    }
+
+    double miss_share(uint64_t n) const
+    {
+        const uint64_t misses = nb_miss_compulsory + nb_miss_capacity + nb_miss_conflict;
+        return misses > 0 ? (double)n / misses : 0;
+    }
+
+    //  Name of the latency class of a request: <op>.<hit|miss> for cacheable
+    //  requests, <op>.uncached otherwise. A cacheable request is a miss when it
+    //  waits for the refill of its cacheline
+    static std::string latency_class(const inflight_entry_t& e)
+    {
+        const char* op = e.is_read    ? "load"
+                         : e.is_write ? "store"
+                         : e.is_cmo   ? "cmo"
+                                      : "amo";
+        if (e.is_cmo) return op;
+        return std::string(op) + (e.is_uncacheable ? ".uncached" : e.is_miss ? ".miss" : ".hit");
+    }
+
+    static void print_latency_row(std::stringstream& ss,
+                                  const std::string& name,
+                                  const hpdcache_test_latency& l)
+    {
+        ss << std::left << std::setw(16) << name << std::right << "  " << std::setw(9)
+           << l.count() << "  " << std::setw(9) << std::fixed << std::setprecision(1) << l.mean()
+           << std::defaultfloat << "  " << std::setw(6) << l.percentile(50) << "  "
+           << std::setw(6) << l.percentile(90) << "  " << std::setw(6) << l.percentile(99)
+           << "  " << std::setw(6) << l.max() << std::endl;
+    }
+
+    void print_latency_stats(std::stringstream& ss) const
+    {
+        if (latency_all_m.count() == 0) return;
+
+        ss << std::endl
+           << "Latency (cycles)" << std::endl
+           << "--------------------------------------------------" << std::endl
+           << "CLASS                 COUNT        AVG     P50     P90     P99     MAX" << std::endl;
+        print_latency_row(ss, "all", latency_all_m);
+        for (const auto& c : latency_class_m) {
+            print_latency_row(ss, c.first, c.second);
+        }
+        if (latency_fill_m.count() > 0) {
+            print_latency_row(ss, "load.miss.fill", latency_fill_m);
+        }
+
+        ss << std::endl << "Latency histogram (all)" << std::endl;
+        const std::vector<uint64_t>& h = latency_all_m.log2_histogram();
+        for (unsigned b = 0; b <= latency_all_m.log2_last(); b++) {
+            const uint64_t lo = (b == 0) ? 0 : (1ULL << (b - 1));
+            const uint64_t hi = (b == 0) ? 0 : ((1ULL << b) - 1);
+            ss << std::setw(8) << lo << " - " << std::setw(8) << hi << "  : " << h[b] << std::endl;
+        }
+    }
+};
+
+#endif /* __HPDCACHE_TEST_SCOREBOARD_BASE_H__ */
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
@@ -31,8 +31,13 @@
 #include "hpdcache_test_transaction.h"
 #include "scv.h"
 #include "sequence.h"
+#include <deque>
 #include <systemc>
 
+#ifdef CREATE_FILE
+#include "hpdcache_test_trace_manager.h"
+#endif
+
 class hpdcache_test_sequence : public Sequence
 {
     const int HPDCACHE_REQ_MAX_TRANS_ID = 1 << HPDCACHE_REQ_TRANS_ID_WIDTH;
@@ -42,6 +47,8 @@ public:
       : Sequence(nm)
       , name(seq_name)
       , max_transactions(100)
+      , sid(0)
+      , run_ahead(false)
       , segptr("segptr")
       , seg_distribution("seg_distribution")
       , delay("delay")
@@ -150,6 +157,19 @@ public:
         this->max_transactions = max_transactions;
     }
 
+    //  Source ID of the requests generated by this sequence. When the
+    //  testbench drives several requester ports, it shall match the index of
+    //  the port connected to the agent running this sequence
+    void set_sid(unsigned int sid) { this->sid = sid; }
+
+    unsigned int get_sid() const { return sid; }
+
+    //  When enabled, the sequence does not wait for the acknowledgement of a
+    //  transaction before preparing the next one. It runs ahead of the cache
+    //  by up to the depth of the transaction FIFO. The driver shall then
+    //  acknowledge the transactions when it fetches them (pipelined driver)
+    void set_run_ahead(bool enable) { run_ahead = enable; }
+
     std::list<unsigned int>::const_iterator ids_cbegin() { return ids.cbegin(); }
 
     std::list<unsigned int>::const_iterator ids_cend() { return ids.cend(); }
@@ -170,18 +190,29 @@ public:
 
     void send_transaction(std::shared_ptr<hpdcache_test_transaction_req> t, int delay = 1)
     {
-        // send transaction to the driver
+        // send transaction to the driver (this blocks while the FIFO is full)
         transaction_fifo_o->write(t);
 
-        // wait and consume driver acknowledgement (this is blocking)
-        transaction_ret_i.read();
-
 #ifdef CREATE_FILE
-        instance_file_writter()->write_in_file(t, &delay);
+        instance_trace_writer()->write_in_file(t, delay);
 #endif
 
-        // release the previously used transaction object
-        release_transaction<hpdcache_test_transaction_req>(t);
+        if (run_ahead) {
+            // release the transaction objects already fetched by the driver
+            // (acknowledged in order)
+            uint64_t id;
+            sent.push_back(t);
+            while (transaction_ret_i.nb_read(id)) {
+                release_transaction<hpdcache_test_transaction_req>(sent.front());
+                sent.pop_front();
+            }
+        } else {
+            // wait and consume driver acknowledgement (this is blocking)
+            transaction_ret_i.read();
+
+            // release the previously used transaction object
+            release_transaction<hpdcache_test_transaction_req>(t);
+        }
         // add some delay between two consecutive commands
         for (int i = 0; i < delay; i++) wait();
     }
@@ -189,7 +220,8 @@ public:
     const std::string to_string() const
     {
         std::stringstream os;
-        os << "Sequence " << name << " / Max Transactions = " << max_transactions << std::endl;
+        os << "Sequence " << name << " / SID = " << sid
+           << " / Max Transactions = " << max_transactions << std::endl;
         return os.str();
     }
 
@@ -203,6 +235,9 @@ protected:
     std::list<unsigned int> ids;
     std::string name;
     size_t max_transactions;
+    unsigned int sid;
+    bool run_ahead;
+    std::deque<std::shared_ptr<hpdcache_test_transaction_req>> sent;
     scv_smart_ptr<int> segptr;
     scv_bag<int> seg_distribution;
     scv_smart_ptr<int> delay;
@@ -19,7 +19,9 @@
 /**
  *  Author     : Tommy PRATS
  *  Date       : June, 2025
- *  Description: Class definition of the reader/writer of trace
+ *  Description: Class definition of the writer of trace, and conversion of the
+ *               records of a trace into requests of the testbench (the reader is
+ *               in hpdcache_test_trace_reader.h)
  */
 
 #ifndef __HPDCACHE_TEST_TRACE_MANAGER__
@@ -27,427 +29,223 @@
 
 #include <fcntl.h>
 #include <stdint.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <sys/stat.h>
-#include <sys/types.h>
+#include <string.h>
 #include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 extern "C"
 {
 #include "miniz.h"
 }
+#include "hpdcache_test_trace_reader.h"
 #include "hpdcache_test_transaction.h"
+#include "hpdcache_trace_format.h"
 
-#define MAX_SIZE_BUFFER 5000000
-
-class trace_reader
+/**
+ * @brief Fill a transaction from a decoded record of a trace
+ * @param r A decoded record
+ * @param transaction A pointer on a well formed transaction for the core previously allowed
+ * @return  the delay to wait before sending the transaction
+ */
+inline int
+trace_record_to_transaction(const trace_record_t& r,
+                            std::shared_ptr<hpdcache_test_transaction_req> transaction)
 {
-private:
-    bool bool_finish = false;
-    mz_stream* stream = nullptr;
-
-public:
-    int trace_descriptor;
-    char buf[MAX_SIZE_BUFFER * 20]; // x20 -> maximum size after decompression
-    int end_buffer;
-    int read_buffer;
-
-    trace_reader(std::string trace_name)
-    {
-        set_trace(trace_name);
-        init_buf();
-    }
-
-    /**
-     * @brief Open a trace and check if it can be read. If not, this function does an exit()
-     *
-     * @param trace_name The name of the trace
-     */
-    void set_trace(std::string trace_name)
-    {
-        trace_descriptor = open(trace_name.c_str(), O_RDONLY);
-        if (trace_descriptor <= 0) {
-            Logger::warning("The trace " + trace_name + " can't be open");
-            exit(EXIT_FAILURE);
+    transaction->req_addr = r.addr;
+    transaction->req_size = r.size;
+    transaction->req_op = r.op;
+    transaction->req_need_rsp = r.need_rsp;
+    transaction->req_uncacheable = r.uncacheable;
+
+    if (!r.full) {
+        transaction->req_phys_indexed = true;
+        transaction->req_io = r.uncacheable;
+        transaction->req_abort = false;
+        if (r.op == hpdcache_test_transaction_req::HPDCACHE_REQ_STORE) {
+            transaction->req_wdata = r.wdata[0];
         }
-        init_buf();
-    }
-
-    void init_buf()
-    {
-        end_buffer = MAX_SIZE_BUFFER;
-        read_buffer = MAX_SIZE_BUFFER;
-    }
+        return r.delay;
+    }
+
+    transaction->req_sid = r.sid;
+    transaction->req_phys_indexed = (r.attr & 0x1) != 0;
+    transaction->req_io = (r.attr & 0x2) != 0;
+    transaction->req_abort = (r.attr & 0x4) != 0;
+    transaction->req_wr_policy_hint =
+        (hpdcache_test_transaction_req::hpdcache_wr_policy_hint_e)((r.attr >> 3) & 0x7);
+    for (int i = 0; i < TRACE_RECORD_DATA_WORDS; i++) {
+        const int lo = i * 64;
+        const int hi = std::min(lo + 64, HPDCACHE_REQ_DATA_WIDTH) - 1;
+        transaction->req_be.range(hi / 8, lo / 8) = r.be[i];
+        transaction->req_wdata.range(hi, lo) = r.wdata[i];
+    }
+    return r.delay;
+}
 
-    /**
-     * @brief Debug function to display a number store in one byte within his binary
-     * representation
-     *
-     * @param value A number store in 1 byte
-     */
-    static void display_binary(unsigned value)
-    {
-        unsigned tmp = value;
-        std::cout << "\nI read " << tmp << " in binary :";
-        for (int i = 8; i > 0; i--) {
-            tmp = value;
-            tmp = tmp << (8 - i);
-            tmp = tmp >> 7;
-            if ((tmp & 1) != 0) {
-                std::cout << "1";
-            } else {
-                std::cout << "0";
+/**
+ * @class trace_writer
+ * @brief Capture the requests sent by a sequence into a version 2 trace with full records (see
+ *        hpdcache_trace_format.h), so that a run can be replayed later with the from_trace
+ *        sequence. The records keep all the fields of the requests, and each chunk of records is
+ *        compressed with deflate. To use this, CREATE_FILE need to be set at the compilation.
+ *        There is a single instance of this class (see instance_trace_writer())
+ */
+class trace_writer
+{
+private:
+    int trace_descriptor = -1;
+    hpdcache_trace_header_t header;
+    std::vector<uint8_t> chunk;
+    uint32_t chunk_records = 0;
+    std::vector<uint8_t> compressed;
+    std::vector<hpdcache_trace_index_t> index;
+    uint64_t file_offset = 0;
+
+    void write_all(const void* data, size_t size)
+    {
+        const uint8_t* p = (const uint8_t*)data;
+        while (size > 0) {
+            ssize_t n = write(trace_descriptor, p, size);
+            if (n <= 0) {
+                Logger::warning("Error, can't write in the trace");
+                exit(EXIT_FAILURE);
             }
+            p += n;
+            size -= n;
+            file_offset += n;
         }
-        std::cout << "\n";
     }
 
-    /**
-     * @brief Allocate memory for the streaming used by the decompression
-     */
-    void init_stream()
+    void flush_chunk()
     {
-        stream = (mz_stream*)calloc(1, sizeof(mz_stream));
-        if (!stream) {
-            Logger::warning("Error on allocation of memory for the stream\n");
-            exit(1);
-        }
-        if (mz_inflateInit(stream) != MZ_OK) {
-            Logger::warning("Error on the initialisation of the decompression\n");
-            exit(1);
-        }
-    }
-
-    /**
-     * @brief This function is used to decompress data from the trace. It use miniz and read the
-     * trace by chunk when it's necessary
-     */
-    void decompress_data_from_trace()
-    {
-        int ret;
-        unsigned char* in_buffer = (unsigned char*)calloc(1, MAX_SIZE_BUFFER);
-        unsigned char* out_buffer = (unsigned char*)calloc(1, MAX_SIZE_BUFFER);
-
-        if (!in_buffer || !out_buffer) {
-            Logger::warning("Error on allocation of memory");
-            exit(1);
+        if (chunk_records == 0) {
+            return;
         }
 
-        if (!stream) { // we do this only the first time it's call
-            init_stream();
+        mz_ulong data_size = compressed.size();
+        if (mz_compress2(compressed.data(), &data_size, chunk.data(), chunk.size(), MZ_BEST_SPEED) !=
+            MZ_OK)
+        {
+            Logger::warning("Error during compression");
+            exit(EXIT_FAILURE);
         }
 
-        stream->avail_in = 0;    // number of bytes on the entry
-        stream->next_in = NULL;  // buffer for the entry
-        stream->avail_out = 0;   // number of bytes on the exit
-        stream->next_out = NULL; // buffer for the exit
+        hpdcache_trace_chunk_header_t ch;
+        ch.magic = HPDCACHE_TRACE_CHUNK_MAGIC;
+        ch.data_size = data_size;
+        ch.raw_size = chunk.size();
+        ch.nb_records = chunk_records;
+        ch.first_record = header.nb_records;
 
-        stream->avail_in = read(trace_descriptor, in_buffer, MAX_SIZE_BUFFER);
-        stream->next_in = in_buffer;
-        ssize_t have = 0;
-        do {
-            stream->avail_out = MAX_SIZE_BUFFER;
-            stream->next_out = out_buffer;
-            // This decompress data and store it in stream->next_out
-            ret = mz_inflate(stream, MZ_SYNC_FLUSH);
-            if (ret == MZ_STREAM_ERROR) {
-                Logger::warning("Error during decompression\n");
-                exit(1);
-            }
-            have = MAX_SIZE_BUFFER - stream->avail_out;
-            if (have > 0) {
-                memcpy(&(buf[end_buffer]), out_buffer, have);
-                end_buffer += have;
-            }
-        } while (stream->avail_in > 0); // compressed data can be larger than the size of
-                                        // the buffer on exit, so we maybe need to multiple
-                                        // decompression in order to have all data
+        index.push_back({ file_offset, ch.first_record });
+        header.nb_chunks++;
+        header.nb_records += chunk_records;
 
-        bool_finish = (ret == MZ_STREAM_END);
-        if (bool_finish) {
-            ret = mz_inflateEnd(stream);
-            if (ret != MZ_OK) {
-                Logger::warning("Error when closing the stream of decompression\n");
-                exit(1);
-            }
-            free(stream);
-        }
-        free(in_buffer);
-        free(out_buffer);
+        write_all(&ch, sizeof(ch));
+        write_all(compressed.data(), data_size);
+        chunk.clear();
+        chunk_records = 0;
     }
 
-    /**
-     * @brief This function read the  buffer who contains the trace
-     *        By edge effect, read the trace if it's necessary.
-     *
-     * @param ptr A pointer on any type where the size next bytes will became the content of the
-     *            trace
-     *
-     * @param size The number of bytes to read
-     */
-    void get_content_of_trace(void* ptr, int size)
+public:
+    void open_file(std::string trace_name)
     {
-        if (size == 0) {
-            return;
-        }
-        if (read_buffer == end_buffer) {
-            end_buffer = 0;
-            read_buffer = 0;
-            decompress_data_from_trace();
-            /*
-            if (compress_data) {
-                decompress_data_from_trace();
-            } else{
-                end_buffer = read(trace_descriptor, buf, MAX_SIZE_BUFFER);
-                // check if we read all the trace. It's useful only if size of the trace
-            is a multiple of MAX_SIZE_BUFFER off_t current = lseek(fd, 0, SEEK_CUR);
-                off_t end     = lseek(fd, 0, SEEK_END);
-                lseek(fd, current, SEEK_SET);
-                if (current == end || end_buffer < MAX_SIZE_BUFFER) {
-                    bool_finish = true;
-                }
-            }
-            */
+        trace_descriptor = open(trace_name.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+        if (trace_descriptor < 0) {
+            Logger::warning("The trace " + trace_name + " can't be created");
+            exit(EXIT_FAILURE);
         }
-        *((char*)ptr) = buf[read_buffer];
-        read_buffer++;
-        get_content_of_trace((char*)ptr + 1, size - 1);
-    }
-
-    /**
-     * @brief This function check if all the trace has been read
-     */
-    bool is_finish() { return ((end_buffer <= read_buffer) && bool_finish); }
-
-    uint64_t read_address()
-    {
-        uint64_t address_64 = 0;
-        get_content_of_trace(&address_64, sizeof(uint64_t));
-        return address_64;
-    }
-
-    inline unsigned read_type_transaction()
-    {
-        char result = 0;
-        get_content_of_trace(&result, sizeof(char));
-        return *((unsigned*)&result);
-    }
-
-    inline unsigned read_size(uint8_t* size_value)
-    {
-        char result = 0;
-        get_content_of_trace(&result, sizeof(char));
-        *size_value = result >> 4;
-        result <<= 4;
-        result >>= 4;
-        return *((unsigned*)&result);
-    }
-
-    /**
-     * @brief This function set boolean value of the transaction, all value are stored in 1 bit
-     *
-     * @param result a pointer on a transaction
-     */
-    void read_boolean_and_type(std::shared_ptr<hpdcache_test_transaction_req> result)
-    {
-        uint8_t tmp = 0;
-        get_content_of_trace(&tmp, sizeof(uint8_t));
 
-        uint8_t type_operation = tmp >> 2;
-        result->req_op = (unsigned)type_operation;
-        result->req_need_rsp = get_bit(tmp, 2);
-        result->req_uncacheable = get_bit(tmp, 1);
-        result->req_phys_indexed = true;
-        result->req_io = result->req_uncacheable;
-        result->req_abort = false;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, HPDCACHE_TRACE_MAGIC, HPDCACHE_TRACE_MAGIC_SIZE);
+        header.version = HPDCACHE_TRACE_VERSION;
+        header.header_size = sizeof(hpdcache_trace_header_t);
+        header.addr_width = HPDCACHE_PA_WIDTH;
+        header.word_width = HPDCACHE_WORD_WIDTH;
+        header.nb_vcpus = 1;
+        header.flags = HPDCACHE_TRACE_FLAG_COMPRESSED | HPDCACHE_TRACE_FLAG_FULL_RECORDS;
+        header.chunk_records = HPDCACHE_TRACE_CHUNK_RECORDS;
+        header.req_data_width = HPDCACHE_REQ_DATA_WIDTH;
+        strncpy(header.config, "hpdcache_tb", HPDCACHE_TRACE_CONFIG_SIZE - 1);
+
+        const size_t max_record_size = HPDCACHE_TRACE_FULL_RECORD_HEADER_SIZE +
+                                       TRACE_RECORD_DATA_WORDS + HPDCACHE_REQ_DATA_WIDTH / 8;
+        chunk.reserve(header.chunk_records * max_record_size);
+        compressed.resize(mz_compressBound(header.chunk_records * max_record_size));
+        index.clear();
+        chunk_records = 0;
+        file_offset = 0;
+
+        write_all(&header, sizeof(header));
     }
 
     /**
-     * @brief This function can extract the value of 1 bit in a byte
-     *
-     * @param to_read a value store in a single byte
-     *
-     * @param position The position of the bit in the byte. Consider bit 8 its msb bit and
-     *                 bit 1 its the lsb
+     * @brief Append a request to the trace
      *
-     * @return true if bit value is 1, else false
+     * @param t The request
+     * @param delay The nb of cycles to wait before sending the next request (saturated to 255)
      */
-    bool get_bit(char to_read, short position)
-    {
-        to_read = to_read << (8 - position);
-        to_read = to_read >> 7;
-        return (to_read & 1) != 0;
-    }
-
-    inline int is_big_endian()
-    {
-        int i = 1;
-        return !*((char*)&i);
-    }
-
-    uint64_t get_address(uint8_t size, uint64_t address_on_real_computer)
+    void write_in_file(std::shared_ptr<hpdcache_test_transaction_req> t, int delay)
     {
-        size <<= 2; // multiply by 4
-        if (size > HPDCACHE_REQ_DATA_WIDTH) {
-            Logger::warning("A value larger than the cache width need to be store");
-            exit(1);
-        }
-        if (!is_big_endian()) {
-            return address_on_real_computer + HPDCACHE_REQ_DATA_WIDTH - size;
-        } else {
-            return address_on_real_computer;
+        if (trace_descriptor < 0) {
+            return;
         }
-    }
 
-    void read_value(std::shared_ptr<hpdcache_test_transaction_req> transaction,
-                    uint8_t size_value_store)
-    {
-        switch (size_value_store) {
-            case 0:
-                uint8_t result8;
-                get_content_of_trace(&(result8), sizeof(uint8_t));
-                transaction->req_wdata = result8;
-                break;
-            case 1:
-                uint16_t result16;
-                get_content_of_trace(&(result16), sizeof(uint16_t));
-                transaction->req_wdata = result16;
-                break;
-            case 2:
-                uint32_t result32;
-                get_content_of_trace(&(result32), sizeof(uint32_t));
-                transaction->req_wdata = result32;
-                break;
-            case 3:
-                uint64_t result64;
-                get_content_of_trace(&(result64), sizeof(uint64_t));
-                transaction->req_wdata = result64;
-                break;
-            case 4:
-                uint64_t result128;
-                get_content_of_trace(&(result128), sizeof(uint64_t));
-                transaction->req_wdata = result128;
-                break;
+        uint8_t rec[HPDCACHE_TRACE_FULL_RECORD_HEADER_SIZE];
+        const uint64_t addr = t->req_addr.to_uint64();
+        const unsigned op = t->req_op.to_uint();
+
+        rec[0] = (uint8_t)std::min(std::max(delay, 0), 255);
+        memcpy(&rec[1], &addr, sizeof(uint64_t));
+        rec[9] = t->req_size.to_uint() & 0xf;
+        rec[10] = (op << 2) | (t->get_need_resp() << 1) | t->is_uncacheable();
+        rec[11] = t->req_sid.to_uint();
+        rec[12] = t->is_phys_indexed() | (t->is_io() << 1) | (t->is_aborted() << 2) |
+                  ((t->req_wr_policy_hint & 0x7) << 3);
+        chunk.insert(chunk.end(), rec, rec + sizeof(rec));
+
+        uint64_t wdata[TRACE_RECORD_DATA_WORDS];
+        for (int i = 0; i < TRACE_RECORD_DATA_WORDS; i++) {
+            const int lo = i * 64;
+            const int hi = std::min(lo + 64, HPDCACHE_REQ_DATA_WIDTH) - 1;
+            chunk.push_back(t->req_be.range(hi / 8, lo / 8).to_uint());
+            wdata[i] = t->req_wdata.range(hi, lo).to_uint64();
         }
-        return;
-    }
-
-    void read_delay(uint8_t* delay) { get_content_of_trace(delay, sizeof(uint8_t)); }
-
-    /**
-     * @brief Read a transaction in a binary trace
-     * @param transaction A pointer on a well formed transaction for the core previously allowed
-     * @return  the delay to wait before sending the transaction
-     */
-    int read_transaction(std::shared_ptr<hpdcache_test_transaction_req> transaction)
-    {
-        uint8_t size_value_store, delay;
-        read_delay(&delay); // read 1 byte
-        transaction->req_addr =
-            read_address(); // read (HPDCACHE_WORD_WIDTH * HPDCACHE_REQ_WORDS ) / 8 bytes
-        transaction->req_size = read_size(&size_value_store); // read 1 byte for value and address
-        read_boolean_and_type(transaction);                   // read 1 byte
-
-        // TODO Add missing instructions with write data (e.g. AMO)
-        if (transaction->req_op == hpdcache_test_transaction_req::HPDCACHE_REQ_STORE) {
-            read_value(transaction, size_value_store); // read 8 byte
+        if (hpdcache_trace_op_has_data(op)) {
+            const uint8_t* p = (const uint8_t*)wdata;
+            chunk.insert(chunk.end(), p, p + HPDCACHE_REQ_DATA_WIDTH / 8);
         }
-        return delay;
-    }
-
-    void my_close() { close(trace_descriptor); }
-};
 
-/**
- * @class trace_writer
- * @brief This class is used for debug purpose. It's a singleton who allow us to store an execution
- *        of other mode (random write etc ) in the format for reader class in order to test it. For
- *        the moment it doesn't compress data. To use this, CREATE_FILE need to be set at the
- *        compilation
- */
-class trace_writer
-{
-private:
-    std::ofstream* trace;
-    static std::mutex mutex_;
-    static trace_writer* is_instance;
-
-public:
-    void write_address(std::shared_ptr<hpdcache_test_transaction_req> t)
-    {
-        uint64_t address_64 = t->req_addr.to_uint64();
-        trace->write((char*)(&(address_64)), sizeof(uint64_t));
-        return;
-    }
-
-    void write_type_transaction(std::shared_ptr<hpdcache_test_transaction_req> t)
-    {
-        unsigned op = t->req_op.to_uint();
-        trace->write((char*)(&op), 1);
-    }
-
-    void write_size(std::shared_ptr<hpdcache_test_transaction_req> t)
-    {
-        unsigned op = t->req_size.to_uint();
-        trace->write((char*)(&op), 1);
-    }
-
-    void write_boolean(std::shared_ptr<hpdcache_test_transaction_req> t)
-    {
-        unsigned bool_value = 0;
-        bool_value = construct_bool_in_one_byte(t->get_need_resp(), bool_value);
-        bool_value = construct_bool_in_one_byte(t->is_phys_indexed(), bool_value);
-        bool_value = construct_bool_in_one_byte(t->is_uncacheable(), bool_value);
-        bool_value = construct_bool_in_one_byte(t->is_io(), bool_value);
-        bool_value = construct_bool_in_one_byte(t->is_aborted(), bool_value);
-        if (Logger::is_debug_enabled()) {
-            // display_binary(bool_value);
+        if (++chunk_records == header.chunk_records) {
+            flush_chunk();
         }
-        trace->write((char*)(&bool_value), 1);
     }
 
-    unsigned construct_bool_in_one_byte(const bool to_add, unsigned result)
+    void close_file()
     {
-        result = result << 1;
-        if (to_add) {
-            result |= 1;
+        if (trace_descriptor < 0) {
+            return;
         }
-        return result;
-    }
-
-    void open_trace(std::string trace_name)
-    {
-
-        trace = new std::ofstream(trace_name, std::ios_base::binary | std::ios::trunc);
-    }
 
-    void close_trace() { trace->close(); }
-
-    void write_delay(int* delay) { trace->write((char*)delay, sizeof(int)); }
-
-    void write_in_trace(std::shared_ptr<hpdcache_test_transaction_req> t, int* delay)
-    {
-        write_delay(delay);
-        write_address(t);
-        write_type_transaction(t);
-        write_size(t);
-        write_boolean(t);
-        return;
+        flush_chunk();
+        header.roi_offset = file_offset;
+        header.index_offset = file_offset;
+        write_all(index.data(), index.size() * sizeof(hpdcache_trace_index_t));
+        if (pwrite(trace_descriptor, &header, sizeof(header), 0) != sizeof(header)) {
+            Logger::warning("Error, can't write in the trace");
+            exit(EXIT_FAILURE);
+        }
+        close(trace_descriptor);
+        trace_descriptor = -1;
     }
 };
 
-trace_writer* is_instance = nullptr;
-std::mutex mutex_;
-
-trace_writer*
-instance_trace_writter()
+inline trace_writer*
+instance_trace_writer()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (is_instance) {
-        return is_instance;
-    }
-    is_instance = new trace_writer();
-    return is_instance;
+    static trace_writer writer;
+    return &writer;
 }
 
 #endif // __HPDCACHE_TEST_TRACE_MANAGER__
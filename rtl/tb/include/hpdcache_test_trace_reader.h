@@ -0,0 +1,792 @@
+/**
+ *  Copyright 2025 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ *
+ *  Licensed under the Solderpad Hardware License v 2.1 (the “License”); you
+ *  may not use this trace except in compliance with the License, or, at your
+ *  option, the Apache License version 2.0. You may obtain a copy of the
+ *  License at
+ *
+ *  https://solderpad.org/licenses/SHL-2.1/
+ *
+ *  Unless required by applicable law or agreed to in writing, any work
+ *  distributed under the License is distributed on an “AS IS” BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *  License for the specific language governing permissions and limitations
+ *  under the License.
+ */
+/**
+ *  Author     : Tommy PRATS
+ *  Date       : June, 2025
+ *  Description: Class definition of the reader of trace. This file does not
+ *               depend on SystemC nor on the verilated model, so it can also
+ *               be used by standalone tools
+ */
+
+#ifndef __HPDCACHE_TEST_TRACE_READER__
+#define __HPDCACHE_TEST_TRACE_READER__
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+extern "C"
+{
+#include "miniz.h"
+}
+#include "hpdcache_test_defs.h"
+#include "hpdcache_trace_format.h"
+#include "logger.h"
+#include "spsc_ring.h"
+
+/**
+ * @brief Size in bytes of the window of decompressed trace data
+ */
+#define TRACE_READER_WINDOW_SIZE (4 << 20)
+
+/**
+ * @brief Size in bytes of the chunks of compressed data read from the trace
+ */
+#define TRACE_READER_INPUT_SIZE (1 << 20)
+
+/**
+ * @brief Nb of 64-bit words of request data in a full record
+ */
+#define TRACE_RECORD_DATA_WORDS ((HPDCACHE_REQ_DATA_WIDTH + 63) / 64)
+
+/**
+ * @brief Decoded content of a record of a binary trace
+ */
+typedef struct
+{
+    uint64_t addr;       // address of the access
+    uint64_t wdata[TRACE_RECORD_DATA_WORDS]; // write data (zero for other operations)
+    uint8_t be[TRACE_RECORD_DATA_WORDS];     // byte enables (full records only)
+    uint8_t delay;       // nb of cycles to wait before sending the request
+    uint8_t size;        // log2 of the size in bytes of the access
+    uint8_t size_value;  // encoded size of the store value (0: 1 byte, ..., 3 and 4: 8 bytes)
+    uint8_t op;          // operation type
+    bool need_rsp;       // the request needs a response
+    bool uncacheable;    // the request targets an uncacheable region
+    bool full;           // the following fields are valid (full records only)
+    uint8_t sid;         // source ID
+    uint8_t attr;        // phys indexed (bit 0), IO (bit 1), aborted (bit 2), wr policy (5:3)
+} trace_record_t;
+
+/**
+ * @class trace_reader
+ * @brief Decoder of binary traces (see hpdcache_trace_format.h). Records are decoded from a
+ *        contiguous window of the trace:
+ *        - version 1 traces: uncompressed traces are mapped in memory, and compressed traces
+ *          (detected by the zlib or gzip header at the beginning of the file, whatever its
+ *          name) are inflated by large blocks into a window that is reused for the whole
+ *          trace. These traces can only be read sequentially.
+ *        - version 2 traces: the window holds one chunk. Thanks to the chunk index, the reader
+ *          can directly jump to any record or region of interest of the trace.
+ */
+class trace_reader
+{
+private:
+    int trace_descriptor = -1;
+    bool compressed = false;
+    bool end_of_stream = true;
+
+    //  decoded bytes of the trace that were not yet consumed are in [win_pos, win_end)
+    const uint8_t* win = nullptr;
+    size_t win_pos = 0;
+    size_t win_end = 0;
+
+    //  index of the next record, and index of the first record that shall not be read
+    uint64_t cur_record = 0;
+    uint64_t end_record = UINT64_MAX;
+
+    //  uncompressed traces (version 1)
+    void* map_addr = nullptr;
+    size_t map_size = 0;
+
+    //  compressed traces (version 1)
+    mz_stream stream;
+    std::vector<uint8_t> in_buf;
+    std::vector<uint8_t> out_buf;
+
+    //  version 2 traces
+    unsigned version = 1;
+    bool full_records = false;
+    hpdcache_trace_header_t header;
+    std::vector<hpdcache_trace_index_t> index;
+    std::vector<hpdcache_trace_roi_t> rois;
+    size_t next_chunk = 0;
+
+    //  decoding errors (see fail())
+    bool exit_on_error = true;
+    bool failed = false;
+    std::string error_msg;
+
+public:
+    trace_reader(std::string trace_name) { set_trace(trace_name); }
+
+    ~trace_reader() { my_close(); }
+
+    /**
+     * @brief Open a trace and check if it can be read. If not, this function does an exit()
+     *
+     * @param trace_name The name of the trace
+     */
+    void set_trace(std::string trace_name)
+    {
+        my_close();
+
+        trace_descriptor = open(trace_name.c_str(), O_RDONLY);
+        if (trace_descriptor < 0) {
+            Logger::warning("The trace " + trace_name + " can't be open");
+            exit(EXIT_FAILURE);
+        }
+
+        win_pos = 0;
+        win_end = 0;
+        cur_record = 0;
+        end_record = UINT64_MAX;
+
+        char magic[HPDCACHE_TRACE_MAGIC_SIZE] = {};
+        const ssize_t magic_bytes = pread(trace_descriptor, magic, sizeof(magic), 0);
+        if ((magic_bytes == (ssize_t)sizeof(magic)) &&
+            (memcmp(magic, HPDCACHE_TRACE_MAGIC, sizeof(magic)) == 0))
+        {
+            version = 2;
+            open_v2(trace_name);
+            return;
+        }
+
+        version = 1;
+        if ((magic_bytes >= 2) && is_zlib_header(magic)) {
+            compressed = true;
+            init_stream(MZ_DEFAULT_WINDOW_BITS);
+        } else if ((magic_bytes >= 3) && is_gzip_header(magic)) {
+            //  the deflate stream follows the gzip header (the trailer is ignored)
+            compressed = true;
+            skip_gzip_header(trace_name);
+            init_stream(-MZ_DEFAULT_WINDOW_BITS);
+        } else {
+            compressed = false;
+            map_trace(trace_name);
+        }
+    }
+
+    /**
+     * @brief Return the version of the format of the trace
+     */
+    unsigned get_version() const { return version; }
+
+    /**
+     * @brief Return true if the reader can jump to any record of the trace
+     */
+    bool is_seekable() const { return version >= 2; }
+
+    /**
+     * @brief Return the number of regions of interest of the trace
+     */
+    size_t get_nb_rois() const { return rois.size(); }
+
+    /**
+     * @brief Return the index of the next record
+     */
+    uint64_t get_record() const { return cur_record; }
+
+    /**
+     * @brief Report the decoding errors with has_failed() instead of doing an exit(). This is
+     *        used when the trace is decoded by another thread than the simulation
+     */
+    void set_exit_on_error(bool v) { exit_on_error = v; }
+
+    /**
+     * @brief Return true if the decoding stopped on an error (see get_error())
+     */
+    bool has_failed() const { return failed; }
+
+    const std::string& get_error() const { return error_msg; }
+
+    /**
+     * @brief Move to the n-th record of the trace. Version 1 traces can only move forward, and
+     *        records are decoded to do so
+     */
+    void seek_record(uint64_t n)
+    {
+        if (is_seekable() && !index.empty()) {
+            //  find the last chunk whose first record is not after n
+            size_t lo = 0, hi = index.size();
+            while ((hi - lo) > 1) {
+                size_t mid = (lo + hi) / 2;
+                if (index[mid].first_record <= n) {
+                    lo = mid;
+                } else {
+                    hi = mid;
+                }
+            }
+
+            //  load that chunk, unless n is ahead in the chunk that is already loaded
+            if ((next_chunk == 0) || (lo != (next_chunk - 1)) || (n < cur_record)) {
+                next_chunk = lo;
+                load_next_chunk();
+            }
+        }
+
+        if (n < cur_record) {
+            fail("This trace cannot be read backward");
+            return;
+        }
+
+        trace_record_t r;
+        while ((cur_record < n) && !is_finish()) {
+            read_record(r);
+        }
+    }
+
+    /**
+     * @brief Restrict the reading to the i-th region of interest of the trace
+     */
+    void select_roi(size_t i)
+    {
+        if (i >= rois.size()) {
+            Logger::warning("The trace has no region of interest " + std::to_string(i));
+            exit(EXIT_FAILURE);
+        }
+        end_record = UINT64_MAX;
+        seek_record(rois[i].begin);
+        end_record = rois[i].end;
+    }
+
+    /**
+     * @brief This function check if all the trace has been read
+     */
+    bool is_finish() { return (cur_record >= end_record) || !ensure(1); }
+
+    /**
+     * @brief Decode the next record of the trace
+     *
+     * @param r The decoded record
+     */
+    void read_record(trace_record_t& r)
+    {
+        static const uint8_t value_bytes[16] = { 1, 2, 4, 8, 8 };
+
+        if (full_records) {
+            read_full_record(r);
+            return;
+        }
+
+        ensure(HPDCACHE_TRACE_RECORD_MAX_SIZE);
+        const size_t avail = win_end - win_pos;
+        if (avail < HPDCACHE_TRACE_RECORD_HEADER_SIZE) {
+            fail("The trace ends with a truncated record");
+            return;
+        }
+
+        const uint8_t* p = win + win_pos;
+        r.delay = p[0];
+        memcpy(&r.addr, p + 1, sizeof(uint64_t));
+        r.size = p[9] & 0xf;
+        r.size_value = p[9] >> 4;
+        r.op = p[10] >> 2;
+        r.need_rsp = (p[10] & 0x2) != 0;
+        r.uncacheable = (p[10] & 0x1) != 0;
+        r.full = false;
+        memset(r.wdata, 0, sizeof(r.wdata));
+
+        size_t len = HPDCACHE_TRACE_RECORD_HEADER_SIZE;
+        if (r.op == HPDCACHE_TRACE_OP_STORE) {
+            const size_t n = value_bytes[r.size_value];
+            if (avail < len + n) {
+                fail("The trace ends with a truncated record");
+                return;
+            }
+            memcpy(&r.wdata[0], p + len, n);
+            len += n;
+        }
+        win_pos += len;
+        cur_record++;
+    }
+
+    /**
+     * @brief Decode the next record of a trace with full records
+     *
+     * @param r The decoded record
+     */
+    void read_full_record(trace_record_t& r)
+    {
+        const size_t be_bytes = TRACE_RECORD_DATA_WORDS;
+        const size_t data_bytes = HPDCACHE_REQ_DATA_WIDTH / 8;
+
+        ensure(HPDCACHE_TRACE_FULL_RECORD_HEADER_SIZE + be_bytes + data_bytes);
+        const size_t avail = win_end - win_pos;
+        if (avail < HPDCACHE_TRACE_FULL_RECORD_HEADER_SIZE + be_bytes) {
+            fail("The trace ends with a truncated record");
+            return;
+        }
+
+        const uint8_t* p = win + win_pos;
+        r.delay = p[0];
+        memcpy(&r.addr, p + 1, sizeof(uint64_t));
+        r.size = p[9] & 0xf;
+        r.size_value = 0;
+        r.op = p[10] >> 2;
+        r.need_rsp = (p[10] & 0x2) != 0;
+        r.uncacheable = (p[10] & 0x1) != 0;
+        r.full = true;
+        r.sid = p[11];
+        r.attr = p[12];
+        memcpy(r.be, p + HPDCACHE_TRACE_FULL_RECORD_HEADER_SIZE, be_bytes);
+        memset(r.wdata, 0, sizeof(r.wdata));
+
+        size_t len = HPDCACHE_TRACE_FULL_RECORD_HEADER_SIZE + be_bytes;
+        if (hpdcache_trace_op_has_data(r.op)) {
+            if (avail < len + data_bytes) {
+                fail("The trace ends with a truncated record");
+                return;
+            }
+            memcpy(r.wdata, p + len, data_bytes);
+            len += data_bytes;
+        }
+        win_pos += len;
+        cur_record++;
+    }
+
+    inline int is_big_endian()
+    {
+        int i = 1;
+        return !*((char*)&i);
+    }
+
+    uint64_t get_address(uint8_t size, uint64_t address_on_real_computer)
+    {
+        size <<= 2; // multiply by 4
+        if (size > HPDCACHE_REQ_DATA_WIDTH) {
+            Logger::warning("A value larger than the cache width need to be store");
+            exit(1);
+        }
+        if (!is_big_endian()) {
+            return address_on_real_computer + HPDCACHE_REQ_DATA_WIDTH - size;
+        } else {
+            return address_on_real_computer;
+        }
+    }
+
+    void my_close()
+    {
+        if (trace_descriptor < 0) {
+            return;
+        }
+        if (compressed) {
+            mz_inflateEnd(&stream);
+            compressed = false;
+        } else if (map_addr) {
+            munmap(map_addr, map_size);
+            map_addr = nullptr;
+        }
+        close(trace_descriptor);
+        trace_descriptor = -1;
+        win = nullptr;
+        win_pos = 0;
+        win_end = 0;
+        end_of_stream = true;
+        index.clear();
+        rois.clear();
+        next_chunk = 0;
+        full_records = false;
+    }
+
+private:
+    /**
+     * @brief Report a decoding error. This function does an exit(), unless the errors are
+     *        reported with has_failed(): the trace then ends at the current record
+     */
+    void fail(const std::string& msg)
+    {
+        if (exit_on_error) {
+            Logger::warning(msg);
+            exit(EXIT_FAILURE);
+        }
+        failed = true;
+        error_msg = msg;
+        end_record = cur_record;
+        end_of_stream = true;
+        win_pos = win_end;
+    }
+
+    /**
+     * @brief Map an uncompressed trace in memory. The whole trace is then the decoding window
+     */
+    void map_trace(const std::string& trace_name)
+    {
+        struct stat st;
+        if (fstat(trace_descriptor, &st) != 0) {
+            Logger::warning("The trace " + trace_name + " can't be read");
+            exit(EXIT_FAILURE);
+        }
+
+        map_size = st.st_size;
+        end_of_stream = true;
+        if (map_size == 0) {
+            return;
+        }
+
+        map_addr = mmap(nullptr, map_size, PROT_READ, MAP_PRIVATE, trace_descriptor, 0);
+        if (map_addr == MAP_FAILED) {
+            map_addr = nullptr;
+            Logger::warning("The trace " + trace_name + " can't be mapped in memory");
+            exit(EXIT_FAILURE);
+        }
+        madvise(map_addr, map_size, MADV_SEQUENTIAL);
+
+        win = (const uint8_t*)map_addr;
+        win_end = map_size;
+    }
+
+    /**
+     * @brief Read n bytes of the trace at a given offset. If not possible, this function reports
+     *        an error (see fail())
+     */
+    void read_at(void* dst, size_t n, uint64_t offset)
+    {
+        if (pread(trace_descriptor, dst, n, offset) != (ssize_t)n) {
+            fail("Error when reading the trace");
+        }
+    }
+
+    /**
+     * @brief Read the header, the ROI table and the chunk index of a version 2 trace
+     */
+    void open_v2(const std::string& trace_name)
+    {
+        compressed = false;
+        read_at(&header, sizeof(header), 0);
+        if ((header.version != HPDCACHE_TRACE_VERSION) || (header.header_size < sizeof(header))) {
+            Logger::warning("The trace " + trace_name + " has an unsupported version");
+            exit(EXIT_FAILURE);
+        }
+
+        full_records = (header.flags & HPDCACHE_TRACE_FLAG_FULL_RECORDS) != 0;
+        if (full_records && (header.req_data_width != HPDCACHE_REQ_DATA_WIDTH)) {
+            Logger::warning("The trace " + trace_name +
+                            " was captured with a different width of request data");
+            exit(EXIT_FAILURE);
+        }
+
+        if (header.index_offset != 0) {
+            index.resize(header.nb_chunks);
+            read_at(index.data(), index.size() * sizeof(hpdcache_trace_index_t), header.index_offset);
+        } else {
+            //  the trace was not closed properly: rebuild the index from the chunk headers
+            Logger::warning("The trace " + trace_name + " has no index, it is rebuilt");
+            hpdcache_trace_chunk_header_t ch;
+            uint64_t offset = header.header_size;
+            while ((pread(trace_descriptor, &ch, sizeof(ch), offset) == sizeof(ch)) &&
+                   (ch.magic == HPDCACHE_TRACE_CHUNK_MAGIC))
+            {
+                index.push_back({ offset, ch.first_record });
+                offset += sizeof(ch) + ch.data_size;
+            }
+        }
+
+        if ((header.nb_rois > 0) && (header.roi_offset != 0)) {
+            rois.resize(header.nb_rois);
+            read_at(rois.data(), rois.size() * sizeof(hpdcache_trace_roi_t), header.roi_offset);
+        }
+
+        win = nullptr;
+        next_chunk = 0;
+        end_of_stream = index.empty();
+    }
+
+    /**
+     * @brief Load (and decompress if needed) the next chunk of a version 2 trace into the window
+     */
+    void load_next_chunk()
+    {
+        const hpdcache_trace_index_t& e = index[next_chunk++];
+        hpdcache_trace_chunk_header_t ch;
+
+        read_at(&ch, sizeof(ch), e.offset);
+        if (failed) return;
+        if (ch.magic != HPDCACHE_TRACE_CHUNK_MAGIC) {
+            fail("The trace has a corrupted chunk");
+            return;
+        }
+
+        if (out_buf.size() < ch.raw_size) {
+            out_buf.resize(ch.raw_size);
+        }
+        if (header.flags & HPDCACHE_TRACE_FLAG_COMPRESSED) {
+            if (in_buf.size() < ch.data_size) {
+                in_buf.resize(ch.data_size);
+            }
+            read_at(in_buf.data(), ch.data_size, e.offset + sizeof(ch));
+            if (failed) return;
+            mz_ulong len = ch.raw_size;
+            if ((mz_uncompress(out_buf.data(), &len, in_buf.data(), ch.data_size) != MZ_OK) ||
+                (len != ch.raw_size))
+            {
+                fail("Error during decompression");
+                return;
+            }
+        } else {
+            read_at(out_buf.data(), ch.raw_size, e.offset + sizeof(ch));
+            if (failed) return;
+        }
+
+        win = out_buf.data();
+        win_pos = 0;
+        win_end = ch.raw_size;
+        cur_record = ch.first_record;
+        end_of_stream = (next_chunk >= index.size());
+    }
+
+    /**
+     * @brief Check if the trace starts with a zlib header: deflate method, window of at most
+     *        32 KiB, no preset dictionary and a valid check value
+     */
+    static bool is_zlib_header(const char* m)
+    {
+        const uint8_t cmf = m[0], flg = m[1];
+        return ((cmf & 0x0f) == 8) && ((cmf >> 4) <= 7) && ((flg & 0x20) == 0) &&
+               ((((unsigned)cmf << 8) | flg) % 31 == 0);
+    }
+
+    /**
+     * @brief Check if the trace starts with a gzip header (magic bytes and deflate method)
+     */
+    static bool is_gzip_header(const char* m)
+    {
+        return ((uint8_t)m[0] == 0x1f) && ((uint8_t)m[1] == 0x8b) && ((uint8_t)m[2] == 8);
+    }
+
+    /**
+     * @brief Move the file offset of the trace after its gzip header (RFC 1952)
+     */
+    void skip_gzip_header(const std::string& trace_name)
+    {
+        uint8_t h[10];
+        off_t off = sizeof(h);
+        bool ok = (pread(trace_descriptor, h, sizeof(h), 0) == sizeof(h));
+
+        //  optional fields: FEXTRA (bit 2), FNAME (bit 3), FCOMMENT (bit 4), FHCRC (bit 1)
+        const uint8_t flags = h[3];
+        if (ok && (flags & 0x04)) {
+            uint8_t xlen[2];
+            ok = (pread(trace_descriptor, xlen, sizeof(xlen), off) == sizeof(xlen));
+            off += sizeof(xlen) + (xlen[0] | (xlen[1] << 8));
+        }
+        for (int f : { 0x08, 0x10 }) {
+            if (!ok || !(flags & f)) continue;
+            char c;
+            do {
+                ok = (pread(trace_descriptor, &c, 1, off++) == 1);
+            } while (ok && (c != '\0'));
+        }
+        if (flags & 0x02) off += 2;
+
+        if (!ok || (lseek(trace_descriptor, off, SEEK_SET) != off)) {
+            Logger::warning("The gzip header of the trace " + trace_name + " is truncated");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /**
+     * @brief Initialize the decompression stream (zlib stream, or raw deflate stream for a
+     *        negative window_bits). The buffers are allocated only once
+     */
+    void init_stream(int window_bits)
+    {
+        memset(&stream, 0, sizeof(stream));
+        if (mz_inflateInit2(&stream, window_bits) != MZ_OK) {
+            Logger::warning("Error on the initialisation of the decompression\n");
+            exit(1);
+        }
+        in_buf.resize(TRACE_READER_INPUT_SIZE);
+        out_buf.resize(TRACE_READER_WINDOW_SIZE);
+        win = out_buf.data();
+        end_of_stream = false;
+    }
+
+    /**
+     * @brief Move the bytes not yet consumed to the beginning of the window, and fill the rest
+     *        of the window with decompressed data from the trace. For version 2 traces, load the
+     *        next chunk when the window is empty
+     */
+    void decompress_data_from_trace()
+    {
+        //  records of version 2 traces do not cross chunks
+        if (version >= 2) {
+            while ((win_pos == win_end) && (next_chunk < index.size()) && !failed) {
+                load_next_chunk();
+            }
+            return;
+        }
+
+        uint8_t* out = out_buf.data();
+        const size_t rem = win_end - win_pos;
+        memmove(out, out + win_pos, rem);
+        win_pos = 0;
+        win_end = rem;
+
+        while ((win_end < out_buf.size()) && !end_of_stream) {
+            if (stream.avail_in == 0) {
+                ssize_t n = read(trace_descriptor, in_buf.data(), in_buf.size());
+                if (n < 0) {
+                    fail("Error when reading the trace");
+                    return;
+                }
+                if (n == 0) {
+                    Logger::warning("The compressed trace ends unexpectedly\n");
+                    end_of_stream = true;
+                    break;
+                }
+                stream.next_in = in_buf.data();
+                stream.avail_in = n;
+            }
+
+            stream.next_out = out + win_end;
+            stream.avail_out = out_buf.size() - win_end;
+            int ret = mz_inflate(&stream, MZ_NO_FLUSH);
+            if ((ret != MZ_OK) && (ret != MZ_STREAM_END)) {
+                fail("Error during decompression");
+                return;
+            }
+            win_end = out_buf.size() - stream.avail_out;
+            end_of_stream = (ret == MZ_STREAM_END);
+        }
+    }
+
+    /**
+     * @brief Make at least n bytes available in the window, if the trace has them
+     *
+     * @return true if n bytes are available
+     */
+    inline bool ensure(size_t n)
+    {
+        if (((win_end - win_pos) < n) && !end_of_stream) {
+            decompress_data_from_trace();
+        }
+        return (win_end - win_pos) >= n;
+    }
+};
+
+/**
+ * @brief Nb of decoded records that the prefetcher can keep ahead of the simulation
+ */
+#define TRACE_PREFETCH_RING_SIZE (1 << 16)
+
+/**
+ * @class trace_prefetcher
+ * @brief Decode a trace in a producer thread. The trace is decompressed and decoded ahead of the
+ *        simulation into a ring of records, so the simulation thread only pops decoded records
+ */
+class trace_prefetcher
+{
+private:
+    trace_reader reader;
+    Spsc_ring<trace_record_t> ring;
+    std::atomic<bool> done;
+    std::atomic<bool> stop;
+    std::thread producer;
+
+    void produce()
+    {
+        trace_record_t r;
+        while (!stop.load(std::memory_order_relaxed) && !reader.is_finish()) {
+            reader.read_record(r);
+            if (reader.has_failed()) {
+                break;
+            }
+            for (unsigned spin = 0; !ring.try_push(r); spin++) {
+                if (stop.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                //  the ring is full: the simulation is the bottleneck, do not burn a core
+                if (spin < 64) {
+                    std::this_thread::yield();
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+        }
+        done.store(true, std::memory_order_release);
+    }
+
+public:
+    /**
+     * @param trace_name The name of the trace
+     * @param roi Index of the region of interest to read (negative: read the whole trace)
+     * @param skip Nb of records to skip at the beginning of the trace (or of the region)
+     */
+    trace_prefetcher(std::string trace_name, int roi = -1, uint64_t skip = 0)
+      : reader(trace_name)
+      , ring(TRACE_PREFETCH_RING_SIZE)
+      , done(false)
+      , stop(false)
+    {
+        if (roi >= 0) {
+            reader.select_roi(roi);
+        }
+        if (skip > 0) {
+            if (!reader.is_seekable()) {
+                Logger::warning("The trace is not seekable, the skipped records are decoded");
+            }
+            reader.seek_record(reader.get_record() + skip);
+        }
+
+        //  an exit() from the producer thread would run the static destructors while the
+        //  simulation thread still uses the ring: the errors are reported by has_failed()
+        reader.set_exit_on_error(false);
+        producer = std::thread(&trace_prefetcher::produce, this);
+    }
+
+    ~trace_prefetcher() { my_close(); }
+
+    /**
+     * @brief Get the next decoded record of the trace. Wait for the producer if it is late
+     *
+     * @param r The decoded record
+     * @return false when all the records of the trace have been read
+     */
+    bool pop(trace_record_t& r)
+    {
+        while (!ring.try_pop(r)) {
+            if (done.load(std::memory_order_acquire)) {
+                //  the producer may have pushed its last records before setting the done flag
+                return ring.try_pop(r);
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Return true if the decoding of the trace stopped on an error. This shall be
+     *        checked once pop() returns false
+     */
+    bool has_failed() const { return done.load(std::memory_order_acquire) && reader.has_failed(); }
+
+    const std::string& get_error() const { return reader.get_error(); }
+
+    void my_close()
+    {
+        if (producer.joinable()) {
+            stop.store(true, std::memory_order_relaxed);
+            producer.join();
+        }
+        reader.my_close();
+    }
+};
+
+#endif // __HPDCACHE_TEST_TRACE_READER__
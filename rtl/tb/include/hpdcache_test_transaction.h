@@ -12,7 +12,9 @@
 #ifndef __HPDCACHE_TEST_TRANSACTION_H__
 #define __HPDCACHE_TEST_TRANSACTION_H__
 
+#include <cstring>
 #include <sstream>
+#include <vector>
 #include <verilated.h>
 
 #include "hpdcache_fault_injection.h"
@@ -382,6 +384,7 @@ public:
     uint32_t command;
     uint32_t atomic;
     bool cacheable;
+    bool wrap; //  wrapping burst (read requests only)
 
     hpdcache_test_transaction_mem_req()
       : addr(0)
@@ -391,6 +394,7 @@ public:
       , command(0)
       , atomic(0)
       , cacheable(false)
+      , wrap(false)
     {
     }
 
@@ -497,7 +501,8 @@ public:
         os << "MEM_READ_REQ / @ = " << std::hex << addr << std::dec
            << " / CMD = " << command_to_string(command) << " / LEN = " << std::hex << len
            << std::dec << " / SIZE = " << std::hex << size << std::dec << " / ID = 0x" << std::hex
-           << id << std::dec << (cacheable ? " / CACHEABLE" : " / UNCACHEABLE");
+           << id << std::dec << (cacheable ? " / CACHEABLE" : " / UNCACHEABLE")
+           << (wrap ? " / WRAP" : "");
         return os.str();
     }
 
@@ -512,15 +517,21 @@ public:
 class hpdcache_test_transaction_mem_write_req : public hpdcache_test_transaction_mem_req
 {
 public:
-    sc_bv<HPDCACHE_MEM_DATA_WIDTH> data;
-    sc_bv<HPDCACHE_MEM_DATA_WIDTH / 8> be;
+    //  Data and byte enable of each flit of the burst (len + 1 flits)
+    std::vector<sc_bv<HPDCACHE_MEM_DATA_WIDTH>> data;
+    std::vector<sc_bv<HPDCACHE_MEM_DATA_WIDTH / 8>> be;
     bool last;
 
+    //  Index of the first flit of the burst with an unexpected last flag (-1
+    //  if only the last flit has the last flag)
+    int bad_last_flit;
+
     hpdcache_test_transaction_mem_write_req()
-      : data(0)
-      , be(0)
+      : hpdcache_test_transaction_mem_req()
+      , data(1, 0)
+      , be(1, 0)
       , last(false)
-      , hpdcache_test_transaction_mem_req()
+      , bad_last_flit(-1)
     {
     }
 
@@ -536,9 +547,12 @@ public:
         }
 
         os << " / LEN = " << std::hex << len << std::dec << " / SIZE = " << std::hex << size
-           << std::dec << " / ID = 0x" << std::hex << id << std::dec
-           << " / DATA = " << data.to_string(SC_HEX) << " / BE = " << be.to_string(SC_HEX)
-           << (last ? " / LAST" : " ") << (cacheable ? " / CACHEABLE" : " / UNCACHEABLE");
+           << std::dec << " / ID = 0x" << std::hex << id << std::dec;
+        for (size_t i = 0; i < data.size(); i++) {
+            os << " / DATA = " << data[i].to_string(SC_HEX)
+               << " / BE = " << be[i].to_string(SC_HEX);
+        }
+        os << (last ? " / LAST" : " ") << (cacheable ? " / CACHEABLE" : " / UNCACHEABLE");
         return os.str();
     }
 
@@ -615,5 +629,35 @@ public:
     }
 };
 
+//  Conversion of the data (byte enable) of the transactions to (from) arrays of
+//  bytes (little-endian, one bit of byte enable per byte), as used by the
+//  functional models shared with the cc testbench
+template<int W>
+inline void
+hpdcache_test_bv_to_bytes(const sc_bv<W>& v, uint8_t* buf)
+{
+    for (int i = 0; i < W / 64; i++) {
+        const uint64_t w = v.range((i + 1) * 64 - 1, i * 64).to_uint64();
+        memcpy(buf + i * 8, &w, 8);
+    }
+    for (int i = (W / 64) * 8; i < W / 8; i++) {
+        buf[i] = v.range((i + 1) * 8 - 1, i * 8).to_uint();
+    }
+}
+
+template<int W>
+inline void
+hpdcache_test_bytes_to_bv(const uint8_t* buf, sc_bv<W>& v)
+{
+    for (int i = 0; i < W / 64; i++) {
+        uint64_t w;
+        memcpy(&w, buf + i * 8, 8);
+        v.range((i + 1) * 64 - 1, i * 64) = w;
+    }
+    for (int i = (W / 64) * 8; i < W / 8; i++) {
+        v.range((i + 1) * 8 - 1, i * 8) = buf[i];
+    }
+}
+
 #endif /* __HPDCACHE_TEST_TRANSACTION_H__ */
 // vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
@@ -0,0 +1,167 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Definition of the binary trace container (version 2). This
+ *               header is shared by the QEMU plugin (C) and the testbench
+ *               trace reader (C++).
+ */
+#ifndef __HPDCACHE_TRACE_FORMAT_H__
+#define __HPDCACHE_TRACE_FORMAT_H__
+
+#include <stdint.h>
+
+/*
+ *  Layout of a version 2 trace (all fields are little-endian):
+ *
+ *      +--------------------------------+  offset 0
+ *      | hpdcache_trace_header_t        |
+ *      +--------------------------------+  header_size
+ *      | hpdcache_trace_chunk_header_t  |
+ *      | chunk data (data_size bytes)   |
+ *      +--------------------------------+
+ *      | ... (nb_chunks chunks)         |
+ *      +--------------------------------+  roi_offset
+ *      | hpdcache_trace_roi_t[nb_rois]  |
+ *      +--------------------------------+  index_offset
+ *      | hpdcache_trace_index_t         |
+ *      |     [nb_chunks]                |
+ *      +--------------------------------+
+ *
+ *  Each chunk holds a whole number of records. When the COMPRESSED flag is
+ *  set, the data of each chunk is an independent zlib stream, so any chunk can
+ *  be decoded without the previous ones. The header is rewritten when the
+ *  trace is closed. If this did not happen (e.g. the traced program crashed),
+ *  index_offset is zero and readers rebuild the index by walking the chunk
+ *  headers.
+ *
+ *  A record has the same encoding as in version 1 traces (which are a bare
+ *  sequence of records, optionally compressed as a single zlib stream):
+ *
+ *      byte  0      : delay (nb of instructions since the previous access)
+ *      bytes 1..8   : address
+ *      byte  9      : bits [3:0] log2 of the access size in bytes
+ *                     bits [7:4] size of the store value (0: 1 byte,
+ *                                1: 2 bytes, 2: 4 bytes, 3 and 4: 8 bytes)
+ *      byte  10     : bits [7:2] operation type
+ *                     bit  1     need response
+ *                     bit  0     uncacheable
+ *      bytes 11..   : store value (stores only)
+ *
+ *  When the FULL_RECORDS flag is set (traces captured by the testbench), the
+ *  records keep all the fields of a request of the HPDcache:
+ *
+ *      byte  0      : delay (nb of cycles before the next request)
+ *      bytes 1..8   : address
+ *      byte  9      : bits [3:0] log2 of the access size in bytes
+ *      byte  10     : bits [7:2] operation type
+ *                     bit  1     need response
+ *                     bit  0     uncacheable
+ *      byte  11     : source ID
+ *      byte  12     : bit  0     physically indexed
+ *                     bit  1     IO
+ *                     bit  2     aborted
+ *                     bits [5:3] write policy hint
+ *      bytes 13..   : byte enables, one byte per 64 bits of request data
+ *                     (ceil(req_data_width / 64) bytes)
+ *      then         : request data (req_data_width / 8 bytes), only for the
+ *                     operations with write data (stores and AMOs, see
+ *                     hpdcache_trace_op_has_data())
+ */
+
+#define HPDCACHE_TRACE_MAGIC "HPDTRACE"
+#define HPDCACHE_TRACE_MAGIC_SIZE 8
+#define HPDCACHE_TRACE_VERSION 2
+#define HPDCACHE_TRACE_CHUNK_MAGIC 0x4b4e4843u /* "CHNK" */
+#define HPDCACHE_TRACE_CONFIG_SIZE 28
+
+/*  Default nb of records per chunk */
+#define HPDCACHE_TRACE_CHUNK_RECORDS (1u << 16)
+
+/*  Size in bytes of the fixed part of a record, and maximum size of a record */
+#define HPDCACHE_TRACE_RECORD_HEADER_SIZE 11
+#define HPDCACHE_TRACE_RECORD_MAX_SIZE (HPDCACHE_TRACE_RECORD_HEADER_SIZE + 8)
+
+/*  Size in bytes of the fixed part of a full record */
+#define HPDCACHE_TRACE_FULL_RECORD_HEADER_SIZE 13
+
+/*  Operation types (same encoding as the requests of the HPDcache) */
+#define HPDCACHE_TRACE_OP_LOAD 0x00
+#define HPDCACHE_TRACE_OP_STORE 0x01
+#define HPDCACHE_TRACE_OP_AMO_LR 0x04
+#define HPDCACHE_TRACE_OP_AMO_SC 0x05
+#define HPDCACHE_TRACE_OP_AMO_MINU 0x0e
+#define HPDCACHE_TRACE_OP_CMO_FENCE 0x10
+#define HPDCACHE_TRACE_OP_CMO_PREFETCH 0x11
+#define HPDCACHE_TRACE_OP_CMO_INVAL_NLINE 0x12
+#define HPDCACHE_TRACE_OP_CMO_INVAL_ALL 0x13
+#define HPDCACHE_TRACE_OP_CMO_FLUSH_NLINE 0x14
+#define HPDCACHE_TRACE_OP_CMO_FLUSH_ALL 0x15
+#define HPDCACHE_TRACE_OP_CMO_FLUSH_INVAL_NLINE 0x16
+#define HPDCACHE_TRACE_OP_CMO_FLUSH_INVAL_ALL 0x17
+
+/*  Write policy hints (bits [5:3] of the attributes of full records) */
+#define HPDCACHE_TRACE_WR_POLICY_AUTO 0x1
+#define HPDCACHE_TRACE_WR_POLICY_WB 0x2
+#define HPDCACHE_TRACE_WR_POLICY_WT 0x4
+
+/*  Header flags */
+#define HPDCACHE_TRACE_FLAG_COMPRESSED (1u << 0)
+#define HPDCACHE_TRACE_FLAG_FULL_RECORDS (1u << 1)
+
+typedef struct
+{
+    char magic[HPDCACHE_TRACE_MAGIC_SIZE]; /* HPDCACHE_TRACE_MAGIC (not null-terminated) */
+    uint16_t version;                      /* HPDCACHE_TRACE_VERSION */
+    uint16_t header_size;                  /* sizeof(hpdcache_trace_header_t) */
+    uint16_t addr_width;                   /* width in bits of the addresses of the target */
+    uint16_t word_width;                   /* width in bits of the words of the target */
+    uint32_t nb_vcpus;                     /* nb of vCPUs of the traced system */
+    uint32_t flags;                        /* HPDCACHE_TRACE_FLAG_* */
+    uint32_t chunk_records;                /* maximum nb of records per chunk */
+    uint32_t nb_rois;                      /* nb of regions of interest */
+    uint64_t nb_chunks;                    /* nb of chunks */
+    uint64_t nb_records;                   /* nb of records in the trace */
+    uint64_t roi_offset;                   /* file offset of the ROI table */
+    uint64_t index_offset;                 /* file offset of the chunk index (0: no index) */
+    uint32_t req_data_width;               /* width in bits of the data of full records */
+    char config[HPDCACHE_TRACE_CONFIG_SIZE]; /* name of the traced target (null-terminated) */
+} hpdcache_trace_header_t;
+
+typedef struct
+{
+    uint32_t magic;        /* HPDCACHE_TRACE_CHUNK_MAGIC */
+    uint32_t data_size;    /* nb of bytes of data after this header */
+    uint32_t raw_size;     /* nb of bytes of records (after decompression) */
+    uint32_t nb_records;   /* nb of records in the chunk */
+    uint64_t first_record; /* index in the trace of the first record of the chunk */
+} hpdcache_trace_chunk_header_t;
+
+typedef struct
+{
+    uint64_t offset;       /* file offset of the chunk header */
+    uint64_t first_record; /* index in the trace of the first record of the chunk */
+} hpdcache_trace_index_t;
+
+typedef struct
+{
+    uint64_t begin; /* index of the first record of the region */
+    uint64_t end;   /* index of the first record after the region */
+} hpdcache_trace_roi_t;
+
+/*  Return non-zero if the records of the given operation carry write data */
+static inline int
+hpdcache_trace_op_has_data(unsigned op)
+{
+    return (op == HPDCACHE_TRACE_OP_STORE) ||
+           ((op >= HPDCACHE_TRACE_OP_AMO_SC) && (op <= HPDCACHE_TRACE_OP_AMO_MINU));
+}
+
+/*  The structures are written as is in the trace, they shall not have any padding */
+typedef char hpdcache_trace_header_size_check[(sizeof(hpdcache_trace_header_t) == 96) ? 1 : -1];
+typedef char hpdcache_trace_chunk_size_check
+    [(sizeof(hpdcache_trace_chunk_header_t) == 24) ? 1 : -1];
+
+#endif /* __HPDCACHE_TRACE_FORMAT_H__ */
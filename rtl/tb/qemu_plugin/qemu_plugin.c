@@ -13,9 +13,11 @@
 #include <inttypes.h>
 #include <qemu-plugin.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
+#include "hpdcache_trace_format.h"
 #include "miniz.h"
 QEMU_PLUGIN_EXPORT int qemu_plugin_version = QEMU_PLUGIN_VERSION;
 
@@ -41,6 +43,24 @@ int file_descriptor;         // The file where we store data
 mz_stream* stream = NULL;    // We use this to compress data
 int current_instruction = 0; // count the number of instructions between two accesses in memory
 
+// Binary traces use the version 2 format (see hpdcache_trace_format.h)
+hpdcache_trace_header_t trace_header;      // header of the trace, rewritten when closing it
+unsigned char* chunk_buffer = NULL;        // records of the current chunk
+size_t chunk_size = 0;                     // nb of bytes in the current chunk
+uint32_t chunk_records = 0;                // nb of records in the current chunk
+unsigned char* chunk_compressed = NULL;    // compressed data of the current chunk
+mz_ulong chunk_compressed_size = 0;        // size of the buffer of compressed data
+hpdcache_trace_index_t* trace_index = NULL; // index of the chunks
+size_t trace_index_capacity = 0;
+hpdcache_trace_roi_t* trace_rois = NULL;   // regions of interest
+size_t trace_rois_capacity = 0;
+uint64_t file_offset = 0; // offset of the next write in the file
+
+// Markers of regions of interest. These are RISC-V HINT instructions (no architectural effect)
+// that the traced program executes at the beginning and at the end of each region
+#define ROI_BEGIN_INSN 0x00102013u // slti x0, x0, 1
+#define ROI_END_INSN 0x00202013u   // slti x0, x0, 2
+
 /**
  * @brief This function is used to create a stream. This must be call only one time before the first
  * write in the file
@@ -160,6 +180,11 @@ set_mode(char* arg)
 static void
 write_buffer(char* data, int size)
 {
+    if (mode == WRITE_BINARY) {
+        memcpy(chunk_buffer + chunk_size, data, size);
+        chunk_size += size;
+        return;
+    }
 
     if (need_to_compress) {
         for (int i = 0; i < size; i++) {
@@ -181,11 +206,8 @@ write_buffer(char* data, int size)
 static void
 write_address(uint64_t* address)
 {
-    if (is_64_bits) {
-        write_buffer((char*)(address), sizeof(uint64_t));
-    } else {
-        write_buffer((char*)((uint32_t*)address), sizeof(uint32_t));
-    }
+    // Addresses are always stored on 8 bytes. The header gives the width of the target addresses
+    write_buffer((char*)(address), sizeof(uint64_t));
 }
 
 static void
@@ -261,13 +283,153 @@ write_value(qemu_plugin_mem_value value)
             write_buffer((char*)&(value.data.u64), sizeof(uint64_t));
             break;
         case QEMU_PLUGIN_MEM_VALUE_U128:
-            //  TODO use like this
-            //  value.data.u128.low = low;
-            //  value.data.u128.high = current_cpu->neg.plugin_mem_value_high;
+            //  The record keeps the low 64 bits of the value
+            write_buffer((char*)&(value.data.u128.low), sizeof(uint64_t));
             break;
     }
 }
 
+/**
+ * @brief Write a buffer in the file, or exit if this is not possible
+ */
+static void
+write_all(const void* data, size_t size)
+{
+    const char* p = data;
+    while (size > 0) {
+        ssize_t n = write(file_descriptor, p, size);
+        if (n <= 0) {
+            fprintf(stderr, "Error, can't write in the file\n");
+            exit(1);
+        }
+        p += n;
+        size -= n;
+    }
+    file_offset += (p - (const char*)data);
+}
+
+/**
+ * @brief Grow an array if it is full
+ */
+static void*
+grow_array(void* array, size_t* capacity, size_t used, size_t elem_size)
+{
+    if (used < *capacity) {
+        return array;
+    }
+    *capacity = (*capacity == 0) ? 64 : (*capacity * 2);
+    array = realloc(array, *capacity * elem_size);
+    if (!array) {
+        perror("Error in memory allocation");
+        exit(1);
+    }
+    return array;
+}
+
+/**
+ * @brief Write the header of a version 2 trace, and allocate the buffers of the chunks
+ *
+ * @param info information about the traced system
+ */
+static void
+open_trace_v2(const qemu_info_t* info)
+{
+    memset(&trace_header, 0, sizeof(trace_header));
+    memcpy(trace_header.magic, HPDCACHE_TRACE_MAGIC, HPDCACHE_TRACE_MAGIC_SIZE);
+    trace_header.version = HPDCACHE_TRACE_VERSION;
+    trace_header.header_size = sizeof(hpdcache_trace_header_t);
+    trace_header.addr_width = is_64_bits ? 64 : 32;
+    trace_header.word_width = is_64_bits ? 64 : 32;
+    trace_header.req_data_width = trace_header.word_width;
+    trace_header.nb_vcpus = info->system_emulation ? info->system.max_vcpus : 1;
+    trace_header.flags = need_to_compress ? HPDCACHE_TRACE_FLAG_COMPRESSED : 0;
+    trace_header.chunk_records = HPDCACHE_TRACE_CHUNK_RECORDS;
+    strncpy(trace_header.config, info->target_name, HPDCACHE_TRACE_CONFIG_SIZE - 1);
+
+    size_t max_chunk_size = (size_t)HPDCACHE_TRACE_CHUNK_RECORDS * HPDCACHE_TRACE_RECORD_MAX_SIZE;
+    chunk_compressed_size = mz_compressBound(max_chunk_size);
+    chunk_buffer = malloc(max_chunk_size);
+    chunk_compressed = malloc(chunk_compressed_size);
+    if (!chunk_buffer || !chunk_compressed) {
+        perror("Error in memory allocation");
+        exit(1);
+    }
+
+    write_all(&trace_header, sizeof(trace_header));
+}
+
+/**
+ * @brief Write the current chunk (compressed if requested) in the file, and add it to the index
+ */
+static void
+flush_chunk(void)
+{
+    hpdcache_trace_chunk_header_t ch;
+    const unsigned char* data = chunk_buffer;
+    mz_ulong data_size = chunk_size;
+
+    if (chunk_records == 0) {
+        return;
+    }
+
+    if (need_to_compress) {
+        data_size = chunk_compressed_size;
+        if (mz_compress2(chunk_compressed, &data_size, chunk_buffer, chunk_size, MZ_BEST_SPEED) !=
+            MZ_OK) {
+            fprintf(stderr, "Error during compression\n");
+            exit(1);
+        }
+        data = chunk_compressed;
+    }
+
+    ch.magic = HPDCACHE_TRACE_CHUNK_MAGIC;
+    ch.data_size = data_size;
+    ch.raw_size = chunk_size;
+    ch.nb_records = chunk_records;
+    ch.first_record = trace_header.nb_records;
+
+    trace_index = grow_array(
+        trace_index, &trace_index_capacity, trace_header.nb_chunks, sizeof(*trace_index));
+    trace_index[trace_header.nb_chunks].offset = file_offset;
+    trace_index[trace_header.nb_chunks].first_record = ch.first_record;
+    trace_header.nb_chunks++;
+    trace_header.nb_records += chunk_records;
+
+    write_all(&ch, sizeof(ch));
+    write_all(data, data_size);
+    chunk_size = 0;
+    chunk_records = 0;
+}
+
+/**
+ * @brief Write the last chunk, the ROI table and the index, then rewrite the header
+ */
+static void
+close_trace_v2(void)
+{
+    flush_chunk();
+
+    for (uint32_t i = 0; i < trace_header.nb_rois; i++) {
+        if (trace_rois[i].end == UINT64_MAX) {
+            trace_rois[i].end = trace_header.nb_records;
+        }
+    }
+    trace_header.roi_offset = file_offset;
+    write_all(trace_rois, trace_header.nb_rois * sizeof(*trace_rois));
+    trace_header.index_offset = file_offset;
+    write_all(trace_index, trace_header.nb_chunks * sizeof(*trace_index));
+
+    if (pwrite(file_descriptor, &trace_header, sizeof(trace_header), 0) != sizeof(trace_header)) {
+        fprintf(stderr, "Error, can't write in the file\n");
+        exit(1);
+    }
+
+    free(chunk_buffer);
+    free(chunk_compressed);
+    free(trace_index);
+    free(trace_rois);
+}
+
 /**
  * @brief Open a file and truncate it if it already exists else we create it
  *
@@ -325,6 +487,11 @@ write_in_file(bool is_store,
     if (is_store) {
         write_value(value); // 8 bytes
     }
+
+    // A record never crosses chunks
+    if (++chunk_records == trace_header.chunk_records) {
+        flush_chunk();
+    }
     return;
 }
 
@@ -403,7 +570,9 @@ mem_cb(unsigned int vcpu_index, qemu_plugin_meminfo_t info, uint64_t vaddr, void
 static void
 plugin_exit(qemu_plugin_id_t id, void* p)
 {
-    if (need_to_compress) {
+    if (mode == WRITE_BINARY) {
+        close_trace_v2();
+    } else if (need_to_compress) {
         compress_data_to_file(MZ_FINISH);
     }
     if (mode != NO_WRITE) {
@@ -424,6 +593,34 @@ counter_inst(unsigned int vcpu_index, void* userdata)
     current_instruction++;
 }
 
+/**
+ * @brief This function is called when a ROI marker instruction is executed. It opens or closes a
+ * region of interest at the next record of the trace
+ *
+ * @param vcpu_index Don't care
+ * @param userdata  Non-NULL for the beginning of a region, NULL for the end
+ */
+static void
+roi_marker(unsigned int vcpu_index, void* userdata)
+{
+    uint64_t record = trace_header.nb_records + chunk_records;
+    hpdcache_trace_roi_t* last =
+        (trace_header.nb_rois > 0) ? &trace_rois[trace_header.nb_rois - 1] : NULL;
+
+    if (userdata) {
+        if (last && (last->end == UINT64_MAX)) {
+            return; // the region is already open
+        }
+        trace_rois =
+            grow_array(trace_rois, &trace_rois_capacity, trace_header.nb_rois, sizeof(*trace_rois));
+        trace_rois[trace_header.nb_rois].begin = record;
+        trace_rois[trace_header.nb_rois].end = UINT64_MAX;
+        trace_header.nb_rois++;
+    } else if (last && (last->end == UINT64_MAX)) {
+        last->end = record;
+    }
+}
+
 /**
  * @brief This function is called when a tb (translation block) is ready. We can register ourself
  * to be call on a certain instruction We register on each instruction just to increase the
@@ -441,6 +638,15 @@ tb_trans_cb(qemu_plugin_id_t id, struct qemu_plugin_tb* tb)
         qemu_plugin_register_vcpu_mem_cb(
             insn, mem_cb, QEMU_PLUGIN_CB_NO_REGS, QEMU_PLUGIN_MEM_RW, NULL);
         qemu_plugin_register_vcpu_insn_exec_cb(insn, counter_inst, 0, NULL);
+
+        uint32_t opcode = 0;
+        if ((mode == WRITE_BINARY) && (qemu_plugin_insn_size(insn) == sizeof(opcode))) {
+            qemu_plugin_insn_data(insn, &opcode, sizeof(opcode));
+            if ((opcode == ROI_BEGIN_INSN) || (opcode == ROI_END_INSN)) {
+                qemu_plugin_register_vcpu_insn_exec_cb(
+                    insn, roi_marker, 0, (opcode == ROI_BEGIN_INSN) ? (void*)1 : NULL);
+            }
+        }
     }
 }
 
@@ -477,6 +683,9 @@ qemu_plugin_install(qemu_plugin_id_t id, const qemu_info_t* info, int argc, char
     printf("architecture: %s\n", info->target_name);
     is_64_bits = (strcmp(info->target_name, "riscv64") == 0);
     buffer_begin = 0;
+    if (mode == WRITE_BINARY) {
+        open_trace_v2(info);
+    }
     qemu_plugin_register_vcpu_tb_trans_cb(id, tb_trans_cb);
     qemu_plugin_register_atexit_cb(id, plugin_exit, NULL);
     return 0;
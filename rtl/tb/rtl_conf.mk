@@ -104,6 +104,9 @@ endif
 ifdef CONF_HPDCACHE_REFILL_CORE_RSP_FEEDTHROUGH
   CONF_DEFINES += -DCONF_HPDCACHE_REFILL_CORE_RSP_FEEDTHROUGH=$(CONF_HPDCACHE_REFILL_CORE_RSP_FEEDTHROUGH)
 endif
+ifdef CONF_HPDCACHE_REFILL_CRITICAL_WORD_FIRST
+  CONF_DEFINES += -DCONF_HPDCACHE_REFILL_CRITICAL_WORD_FIRST=$(CONF_HPDCACHE_REFILL_CRITICAL_WORD_FIRST)
+endif
 ifdef CONF_HPDCACHE_RTAB_ENTRIES
   CONF_DEFINES += -DCONF_HPDCACHE_RTAB_ENTRIES=$(CONF_HPDCACHE_RTAB_ENTRIES)
 endif
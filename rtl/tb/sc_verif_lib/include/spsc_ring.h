@@ -0,0 +1,105 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ *
+ *  Licensed under the Solderpad Hardware License v 2.1 (the “License”); you
+ *  may not use this file except in compliance with the License, or, at your
+ *  option, the Apache License version 2.0. You may obtain a copy of the
+ *  License at
+ *
+ *  https://solderpad.org/licenses/SHL-2.1/
+ *
+ *  Unless required by applicable law or agreed to in writing, any work
+ *  distributed under the License is distributed on an “AS IS” BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *  License for the specific language governing permissions and limitations
+ *  under the License.
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Generic class definition of a lock-free single-producer
+ *               single-consumer ring buffer
+ */
+#ifndef __SPSC_RING_H__
+#define __SPSC_RING_H__
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class Spsc_ring
+ * @brief Bounded ring buffer of fixed-size elements shared by exactly one producer thread and
+ *        one consumer thread. Neither side takes a lock: the producer only writes the tail
+ *        index and the consumer only writes the head index
+ */
+template<typename T>
+class Spsc_ring
+{
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+public:
+    Spsc_ring(size_t capacity)
+      : head(0)
+      , tail(0)
+      , head_cache(0)
+      , tail_cache(0)
+    {
+        size_t sz = 2;
+        while (sz < capacity) sz <<= 1;
+        buf.resize(sz);
+        mask = sz - 1;
+    }
+
+    size_t capacity() const { return buf.size(); }
+
+    /**
+     * @brief Producer side. Return false if the ring is full
+     */
+    bool try_push(const T& e)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if ((t - head_cache) == buf.size()) {
+            head_cache = head.load(std::memory_order_acquire);
+            if ((t - head_cache) == buf.size()) {
+                return false;
+            }
+        }
+        buf[t & mask] = e;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side. Return false if the ring is empty
+     */
+    bool try_pop(T& e)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail_cache) {
+            tail_cache = tail.load(std::memory_order_acquire);
+            if (h == tail_cache) {
+                return false;
+            }
+        }
+        e = buf[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> buf;
+    size_t mask;
+
+    //  the indexes are kept in separate cache lines to avoid false sharing between the producer
+    //  and the consumer. Each side keeps a private copy of the index of the other side, and only
+    //  reloads it when the ring looks full (producer) or empty (consumer)
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    alignas(64) size_t head_cache;
+    alignas(64) size_t tail_cache;
+};
+
+#endif // __SPSC_RING_H__
@@ -25,8 +25,11 @@
 #ifndef __GENERIC_CACHE_DATA_H__
 #define __GENERIC_CACHE_DATA_H__
 
+#include <cassert>
+#include <cstdint>
+#include <iostream>
 #include <string>
-#include <systemc>
+#include <vector>
 
 class GenericCacheData
 {
@@ -38,9 +41,9 @@ public:
       , sets_m(nsets)
       , words_m(nwords)
     {
-        sc_assert(nsets > 0);
-        sc_assert(nways > 0);
-        sc_assert(nwords > 0);
+        assert(nsets > 0);
+        assert(nways > 0);
+        assert(nwords > 0);
     }
 
     ~GenericCacheData() {}
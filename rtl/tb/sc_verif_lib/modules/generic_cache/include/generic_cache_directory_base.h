@@ -25,8 +25,11 @@
 #ifndef __GENERIC_CACHE_DIRECTORY_BASE_H__
 #define __GENERIC_CACHE_DIRECTORY_BASE_H__
 
+#include <cassert>
+#include <climits>
+#include <cstdint>
+#include <iostream>
 #include <string>
-#include <systemc>
 
 class GenericCacheDirectoryBase
 {
@@ -46,15 +49,15 @@ public:
       , sets_m(nsets)
       , bytes_m(nbytes)
     {
-        sc_assert(nsets > 0);
-        sc_assert(nways > 0);
-        sc_assert(nbytes > 0);
+        assert(nsets > 0);
+        assert(nways > 0);
+        assert(nbytes > 0);
 
         tag_m = new uint64_t[nways * nsets];
         val_m = new bool[nways * nsets];
     }
 
-    ~GenericCacheDirectoryBase()
+    virtual ~GenericCacheDirectoryBase()
     {
         delete[] tag_m;
         delete[] val_m;
@@ -80,7 +83,7 @@ public:
 
     inline uint64_t getAddrSet(uint64_t addr) { return (addr / bytes_m) % sets_m; }
 
-    void reset()
+    virtual void reset()
     {
         for (unsigned int way = 0; way < ways_m; way++) {
             for (unsigned int set = 0; set < sets_m; set++) {
@@ -0,0 +1,106 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ *
+ *  Licensed under the Solderpad Hardware License v 2.1 (the “License”); you
+ *  may not use this file except in compliance with the License, or, at your
+ *  option, the Apache License version 2.0. You may obtain a copy of the
+ *  License at
+ *
+ *  https://solderpad.org/licenses/SHL-2.1/
+ *
+ *  Unless required by applicable law or agreed to in writing, any work
+ *  distributed under the License is distributed on an “AS IS” BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *  License for the specific language governing permissions and limitations
+ *  under the License.
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Class definition of a cache directory using a (true) LRU
+ *               replacement policy
+ */
+#ifndef __GENERIC_CACHE_DIRECTORY_LRU_H__
+#define __GENERIC_CACHE_DIRECTORY_LRU_H__
+
+#include <cassert>
+#include <string>
+
+#include "generic_cache_directory_base.h"
+
+class GenericCacheDirectoryLru : public GenericCacheDirectoryBase
+{
+    uint64_t* stamp_m;
+    uint64_t clock_m;
+
+public:
+    GenericCacheDirectoryLru(const std::string& name, size_t nways, size_t nsets, size_t nbytes)
+      : GenericCacheDirectoryBase(name, nways, nsets, nbytes)
+      , clock_m(0)
+    {
+        stamp_m = new uint64_t[nways * nsets];
+    }
+
+    ~GenericCacheDirectoryLru() { delete[] stamp_m; }
+
+    uint64_t& getCacheStamp(size_t way, size_t set) { return stamp_m[way * sets_m + set]; }
+
+    virtual void reset()
+    {
+        GenericCacheDirectoryBase::reset();
+
+        for (size_t way = 0; way < ways_m; way++) {
+            for (size_t set = 0; set < sets_m; set++) {
+                getCacheStamp(way, set) = 0;
+            }
+        }
+        clock_m = 0;
+    }
+
+    virtual bool repl(uint64_t addr, uint64_t* victim_tag, size_t* victim_way, size_t* victim_set)
+    {
+        uint64_t tag;
+        size_t set;
+        size_t victim;
+        bool evict;
+
+        set = getAddrSet(addr);
+        tag = getAddrTag(addr);
+
+        //  look if there is an empty way, otherwise select the least recently used one
+        victim = 0;
+        evict = true;
+        for (size_t way = 0; way < ways_m; way++) {
+            if (!getCacheValid(way, set)) {
+                victim = way;
+                evict = false;
+                break;
+            }
+            if (getCacheStamp(way, set) < getCacheStamp(victim, set)) {
+                victim = way;
+            }
+        }
+
+        //  get victim entry information
+        if (victim_tag != nullptr) {
+            *victim_tag = evict ? getCacheTag(victim, set) : 0;
+        }
+        if (victim_way != nullptr) {
+            *victim_way = victim;
+        }
+        if (victim_set != nullptr) {
+            *victim_set = set;
+        }
+
+        //  set the new information
+        getCacheValid(victim, set) = true;
+        getCacheTag(victim, set) = tag;
+        replUpdate(victim, set);
+        return evict;
+    }
+
+    virtual void replUpdate(size_t way, size_t set) { getCacheStamp(way, set) = ++clock_m; }
+};
+
+#endif /* __GENERIC_CACHE_DIRECTORY_LRU_H__ */
@@ -26,8 +26,8 @@
 #ifndef __GENERIC_CACHE_DIRECTORY_PLRU_H__
 #define __GENERIC_CACHE_DIRECTORY_PLRU_H__
 
+#include <cassert>
 #include <string>
-#include <systemc>
 
 #include "generic_cache_directory_base.h"
 
@@ -46,7 +46,7 @@ public:
 
     bool& getCachePlru(size_t way, size_t set) { return plru_m[way * sets_m + set]; }
 
-    void reset()
+    virtual void reset()
     {
         GenericCacheDirectoryBase::reset();
 
@@ -106,7 +106,7 @@ public:
             }
         }
 
-        sc_assert(false && "error: all plru bits are set");
+        assert(false && "error: all plru bits are set");
         return false;
     }
 
@@ -119,13 +119,13 @@ public:
 
         //  check if all recently used bits are set
         reset = true;
-        for (int _way = 0; _way < ways_m; _way++) {
+        for (size_t _way = 0; _way < ways_m; _way++) {
             reset = reset && getCachePlru(_way, set);
         }
 
         //  if all PLRU bits are set, reset them all but the last accessed one
         if (reset) {
-            for (int _way = 0; _way < ways_m; _way++) {
+            for (size_t _way = 0; _way < ways_m; _way++) {
                 if (_way != way) {
                     getCachePlru(_way, set) = false;
                 }
@@ -0,0 +1,108 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ *
+ *  Licensed under the Solderpad Hardware License v 2.1 (the “License”); you
+ *  may not use this file except in compliance with the License, or, at your
+ *  option, the Apache License version 2.0. You may obtain a copy of the
+ *  License at
+ *
+ *  https://solderpad.org/licenses/SHL-2.1/
+ *
+ *  Unless required by applicable law or agreed to in writing, any work
+ *  distributed under the License is distributed on an “AS IS” BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ *  License for the specific language governing permissions and limitations
+ *  under the License.
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Class definition of a cache directory using a pseudo-random
+ *               replacement policy. The victim is selected as in the
+ *               hpdcache_victim_random RTL module (8-bit LFSR)
+ */
+#ifndef __GENERIC_CACHE_DIRECTORY_RANDOM_H__
+#define __GENERIC_CACHE_DIRECTORY_RANDOM_H__
+
+#include <cassert>
+#include <string>
+
+#include "generic_cache_directory_base.h"
+
+class GenericCacheDirectoryRandom : public GenericCacheDirectoryBase
+{
+    uint8_t lfsr_m;
+    size_t way_mask_m;
+
+    //  same polynomial and reset value than the 8-bit hpdcache_lfsr
+    void shiftLfsr() { lfsr_m = (lfsr_m >> 1) ^ ((lfsr_m & 1) ? 0xe1 : 0x00); }
+
+public:
+    GenericCacheDirectoryRandom(const std::string& name, size_t nways, size_t nsets, size_t nbytes)
+      : GenericCacheDirectoryBase(name, nways, nsets, nbytes)
+      , lfsr_m(0xff)
+    {
+        way_mask_m = 1;
+        while (way_mask_m < nways) way_mask_m <<= 1;
+        way_mask_m--;
+    }
+
+    virtual void reset()
+    {
+        GenericCacheDirectoryBase::reset();
+        lfsr_m = 0xff;
+    }
+
+    virtual bool repl(uint64_t addr, uint64_t* victim_tag, size_t* victim_way, size_t* victim_set)
+    {
+        uint64_t tag;
+        size_t set;
+        size_t victim;
+        bool evict;
+
+        set = getAddrSet(addr);
+        tag = getAddrTag(addr);
+
+        //  look if there is an empty way
+        victim = ways_m;
+        for (size_t way = 0; way < ways_m; way++) {
+            if (!getCacheValid(way, set)) {
+                victim = way;
+                break;
+            }
+        }
+        evict = (victim == ways_m);
+
+        //  otherwise select the way given by the LFSR. If the LFSR points to a way that does not
+        //  exist (nb of ways not a power of 2), select the first way as the RTL does
+        if (evict) {
+            victim = lfsr_m & way_mask_m;
+            if (victim < ways_m) {
+                shiftLfsr();
+            } else {
+                victim = 0;
+            }
+        }
+
+        //  get victim entry information
+        if (victim_tag != nullptr) {
+            *victim_tag = evict ? getCacheTag(victim, set) : 0;
+        }
+        if (victim_way != nullptr) {
+            *victim_way = victim;
+        }
+        if (victim_set != nullptr) {
+            *victim_set = set;
+        }
+
+        //  set the new information
+        getCacheValid(victim, set) = true;
+        getCacheTag(victim, set) = tag;
+        return evict;
+    }
+
+    virtual void replUpdate(size_t, size_t) {}
+};
+
+#endif /* __GENERIC_CACHE_DIRECTORY_RANDOM_H__ */
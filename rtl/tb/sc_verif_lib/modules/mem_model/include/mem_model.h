@@ -25,9 +25,17 @@
 #ifndef __MEM_MODEL_H__
 #define __MEM_MODEL_H__
 
+#include <cstddef>
 #include <cstdint>
-#include <map>
-
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+//  The memory is stored by pages of 4 KiB, allocated on the first write.
+//  The initial value of a word is a function of its address (and of the seed
+//  in random mode), thus words that are only read do not need any storage.
 class mem_model
 {
 public:
@@ -37,72 +45,105 @@ public:
         MEM_MODEL_INIT_RANDOM
     };
 
-    typedef std::map<uint64_t, uint64_t> mem_array_t;
-    typedef std::pair<uint64_t, uint64_t> mem_array_pair_t;
+    static constexpr unsigned PAGE_SHIFT = 12;
+    static constexpr size_t PAGE_WORDS = (size_t(1) << PAGE_SHIFT) / 8;
 
     mem_model(const char* name,
               mem_model_init_mode_e init_mode = MEM_MODEL_INIT_RANDOM,
               uint64_t init_val = 0)
       : name_m(name)
-      , init_mode_m(MEM_MODEL_INIT_RANDOM)
+      , init_mode_m(init_mode)
       , init_val_m(init_val)
+      , seed_m(0)
+      , last_pnum_m(0)
+      , last_page_m(nullptr)
     {
     }
 
     ~mem_model() {}
 
-    mem_array_t* getMemPtr() { return &mem_array_m; }
-
     const char* getName() { return name_m.c_str(); }
 
+    //  Set the seed used to compute the initial value of words in random mode.
+    //  It shall be set before the first access to the memory.
+    void setSeed(uint64_t seed) { seed_m = seed; }
+
+    size_t getNbPages() const { return pages_m.size(); }
+
     uint64_t readMemory(uint64_t word_addr)
     {
-        mem_array_t::const_iterator it;
-
-        //  check if the target address was already accessed
-        it = mem_array_m.find(word_addr);
-        if (it != mem_array_m.end()) {
-            return it->second;
+        const page_t* page = findPage(word_addr / PAGE_WORDS);
+        if (page != nullptr) {
+            return page->data[word_addr % PAGE_WORDS];
         }
+        return initValue(word_addr);
+    }
 
-        //  addr not found, thus add it to the memory and return the init number
-        uint64_t value;
-        switch (init_mode_m) {
-            case MEM_MODEL_INIT_RANDOM:
-                value = ((uint64_t)rand() << 32) | (uint64_t)rand();
-                break;
-            case MEM_MODEL_INIT_VALUE:
-                value = init_val_m;
-                break;
+    //  Read n consecutive words starting at word_addr
+    void readMemory(uint64_t word_addr, uint64_t* buf, size_t n)
+    {
+        while (n > 0) {
+            const size_t w = word_addr % PAGE_WORDS;
+            const size_t cnt = (n < (PAGE_WORDS - w)) ? n : (PAGE_WORDS - w);
+            const page_t* page = findPage(word_addr / PAGE_WORDS);
+
+            for (size_t i = 0; i < cnt; i++) {
+                buf[i] = (page != nullptr) ? page->data[w + i] : initValue(word_addr + i);
+            }
+
+            word_addr += cnt;
+            buf += cnt;
+            n -= cnt;
         }
-        mem_array_m.insert(mem_array_pair_t(word_addr, value));
-        return value;
     }
 
     void writeMemory(uint64_t word_addr, uint64_t data, uint64_t mask)
     {
-        mem_array_t::iterator it;
+        page_t* page = allocPage(word_addr / PAGE_WORDS);
+        uint64_t& word = page->data[word_addr % PAGE_WORDS];
+        word = (word & ~mask) | (data & mask);
+    }
 
-        //  check if the target address was already accessed
-        it = mem_array_m.find(word_addr);
-        if (it != mem_array_m.end()) {
-            it->second = (it->second & ~mask) | (data & mask);
-            return;
+    //  Save the contents of the memory (and its initialization parameters) in
+    //  a binary stream
+    void saveState(std::ostream& os) const
+    {
+        const uint64_t nb_pages = pages_m.size();
+        const uint32_t init_mode = init_mode_m;
+
+        os.write(reinterpret_cast<const char*>(&init_mode), sizeof(init_mode));
+        os.write(reinterpret_cast<const char*>(&init_val_m), sizeof(init_val_m));
+        os.write(reinterpret_cast<const char*>(&seed_m), sizeof(seed_m));
+        os.write(reinterpret_cast<const char*>(&nb_pages), sizeof(nb_pages));
+        for (const auto& p : pages_m) {
+            os.write(reinterpret_cast<const char*>(&p.first), sizeof(p.first));
+            os.write(reinterpret_cast<const char*>(p.second.get()), sizeof(page_t));
         }
+    }
 
-        //  address not found, thus add it to the memory and merge the
-        //  written data with random data
-        uint64_t value;
-        switch (init_mode_m) {
-            case MEM_MODEL_INIT_RANDOM:
-                value = ((uint64_t)rand() << 32) | (uint64_t)rand();
-                break;
-            case MEM_MODEL_INIT_VALUE:
-                value = init_val_m;
-                break;
+    //  Replace the contents of the memory by the ones saved by saveState().
+    //  Return false if the stream is truncated
+    bool restoreState(std::istream& is)
+    {
+        uint64_t nb_pages = 0;
+        uint32_t init_mode = 0;
+
+        is.read(reinterpret_cast<char*>(&init_mode), sizeof(init_mode));
+        is.read(reinterpret_cast<char*>(&init_val_m), sizeof(init_val_m));
+        is.read(reinterpret_cast<char*>(&seed_m), sizeof(seed_m));
+        is.read(reinterpret_cast<char*>(&nb_pages), sizeof(nb_pages));
+        init_mode_m = static_cast<mem_model_init_mode_e>(init_mode);
+
+        pages_m.clear();
+        last_page_m = nullptr;
+        for (uint64_t i = 0; (i < nb_pages) && is; i++) {
+            uint64_t pnum;
+            is.read(reinterpret_cast<char*>(&pnum), sizeof(pnum));
+            std::unique_ptr<page_t>& p = pages_m[pnum];
+            p.reset(new page_t);
+            is.read(reinterpret_cast<char*>(p.get()), sizeof(page_t));
         }
-        uint64_t newval = (value & ~mask) | (data & mask);
-        mem_array_m.insert(mem_array_pair_t(word_addr, newval));
+        return bool(is);
     }
 
     static uint64_t beToMask(uint8_t be)
@@ -121,10 +162,65 @@ public:
     }
 
 protected:
+    struct page_t
+    {
+        uint64_t data[PAGE_WORDS];
+    };
+
+    //  SplitMix64 finalizer: cheap and well distributed hash of the address
+    static inline uint64_t hash(uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    inline uint64_t initValue(uint64_t word_addr) const
+    {
+        switch (init_mode_m) {
+            case MEM_MODEL_INIT_VALUE:
+                return init_val_m;
+            case MEM_MODEL_INIT_RANDOM:
+            default:
+                return hash(word_addr ^ hash(seed_m));
+        }
+    }
+
+    inline page_t* findPage(uint64_t pnum)
+    {
+        if ((last_page_m != nullptr) && (last_pnum_m == pnum)) return last_page_m;
+
+        auto it = pages_m.find(pnum);
+        if (it == pages_m.end()) return nullptr;
+
+        last_pnum_m = pnum;
+        last_page_m = it->second.get();
+        return last_page_m;
+    }
+
+    inline page_t* allocPage(uint64_t pnum)
+    {
+        page_t* page = findPage(pnum);
+        if (page != nullptr) return page;
+
+        std::unique_ptr<page_t>& p = pages_m[pnum];
+        p.reset(new page_t);
+        for (size_t i = 0; i < PAGE_WORDS; i++) {
+            p->data[i] = initValue(pnum * PAGE_WORDS + i);
+        }
+        last_pnum_m = pnum;
+        last_page_m = p.get();
+        return last_page_m;
+    }
+
     std::string name_m;
-    mem_array_t mem_array_m;
     mem_model_init_mode_e init_mode_m;
     uint64_t init_val_m;
+    uint64_t seed_m;
+    std::unordered_map<uint64_t, std::unique_ptr<page_t>> pages_m;
+    uint64_t last_pnum_m;
+    page_t* last_page_m;
 };
 
 #endif /* __MEM_MODEL_H__ */
@@ -20,96 +20,232 @@
 /**
  *  Author     : Cesar Fuguet
  *  Date       : October, 2024
- *  Description: Generic RAM model
+ *  Description: Generic RAM model (sparse, allocated on demand by pages)
  */
 #ifndef __RAM_MODEL_H__
 #define __RAM_MODEL_H__
 
-#include <array>
 #include <cstdint>
 #include <cstring>
+#include <iostream>
+#include <istream>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
-template<size_t N>
+//  The RAM covers the full 64-bit address space. Pages are allocated on the
+//  first write, and unwritten bytes read as zero with their valid bit unset.
+//  Data and valid bits are stored and merged by 64-bit words.
 class ram_model
 {
 public:
+    static constexpr unsigned PAGE_SHIFT = 12;
+    static constexpr size_t PAGE_SIZE = size_t(1) << PAGE_SHIFT;
+    static constexpr size_t PAGE_WORDS = PAGE_SIZE / 8;
+
     ram_model(const char* name)
       : name_m(name)
+      , last_pnum_m(0)
+      , last_page_m(nullptr)
     {
-        mem_m = std::make_shared<std::array<uint8_t, N>>();
-        bmap_m = std::make_shared<std::array<uint8_t, N / 8>>();
-
-        memset(bmap_m->data(), 0, N / 8);
     }
 
     ~ram_model() {}
 
-    uint8_t* getMemPtr() { return mem_m->data(); }
-
     const char* getName() { return name_m.c_str(); }
 
+    size_t getNbPages() const { return pages_m.size(); }
+
+    //  Read n bytes starting at addr. When valid is not null, the bit i of the
+    //  valid bitmap is set if the byte i has been previously written.
     void read(uint8_t* buf, size_t n, uint64_t addr, uint8_t* valid = nullptr)
     {
-        uint64_t off = addr % N;
-
         if (valid != nullptr) {
             memset(valid, 0, (n + 7) / 8);
         }
 
-        for (size_t i = 0; i < n; ++i) {
-            uint8_t rdata;
-            rdata = (*mem_m)[off + i];
-            if (valid != nullptr) {
-                if (getBmap(off + i)) {
-                    setBit(valid[i / 8], i % 8);
+        for (size_t i = 0; i < n;) {
+            const uint64_t a = addr + i;
+            const unsigned boff = a % 8;
+            const unsigned cnt = (n - i) < (8 - boff) ? (n - i) : (8 - boff);
+            const page_t* page = findPage(a >> PAGE_SHIFT);
+
+            if (page == nullptr) {
+                memset(buf + i, 0, cnt);
+            } else {
+                const size_t w = (a % PAGE_SIZE) / 8;
+                const uint64_t word = page->data[w];
+                memcpy(buf + i, reinterpret_cast<const uint8_t*>(&word) + boff, cnt);
+                if (valid != nullptr) {
+                    setBits(valid, i, cnt, page->valid[w] >> boff);
                 }
             }
-            buf[i] = rdata;
 
 #if DEBUG
-            std::cout << "reading @0x" << std::hex << off + i << " / rdata = 0x" << (unsigned)rdata
-                      << std::dec << std::endl;
+            for (unsigned k = 0; k < cnt; k++) {
+                std::cout << "reading @0x" << std::hex << a + k
+                          << " / rdata = 0x" << (unsigned)buf[i + k] << std::dec << std::endl;
+            }
 #endif
+            i += cnt;
         }
     }
 
+    //  Write the bytes of buf whose bit is set in the be bitmap
     void write(const uint8_t* buf, const uint8_t* be, size_t n, uint64_t addr)
     {
-        uint64_t off = addr % N;
-        for (size_t i = 0; i < n; ++i) {
-            if (getBit(be[i / 8], i % 8)) {
-                (*mem_m)[off + i] = buf[i];
-                setBmap(off + i);
+        for (size_t i = 0; i < n;) {
+            const uint64_t a = addr + i;
+            const unsigned boff = a % 8;
+            const unsigned cnt = (n - i) < (8 - boff) ? (n - i) : (8 - boff);
+            const uint8_t bmask = getBits(be, i, cnt) << boff;
+
+            if (bmask != 0) {
+                page_t* page = allocPage(a >> PAGE_SHIFT);
+                const size_t w = (a % PAGE_SIZE) / 8;
+                const uint64_t mask = expandMask(bmask);
+                uint64_t word = 0;
+
+                memcpy(reinterpret_cast<uint8_t*>(&word) + boff, buf + i, cnt);
+                page->data[w] = (page->data[w] & ~mask) | (word & mask);
+                page->valid[w] |= bmask;
 
 #if DEBUG
-                std::cout << "writing @0x" << std::hex << off + i << " / wdata = 0x"
-                          << (unsigned)buf[i] << std::dec << std::endl;
+                for (unsigned k = 0; k < cnt; k++) {
+                    if ((bmask >> (boff + k)) & 0x1) {
+                        std::cout << "writing @0x" << std::hex << a + k << " / wdata = 0x"
+                                  << (unsigned)buf[i + k] << std::dec << std::endl;
+                    }
+                }
 #endif
             }
+            i += cnt;
         }
     }
 
-    inline bool getBmap(uint64_t addr) const
+    //  Get the valid bitmap of n bytes starting at addr
+    void getBmap(uint8_t* valid, size_t n, uint64_t addr)
     {
-        uint64_t off = addr % N;
-        return getBit((*bmap_m)[off / 8], off % 8) ? true : false;
+        memset(valid, 0, (n + 7) / 8);
+        for (size_t i = 0; i < n;) {
+            const uint64_t a = addr + i;
+            const unsigned boff = a % 8;
+            const unsigned cnt = (n - i) < (8 - boff) ? (n - i) : (8 - boff);
+            const page_t* page = findPage(a >> PAGE_SHIFT);
+
+            if (page != nullptr) {
+                setBits(valid, i, cnt, page->valid[(a % PAGE_SIZE) / 8] >> boff);
+            }
+            i += cnt;
+        }
+    }
+
+    inline bool getBmap(uint64_t addr)
+    {
+        const page_t* page = findPage(addr >> PAGE_SHIFT);
+        if (page == nullptr) return false;
+        return getBit(page->valid[(addr % PAGE_SIZE) / 8], addr % 8) ? true : false;
+    }
+
+    //  Save the contents of the RAM (data and valid bits) in a binary stream
+    void saveState(std::ostream& os) const
+    {
+        const uint64_t nb_pages = pages_m.size();
+
+        os.write(reinterpret_cast<const char*>(&nb_pages), sizeof(nb_pages));
+        for (const auto& p : pages_m) {
+            os.write(reinterpret_cast<const char*>(&p.first), sizeof(p.first));
+            os.write(reinterpret_cast<const char*>(p.second.get()), sizeof(page_t));
+        }
+    }
+
+    //  Replace the contents of the RAM by the ones saved by saveState().
+    //  Return false if the stream is truncated
+    bool restoreState(std::istream& is)
+    {
+        uint64_t nb_pages = 0;
+
+        is.read(reinterpret_cast<char*>(&nb_pages), sizeof(nb_pages));
+
+        pages_m.clear();
+        last_page_m = nullptr;
+        for (uint64_t i = 0; (i < nb_pages) && is; i++) {
+            uint64_t pnum;
+            is.read(reinterpret_cast<char*>(&pnum), sizeof(pnum));
+            std::unique_ptr<page_t>& p = pages_m[pnum];
+            p.reset(new page_t());
+            is.read(reinterpret_cast<char*>(p.get()), sizeof(page_t));
+        }
+        return bool(is);
     }
 
 protected:
+    struct page_t
+    {
+        uint64_t data[PAGE_WORDS];
+        uint8_t valid[PAGE_WORDS];
+    };
+
     static inline int getBit(uint8_t byte, size_t pos) { return (byte >> pos) & 0x1; }
 
-    static inline void setBit(uint8_t& byte, size_t pos) { byte |= (1 << pos); }
+    //  Get cnt (<= 8) bits from a bitmap starting at bit position pos
+    static inline uint8_t getBits(const uint8_t* bmap, size_t pos, unsigned cnt)
+    {
+        const size_t idx = pos / 8;
+        const unsigned sh = pos % 8;
+        unsigned v = bmap[idx] >> sh;
+        if (sh + cnt > 8) v |= unsigned(bmap[idx + 1]) << (8 - sh);
+        return static_cast<uint8_t>(v & ((1U << cnt) - 1));
+    }
+
+    //  Set cnt (<= 8) bits of a (zero-initialized) bitmap starting at bit position pos
+    static inline void setBits(uint8_t* bmap, size_t pos, unsigned cnt, unsigned v)
+    {
+        const size_t idx = pos / 8;
+        const unsigned sh = pos % 8;
+        v &= (1U << cnt) - 1;
+        bmap[idx] |= static_cast<uint8_t>(v << sh);
+        if (sh + cnt > 8) bmap[idx + 1] |= static_cast<uint8_t>(v >> (8 - sh));
+    }
+
+    //  Expand a byte-enable mask into a 64-bit mask
+    static inline uint64_t expandMask(uint8_t bmask)
+    {
+        uint64_t mask = 0;
+        for (unsigned k = 0; k < 8; k++) {
+            if ((bmask >> k) & 0x1) mask |= 0xffULL << (8 * k);
+        }
+        return mask;
+    }
+
+    inline page_t* findPage(uint64_t pnum)
+    {
+        if ((last_page_m != nullptr) && (last_pnum_m == pnum)) return last_page_m;
+
+        auto it = pages_m.find(pnum);
+        if (it == pages_m.end()) return nullptr;
+
+        last_pnum_m = pnum;
+        last_page_m = it->second.get();
+        return last_page_m;
+    }
 
-    inline void setBmap(uint64_t addr)
+    inline page_t* allocPage(uint64_t pnum)
     {
-        uint64_t off = addr % N;
-        setBit((*bmap_m)[off / 8], off % 8);
+        page_t* page = findPage(pnum);
+        if (page != nullptr) return page;
+
+        std::unique_ptr<page_t>& p = pages_m[pnum];
+        p.reset(new page_t());
+        last_pnum_m = pnum;
+        last_page_m = p.get();
+        return last_page_m;
     }
 
     std::string name_m;
-    std::shared_ptr<std::array<uint8_t, N>> mem_m;
-    std::shared_ptr<std::array<uint8_t, N / 8>> bmap_m;
+    std::unordered_map<uint64_t, std::unique_ptr<page_t>> pages_m;
+    uint64_t last_pnum_m;
+    page_t* last_page_m;
 };
 
-#endif /* __ram_model_H__ */
+#endif /* __RAM_MODEL_H__ */
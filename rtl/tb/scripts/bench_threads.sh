@@ -0,0 +1,111 @@
+#!/bin/bash
+##
+#  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+#
+#  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+##
+##
+#  Date       : October, 2026
+#  Description: measure the simulation speed of the testbench for each
+#               configuration and each nb of threads of the verilated model
+##
+configs=$(ls configs/*.mk | tr '\n' ' ')
+threads="1 2 4 8"
+ntrans=10000
+seed=1234
+logdir=bench_threads
+njobs=$(nproc)
+
+help() {
+    echo "help: $0"
+    echo "      -c <configs>         desc: config files (default: ${configs})"
+    echo "      -p <threads>         desc: nb of threads of the model (default: ${threads})"
+    echo "      -t <ntrans>          desc: number of transactions (default: ${ntrans})"
+    echo "      -r <seed>            desc: random seed (default: ${seed})"
+    echo "      -l <logdir>          desc: logs directory (default: ${logdir})"
+    echo "      -j <njobs>           desc: number of compilation jobs (default: ${njobs})"
+    echo "      -h                   desc: show this help message"
+}
+
+while [[ $# -gt 0 ]] ; do
+    case $1 in
+        -c)
+            configs=$2
+            shift 2 ;;
+        -p)
+            threads=$2
+            shift 2 ;;
+        -t)
+            ntrans=$2
+            shift 2 ;;
+        -r)
+            seed=$2
+            shift 2 ;;
+        -l)
+            logdir=$2
+            shift 2 ;;
+        -j)
+            njobs=$2
+            shift 2 ;;
+        -h)
+            help
+            exit 1 ;;
+    esac
+done
+
+mkdir -p ${logdir}
+csv=${logdir}/bench_threads.csv
+echo "config,threads,khz,speedup" > ${csv}
+
+status=0
+for config in ${configs} ; do
+    name=$(basename ${config} .mk)
+
+    base=
+    for t in ${threads} ; do
+        echo "Benchmarking CONFIG=${name} THREADS=${t}"
+        log=${logdir}/${name}_t${t}.log
+
+        make -s build -j${njobs} CONFIG=${config} THREADS=${t}
+        if [[ $? -ne 0 ]] ; then
+            echo "error: testbench compilation failed (CONFIG=${name} THREADS=${t})" ;
+            echo "${name},${t},," >> ${csv} ;
+            status=1 ;
+            continue ;
+        fi
+
+        make -s run_no_check SEQUENCE=random SEED=${seed} \
+                NTRANSACTIONS=${ntrans} \
+                RUN_LOG=${log} \
+                LOG_LEVEL=0 \
+                CONFIG=${config} \
+                THREADS=${t}
+
+        #  a run that did not reach its end does not give a meaningful speed
+        khz=
+        if grep -q "Finishing the simulation" ${log} ; then
+            khz=$(sed -n -e 's/^Simulation real frequency *: *\([0-9.]*\) KHz/\1/p' ${log})
+        fi
+        if [[ -z ${khz} ]] ; then
+            echo "error: the simulation did not finish (LOG: ${log})" ;
+            echo "${name},${t},," >> ${csv} ;
+            status=1 ;
+            continue ;
+        fi
+
+        if [[ -z ${base} ]] ; then base=${khz} ; fi
+        speedup=$(awk -v a=${khz} -v b=${base} 'BEGIN { printf "%.2f", (b > 0) ? a / b : 0 }')
+        echo "${name},${t},${khz},${speedup}" >> ${csv}
+    done
+done
+
+#  the speedup is relative to the first nb of threads of the list
+echo
+printf "%-24s %8s %12s %8s\n" "CONFIG" "THREADS" "KHZ" "SPEEDUP"
+tail -n +2 ${csv} | while IFS=, read -r name t khz speedup ; do
+    printf "%-24s %8s %12s %8s\n" "${name}" "${t}" "${khz:--}" "${speedup:--}"
+done
+echo
+echo "Results written into ${csv}"
+
+exit ${status}
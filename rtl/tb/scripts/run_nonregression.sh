@@ -18,14 +18,20 @@ loglevel=1
 config=configs/default_config.mk
 coverage=0
 compile=0
+njobs=$(nproc)
+walltime=0
+nreruns=8
 
 help() {
     echo "help: $0"
-    echo "      -s <sequence>        desc: name of the test sequence to execute (default: ${ntrans})"
+    echo "      -s <sequence>        desc: name of the test sequence (default: ${sequence})"
     echo "      -n <ntests>          desc: number of tests to execute (default: ${ntests})"
     echo "      -t <ntrans>          desc: number of transactions (default: ${ntrans})"
     echo "      -l <logdir>          desc: logs directory (default: ${logdir})"
     echo "      -c <config>          desc: config file (default: ${config})"
+    echo "      -j <njobs>           desc: number of parallel jobs (default: ${njobs})"
+    echo "      -w <seconds>         desc: timeout of each test in sec, or 0 (default: ${walltime})"
+    echo "      -x <nreruns>         desc: failed tests rerun with waveforms (default: ${nreruns})"
     echo "      -d <loglevel>        desc: logging level (default: ${loglevel})"
     echo "      -e <coverage>        desc: coverage (default: ${coverage})"
     echo "      -f                   desc: force recompilation (default: ${compile})"
@@ -52,6 +58,12 @@ while [[ $# -gt 0 ]] ; do
         -j)
             njobs=$2
             shift 2 ;;
+        -w)
+            walltime=$2
+            shift 2 ;;
+        -x)
+            nreruns=$2
+            shift 2 ;;
         -d)
             loglevel=$2
             shift 2 ;;
@@ -70,25 +82,141 @@ done
 echo "Running non-regression testsuite with SEQUENCE=${sequence}"
 
 if [[ -n ${compile} && ${compile} == 1 ]] ; then
-    make -s clean ;
-    make -s build -j${njobs} CONFIG=${config} ;
-    if [[ $? -ne 0 ]] ; then
-        echo "error: testbench compilation failed" ;
-        exit 1 ;
-    fi
+    make -s clean_config CONFIG=${config} ;
 fi
 
-i=1
-mkdir -p ${logdir}
-for s in $(head -n ${ntests} scripts/random_numbers.dat | tr '\n' ' ') ; do
-    echo "[$i/${ntests}] Running sequence ${sequence} SEED=${s}" ; ((i++)) ;
-    make -s run_no_check SEQUENCE=${sequence} SEED=${s} \
+#  the testbench is built (when needed) before the tests start, otherwise the
+#  parallel tests would all try to build it
+make -s build -j${njobs} CONFIG=${config} COV=${coverage} ;
+if [[ $? -ne 0 ]] ; then
+    echo "error: testbench compilation failed" ;
+    exit 1 ;
+fi
+
+#  run_test <seed> <log> [make arguments]
+#
+#  Run one test and write its results (seed, status, cycles, read and write miss
+#  rates, and wall clock time) into the results directory
+run_test() {
+    local s=$1
+    local log=$2
+    shift 2
+
+    local start=$(date +%s%N)
+    timeout ${walltime} make -s run_no_check SEQUENCE=${sequence} SEED=${s} \
             NTRANSACTIONS=${ntrans} \
-            RUN_LOG=${logdir}/${sequence}_${s}.log \
+            RUN_LOG=${log} \
             LOG_LEVEL=${loglevel} \
             COV=${coverage} \
-            CONFIG=${config} ;
-done
+            CONFIG=${config} "$@" > /dev/null 2>&1
+    local ret=$?
+    local end=$(date +%s%N)
+
+    local status=PASS
+    if [[ ${ret} -eq 124 ]] ; then
+        #  the log scan reports the timeout as an error
+        echo "Fatal: wall clock timeout of ${walltime} sec" >> ${log}
+        status=TIMEOUT
+    else
+        PERL5LIB=./scripts/perl5 \
+        ./scripts/scan_logs.pl -pat scripts/scan_patterns/run_patterns.pat \
+                -nowarn ${log} > /dev/null 2>&1
+        if [[ $? -ne 0 ]] ; then status=FAIL ; fi
+    fi
+
+    local cycles=$(sed -n -e 's/^SB.NB_CYCLES *: *\([0-9]*\)/\1/p' ${log} 2> /dev/null)
+    local rdmiss=$(sed -n -e 's/^Read miss rate *: *\([0-9.e+-]*\)/\1/p' ${log} 2> /dev/null)
+    local wrmiss=$(sed -n -e 's/^Write miss rate *: *\([0-9.e+-]*\)/\1/p' ${log} 2> /dev/null)
+    local wall=$(awk -v a=${start} -v b=${end} 'BEGIN { printf "%.2f", (b - a) / 1e9 }')
+
+    echo "${s},${status},${cycles},${rdmiss},${wrmiss},${wall}" > ${resdir}/${s}
+    echo "${status} SEED=${s} (${wall} sec)"
+}
+
+#  run_pool <seeds> <trace>
+#
+#  Run the tests of the given seeds with at most njobs tests at a time
+run_pool() {
+    local trace=$2
+    local n=$(echo $1 | wc -w)
+    local i=1
+    for s in $1 ; do
+        while [[ $(jobs -rp | wc -l) -ge ${njobs} ]] ; do wait -n ; done
+        echo "[$i/${n}] Running sequence ${sequence} SEED=${s}" ; ((i++)) ;
+        if [[ ${trace} == 1 ]] ; then
+            run_test ${s} ${rerundir}/${sequence}_${s}.log \
+                    TRACE=1 TRACE_FILE=${rerundir}/${sequence}_${s}.vcd &
+        else
+            run_test ${s} ${logdir}/${sequence}_${s}.log &
+        fi
+    done
+    wait
+}
+
+if [[ ${walltime} -le 0 ]] ; then walltime=0 ; fi
+
+seeds=$(head -n ${ntests} scripts/random_numbers.dat | tr '\n' ' ')
+resdir=${logdir}/results
+rerundir=${logdir}/rerun
+mkdir -p ${logdir}
+rm -rf ${resdir}
+mkdir -p ${resdir}
+
+begin=$(date +%s%N)
+run_pool "${seeds}" 0
+finish=$(date +%s%N)
+
+#  summary of all the tests (in the order of the seeds)
+summary=${logdir}/summary_${sequence}.csv
+echo "seed,status,cycles,read_miss_rate,write_miss_rate,wall_sec" > ${summary}
+for s in ${seeds} ; do cat ${resdir}/${s} >> ${summary} ; done
+
+elapsed=$(awk -v a=${begin} -v b=${finish} 'BEGIN { printf "%.2f", (b - a) / 1e9 }')
+tail -n +2 ${summary} | awk -F, -v elapsed=${elapsed} -v jobs=${njobs} '
+    function mean(s, n) { return (n > 0) ? s / n : 0 }
+    {
+        nb[$2]++
+        if ($2 != "PASS") failed = failed sprintf("%-12s %-8s %12s %10s %10s %10s\n",
+                                                  $1, $2, $3, $4, $5, $6)
+        if ($3 != "") {
+            ncyc++ ; cyc += $3
+            if ((mincyc == "") || ($3 < mincyc)) mincyc = $3
+            if ((maxcyc == "") || ($3 > maxcyc)) maxcyc = $3
+        }
+        if ($4 != "") { nrd++ ; rd += $4 }
+        if ($5 != "") { nwr++ ; wr += $5 }
+        wall += $6
+    }
+    END {
+        printf "\nNON-REGRESSION SUMMARY\n"
+        printf "--------------------------------------------------\n"
+        printf "Tests                   : %d\n", NR
+        printf "Passed                  : %d\n", nb["PASS"]
+        printf "Failed                  : %d\n", nb["FAIL"]
+        printf "Timed out               : %d\n", nb["TIMEOUT"]
+        printf "Cycles (min/mean/max)   : %d / %.0f / %d\n", mincyc, mean(cyc, ncyc), maxcyc
+        printf "Read miss rate (mean)   : %.4f\n", mean(rd, nrd)
+        printf "Write miss rate (mean)  : %.4f\n", mean(wr, nwr)
+        printf "Wall time of the tests  : %.2f sec\n", wall
+        printf "Elapsed time            : %.2f sec (%d jobs)\n", elapsed, jobs
+        if (failed != "") {
+            printf "\n%-12s %-8s %12s %10s %10s %10s\n",
+                   "SEED", "STATUS", "CYCLES", "RD_MISS", "WR_MISS", "WALL_SEC"
+            printf "%s", failed
+        }
+        printf "\n"
+    }' | tee ${logdir}/summary_${sequence}.log
+
+#  the failed tests are run again with the waveforms
+failed=$(awk -F, '(NR > 1) && ($2 != "PASS") { print $1 }' ${summary} \
+        | head -n ${nreruns} | tr '\n' ' ')
+if [[ ${nreruns} -gt 0 && -n ${failed} ]] ; then
+    echo "Running again the failed tests with waveforms (LOGS: ${rerundir})"
+    rm -rf ${resdir}
+    mkdir -p ${resdir} ${rerundir}
+    run_pool "${failed}" 1
+fi
+rm -rf ${resdir}
 
 PERL5LIB=./scripts/perl5 \
 ./scripts/scan_logs.pl -listwarnings -listerrors \
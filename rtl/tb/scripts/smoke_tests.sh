@@ -19,7 +19,8 @@ USER_ARGS=$*
 CONFIGS=(configs/directmap_config.mk
          configs/embedded_config.mk
          configs/hpc_config.mk
-         configs/default_config.mk)
+         configs/default_config.mk
+         configs/cwf_config.mk)
 
 (
     cd ${TEST_DIR}
@@ -57,5 +58,20 @@ for c in ${CONFIGS[@]} ; do
     done
 done
 
+#  the pipelined driver checks that the requests are kept back-to-back
+make -s -C ${TEST_DIR} nonregression \
+        CONFIG=configs/default_config.mk \
+        SEQUENCE=random \
+        PIPELINED=1 \
+        NTESTS=${NTESTS} \
+        NTRANSACTIONS=${NTRANS} \
+        ${USER_ARGS}
+ret=$?
+if [[ ${ret} != 0 ]] ; then
+    printf "FAILURE: there are failing tests with the pipelined driver\n"
+    printf "Run \"make nonregression SEQUENCE=random PIPELINED=1\" in the <git>/rtl/tb directory for details\n"
+    exit 1 ;
+fi
+
 printf "SUCCESS: all tests succeed\n"
 exit 0 ;
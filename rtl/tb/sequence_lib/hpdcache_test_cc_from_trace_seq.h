@@ -0,0 +1,127 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Sequence of the HPDCACHE testbench without SystemC that replays
+ *               the requests of a binary trace (see hpdcache_test_from_trace_seq.h)
+ */
+#ifndef __HPDCACHE_TEST_CC_FROM_TRACE_SEQ_H__
+#define __HPDCACHE_TEST_CC_FROM_TRACE_SEQ_H__
+
+#include "hpdcache_test_cc_sequence.h"
+#include "hpdcache_test_defs.h"
+#include "hpdcache_test_trace_reader.h"
+#include <algorithm>
+#include <memory>
+
+class hpdcache_test_cc_from_trace_seq : public hpdcache_test_cc_sequence
+{
+    typedef hpdcache_test_cc_req req_t;
+
+public:
+    hpdcache_test_cc_from_trace_seq(const std::string& nm,
+                                    const std::string& trace_name,
+                                    uint64_t seed)
+      : hpdcache_test_cc_sequence(nm, seed)
+      , trace_name(trace_name)
+      , trace_roi(-1)
+      , trace_skip(0)
+      , nb_records(0)
+      , done(false)
+    {
+    }
+
+    ~hpdcache_test_cc_from_trace_seq()
+    {
+        if (my_trace) my_trace->my_close();
+    }
+
+    /**
+     * @brief Select the part of the trace to replay. This shall be called before start()
+     *
+     * @param roi Index of the region of interest (negative: the whole trace)
+     * @param skip Nb of records to skip at the beginning of the trace (or of the region)
+     */
+    void set_region(int roi, uint64_t skip)
+    {
+        trace_roi = roi;
+        trace_skip = skip;
+    }
+
+    //  the trace is opened once all the options are known, and the producer thread starts
+    //  decoding it before the first cycle
+    void start() { my_trace.reset(new trace_prefetcher(trace_name, trace_roi, trace_skip)); }
+
+    bool next(req_t& req, unsigned& delay) override
+    {
+        if (done || !is_available_id()) return false;
+
+        trace_record_t r;
+        if ((nb_records >= max_transactions) || !my_trace->pop(r)) {
+            done = true;
+            if (my_trace->has_failed()) {
+                std::cout << "SEQ_ERROR: " << my_trace->get_error() << std::endl;
+            }
+            my_trace->my_close();
+            return false;
+        }
+
+        req = req_t();
+        req.tid = allocate_id();
+        delay = record_to_req(r, req);
+        nb_records++;
+        return true;
+    }
+
+    bool is_done() const override { return done; }
+
+private:
+    std::unique_ptr<trace_prefetcher> my_trace;
+    std::string trace_name;
+    int trace_roi;
+    uint64_t trace_skip;
+    uint64_t nb_records;
+    bool done;
+
+    //  same conversion as trace_record_to_transaction() in hpdcache_test_trace_manager.h
+    static unsigned record_to_req(const trace_record_t& r, req_t& req)
+    {
+        req.addr = r.addr;
+        req.size = r.size;
+        req.op = r.op;
+        req.need_rsp = r.need_rsp;
+        req.uncacheable = r.uncacheable;
+
+        if (!r.full) {
+            req.phys_indexed = true;
+            req.io = r.uncacheable;
+            req.abort = false;
+            if (req.is_store()) {
+                hpdcache_test_cc_store(
+                    req.wdata, r.wdata[0], std::min(8U, (unsigned)req_t::DATA_BYTES));
+            }
+            return r.delay;
+        }
+
+        req.sid = r.sid;
+        req.phys_indexed = (r.attr & 0x1) != 0;
+        req.io = (r.attr & 0x2) != 0;
+        req.abort = (r.attr & 0x4) != 0;
+        req.wr_policy_hint = (r.attr >> 3) & 0x7;
+        for (unsigned i = 0; i < TRACE_RECORD_DATA_WORDS; i++) {
+            const unsigned lo = i * 8;
+            const unsigned n = std::min(lo + 8, (unsigned)req_t::DATA_BYTES) - lo;
+            hpdcache_test_cc_store(req.wdata + lo, r.wdata[i], n);
+            for (unsigned b = 0; b < n; b++) {
+                if ((r.be[i] >> b) & 0x1) hpdcache_test_cc_set_bit(req.be, lo + b);
+            }
+        }
+        return r.delay;
+    }
+};
+
+#endif /* __HPDCACHE_TEST_CC_FROM_TRACE_SEQ_H__ */
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
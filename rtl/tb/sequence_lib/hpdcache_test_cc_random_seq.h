@@ -0,0 +1,262 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Random sequence of the HPDCACHE testbench without SystemC. It
+ *               generates the same distribution of requests as the random
+ *               sequence of the SystemC testbench (hpdcache_test_random_seq.h)
+ */
+#ifndef __HPDCACHE_TEST_CC_RANDOM_SEQ_H__
+#define __HPDCACHE_TEST_CC_RANDOM_SEQ_H__
+
+#include "hpdcache_test_cc_sequence.h"
+#include "hpdcache_test_defs.h"
+
+class hpdcache_test_cc_random_seq : public hpdcache_test_cc_sequence
+{
+    typedef hpdcache_test_cc_req req_t;
+
+public:
+    hpdcache_test_cc_random_seq(const std::string& nm, uint64_t seed)
+      : hpdcache_test_cc_sequence(nm, seed)
+      , state(ST_RANDOM)
+      , n(0)
+      , nb_inbetween(0)
+      , lr_addr(0)
+      , lr_uncacheable(false)
+    {
+        //  base, length, uncached and write policy of the memory segments
+        seg[0] = { 0x00000000ULL, 0x00004000ULL, false, WR_POLICY_RANDOM };
+        seg[1] = { 0x40004000ULL, 0x00004000ULL, false, WR_POLICY_WB };
+        seg[2] = { 0x80008000ULL, 0x00004000ULL, false, WR_POLICY_WT };
+        seg[3] = { 0xC000C000ULL, 0x00004000ULL, true, WR_POLICY_AUTO };
+
+        seg_distribution.push(0, 33);
+        seg_distribution.push(1, 33);
+        seg_distribution.push(2, 33);
+        seg_distribution.push(3, 1);
+
+        delay_distribution.push(0, 0, 80);
+        delay_distribution.push(1, 4, 18);
+        delay_distribution.push(5, 20, 2);
+
+        amo_sc_do_distribution.push(0, 25);
+        amo_sc_do_distribution.push(1, 75);
+
+        wr_policy_distribution.push(req_t::HPDCACHE_WR_POLICY_AUTO, 80);
+        wr_policy_distribution.push(req_t::HPDCACHE_WR_POLICY_WB, 10);
+        wr_policy_distribution.push(req_t::HPDCACHE_WR_POLICY_WT, 10);
+
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_LOAD, 800);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_STORE, 600);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_CMO_FENCE, 10);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_CMO_PREFETCH, 10);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_CMO_FLUSH_NLINE, 10);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_CMO_FLUSH_ALL, 1);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_CMO_FLUSH_INVAL_NLINE, 10);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_CMO_FLUSH_INVAL_ALL, 1);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_AMO_LR, 4);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_AMO_SC, 4);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_AMO_SWAP, 4);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_AMO_ADD, 4);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_AMO_AND, 4);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_AMO_OR, 4);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_AMO_XOR, 4);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_AMO_MAX, 4);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_AMO_MAXU, 4);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_AMO_MIN, 4);
+        op_amo_distribution.push(req_t::HPDCACHE_REQ_AMO_MINU, 4);
+
+        need_rsp_distribution.push(0, 5);
+        need_rsp_distribution.push(1, 95);
+
+        //  nb of requests between a LR and the following SC (drawn once)
+        lrsc_inbetween_instrs = rng() % 11;
+    }
+
+    //  The error segments are declared once the memory model is known
+    void set_error_segments()
+    {
+        if (!mem_model) return;
+
+        mem_model->add_error_segment(
+            hpdcache_test_cc_mem_model::segment_t(0x00000000ULL, 0x00000200ULL, true));
+        mem_model->add_error_segment(
+            hpdcache_test_cc_mem_model::segment_t(0x40004000ULL, 0x40004200ULL, true));
+        mem_model->add_error_segment(
+            hpdcache_test_cc_mem_model::segment_t(0xC000C000ULL, 0xC000C200ULL, true));
+    }
+
+    bool next(req_t& req, unsigned& delay) override
+    {
+        if (is_done() || !is_available_id()) return false;
+
+        switch (state) {
+            case ST_RANDOM:
+                if (n >= max_transactions) {
+                    state = ST_DONE;
+                    return false;
+                }
+                n++;
+                create_random_transaction(req);
+
+                //  a LR may be followed (after some random requests) by a SC
+                //  on the same address
+                if (req.is_amo_lr() && amo_sc_do_distribution.next(rng)) {
+                    lr_addr = req.addr;
+                    lr_uncacheable = req.uncacheable;
+                    nb_inbetween = lrsc_inbetween_instrs;
+                    state = (nb_inbetween > 0) ? ST_INBETWEEN : ST_SC;
+                }
+                break;
+
+            case ST_INBETWEEN:
+                create_random_transaction(req);
+                if (--nb_inbetween == 0) state = ST_SC;
+                break;
+
+            case ST_SC:
+                create_sc_transaction(req, lr_addr, lr_uncacheable);
+                state = ST_RANDOM;
+                break;
+
+            case ST_DONE:
+                return false;
+        }
+
+        delay = (unsigned)delay_distribution.next(rng);
+        return true;
+    }
+
+    bool is_done() const override { return state == ST_DONE; }
+
+private:
+    enum wr_policy_e
+    {
+        WR_POLICY_AUTO,
+        WR_POLICY_WB,
+        WR_POLICY_WT,
+        WR_POLICY_RANDOM
+    };
+
+    struct memory_segment_t
+    {
+        uint64_t base;
+        uint64_t length;
+        bool uncached;
+        wr_policy_e wr_policy_hint;
+    };
+
+    enum state_e
+    {
+        ST_RANDOM,
+        ST_INBETWEEN,
+        ST_SC,
+        ST_DONE
+    };
+
+    static constexpr unsigned int REQ_DATA_BYTES = HPDCACHE_REQ_DATA_WIDTH / 8;
+    static constexpr unsigned int LOG2_REQ_DATA_BYTES = HPDCACHE_TEST_DEFS_LOG2(REQ_DATA_BYTES);
+
+    memory_segment_t seg[4];
+    hpdcache_test_cc_bag seg_distribution;
+    hpdcache_test_cc_bag delay_distribution;
+    hpdcache_test_cc_bag amo_sc_do_distribution;
+    hpdcache_test_cc_bag wr_policy_distribution;
+    hpdcache_test_cc_bag op_amo_distribution;
+    hpdcache_test_cc_bag need_rsp_distribution;
+
+    state_e state;
+    size_t n;
+    unsigned lrsc_inbetween_instrs;
+    unsigned nb_inbetween;
+    uint64_t lr_addr;
+    bool lr_uncacheable;
+
+    void create_random_data(req_t& req)
+    {
+        for (unsigned i = 0; i < REQ_DATA_BYTES; i += 8) {
+            const unsigned cnt = ((REQ_DATA_BYTES - i) < 8) ? (REQ_DATA_BYTES - i) : 8;
+            hpdcache_test_cc_store(req.wdata + i, rng(), cnt);
+        }
+    }
+
+    uint32_t create_random_size(bool is_amo)
+    {
+        const uint32_t ret = rng() % (LOG2_REQ_DATA_BYTES + 1);
+        if (is_amo) {
+            return (ret >= 3) ? 3 : 2;
+        }
+        return ret;
+    }
+
+    void create_random_transaction(req_t& req)
+    {
+        const int segn = (int)seg_distribution.next(rng);
+        const memory_segment_t& s = seg[segn];
+
+        req = req_t();
+        req.op = (unsigned)op_amo_distribution.next(rng);
+        create_random_data(req);
+        req.sid = sid;
+        req.tid = allocate_id();
+        req.abort = false;
+        req.phys_indexed = false;
+
+        //  Select write policy
+        switch (s.wr_policy_hint) {
+            case WR_POLICY_RANDOM:
+                req.wr_policy_hint = (unsigned)wr_policy_distribution.next(rng);
+                break;
+            case WR_POLICY_WB:
+                req.wr_policy_hint = req_t::HPDCACHE_WR_POLICY_WB;
+                break;
+            case WR_POLICY_WT:
+                req.wr_policy_hint = req_t::HPDCACHE_WR_POLICY_WT;
+                break;
+            default:
+                req.wr_policy_hint = req_t::HPDCACHE_WR_POLICY_AUTO;
+                break;
+        }
+
+        //  Select address and size
+        const bool req_is_amo = req.is_amo() || req.is_amo_sc() || req.is_amo_lr();
+        const uint32_t sz = create_random_size(req_is_amo);
+        const uint32_t bytes = 1 << sz;
+
+        req.addr = ((s.base + (rng() % s.length)) / bytes) * bytes;
+        if (req.is_cmo()) {
+            req.size = 0;
+            req.uncacheable = false;
+            req.need_rsp = need_rsp_distribution.next(rng);
+        } else {
+            req.size = sz;
+            req.set_be_from_size();
+            req.uncacheable = s.uncached;
+            req.need_rsp = req_is_amo || need_rsp_distribution.next(rng);
+        }
+    }
+
+    void create_sc_transaction(req_t& req, uint64_t addr, bool uncacheable)
+    {
+        const uint32_t sz = create_random_size(true);
+        const uint32_t bytes = 1 << sz;
+
+        req = req_t();
+        req.op = req_t::HPDCACHE_REQ_AMO_SC;
+        create_random_data(req);
+        req.sid = sid;
+        req.tid = allocate_id();
+        req.addr = (addr / bytes) * bytes;
+        req.size = sz;
+        req.set_be_from_size();
+        req.uncacheable = uncacheable;
+        req.need_rsp = true;
+    }
+};
+
+#endif /* __HPDCACHE_TEST_CC_RANDOM_SEQ_H__ */
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
@@ -25,8 +25,8 @@
 #define __HPDCACHE_TEST_FROM_TRACE_SEQ_H__
 
 #include <cstdint>
+#include <memory>
 #include <systemc>
-#include <thread>
 
 #include "hpdcache_test_defs.h"
 #include "hpdcache_test_sequence.h"
@@ -43,7 +43,11 @@ class hpdcache_test_from_trace_seq : public hpdcache_test_sequence
 private:
     typedef sc_bv<HPDCACHE_REQ_DATA_WIDTH> req_data_t;
 
-    trace_reader* my_trace;
+    std::unique_ptr<trace_prefetcher> my_trace;
+    std::string trace_name;
+    int trace_roi;
+    uint64_t trace_skip;
+    uint64_t nb_records;
 
 #if SC_VERSION_MAJOR < 3
     SC_HAS_PROCESS(hpdcache_test_from_trace_seq);
@@ -52,23 +56,58 @@ private:
 public:
     hpdcache_test_from_trace_seq(sc_core::sc_module_name nm, std::string trace_name)
       : hpdcache_test_sequence(nm, "from_trace_seq")
+      , trace_name(trace_name)
+      , trace_roi(-1)
+      , trace_skip(0)
+      , nb_records(0)
     {
-        my_trace = new trace_reader(trace_name);
         SC_THREAD(run);
         sensitive << clk_i.pos();
     }
 
+    /**
+     * @brief Select the part of the trace to replay. This shall be called before the start of
+     *        the simulation
+     *
+     * @param roi Index of the region of interest (negative: the whole trace)
+     * @param skip Nb of records to skip at the beginning of the trace (or of the region)
+     */
+    void set_region(int roi, uint64_t skip)
+    {
+        trace_roi = roi;
+        trace_skip = skip;
+    }
+
+    int get_roi() const { return trace_roi; }
+
+    //  Position in the trace (or in the region) of the next record to replay
+    uint64_t get_position() const { return trace_skip + nb_records; }
+
+    //  the trace is opened once all the options are known, and the producer thread starts
+    //  decoding it before the first cycle
+    void start_of_simulation()
+    {
+        my_trace.reset(new trace_prefetcher(trace_name, trace_roi, trace_skip));
+    }
+
     void run()
     {
-        for (size_t n = 0; !my_trace->is_finish() && (n < this->max_transactions); n++) {
+        trace_record_t r;
+        for (size_t n = 0; (n < this->max_transactions) && my_trace->pop(r); n++) {
             std::shared_ptr<hpdcache_test_transaction_req> t;
             while (!is_available_id()) {
                 wait();
             }
             t = acquire_transaction<hpdcache_test_transaction_req>();
             t->req_tid = allocate_id();
-            int delay = my_trace->read_transaction(t);
+            int delay = trace_record_to_transaction(r, t);
             send_transaction(t, delay);
+            nb_records++;
+        }
+        //  the decoding errors are reported here, by the simulation thread: the sequence stops
+        //  and the driver drains the transactions in flight
+        if (my_trace->has_failed()) {
+            std::cout << "SEQ_ERROR: " << my_trace->get_error() << std::endl;
         }
         //  ask the driver to stop
         transaction_fifo_o->write(nullptr);
@@ -245,7 +245,7 @@ private:
         }
 
         t->req_wdata = create_random_data();
-        t->req_sid = 0;
+        t->req_sid = sid;
         t->req_tid = allocate_id();
         t->req_abort = false;
         t->req_phys_indexed = false;
@@ -330,7 +330,7 @@ private:
         t = acquire_transaction<hpdcache_test_transaction_req>();
         t->req_op = hpdcache_test_transaction_req::HPDCACHE_REQ_AMO_SC;
         t->req_wdata = create_random_data();
-        t->req_sid = 0;
+        t->req_sid = sid;
         t->req_tid = allocate_id();
         t->req_addr = address;
         t->req_be = ((1UL << bytes) - 1) << offset;
@@ -85,6 +85,10 @@ private:
         // wait and consume driver acknowledgement (this is blocking)
         transaction_ret_i.read();
 
+#ifdef CREATE_FILE
+        instance_trace_writer()->write_in_file(t, delay->read());
+#endif
+
         // release the previously used transaction object
         release_transaction<hpdcache_test_transaction_req>(t);
 
@@ -111,7 +115,7 @@ private:
         t = acquire_transaction<hpdcache_test_transaction_req>();
         t->req_op = op->read();
         t->req_wdata = create_random_data();
-        t->req_sid = 0;
+        t->req_sid = sid;
         t->req_tid = allocate_id();
         t->req_abort = false;
         t->req_phys_indexed = false;
@@ -0,0 +1,548 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: Trace-driven functional simulator of the HPDcache. It replays
+ *               a trace (see hpdcache_trace_format.h) through a generic cache
+ *               directory and counts the same events as the RTL (evt_cache_*
+ *               performance counters), without the cost of the Verilated model
+ */
+#include <chrono>
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "generic_cache_directory_lru.h"
+#include "generic_cache_directory_plru.h"
+#include "generic_cache_directory_random.h"
+#include "hpdcache_test_defs.h"
+#include "hpdcache_test_trace_reader.h"
+
+#ifndef CONF_HPDCACHE_WB_ENABLE
+#define CONF_HPDCACHE_WB_ENABLE 1
+#endif
+
+#ifndef CONF_HPDCACHE_WT_ENABLE
+#define CONF_HPDCACHE_WT_ENABLE 1
+#endif
+
+//  Default nb of cycles between a miss and the refill of the cacheline
+#define FAST_SIM_MISS_LATENCY 16
+
+struct fast_sim_config
+{
+    size_t sets = HPDCACHE_SETS;
+    size_t ways = HPDCACHE_WAYS;
+    size_t line_bytes = (HPDCACHE_CL_WORDS * HPDCACHE_WORD_WIDTH) / 8;
+    size_t mshr_sets = HPDCACHE_MSHR_SETS;
+    size_t mshr_ways = HPDCACHE_MSHR_WAYS;
+    std::string policy = "plru";
+    bool default_wb = false;
+    bool wb_enable = CONF_HPDCACHE_WB_ENABLE;
+    bool wt_enable = CONF_HPDCACHE_WT_ENABLE;
+    unsigned miss_latency = FAST_SIM_MISS_LATENCY;
+};
+
+//  Counters with the same meaning as the performance events of the RTL (the names are the
+//  ones printed by the testbench scoreboard), and some events that are only visible on the
+//  memory interface of the RTL
+struct fast_sim_stats
+{
+    uint64_t nb_records = 0;
+    uint64_t read_req = 0;
+    uint64_t read_miss = 0;
+    uint64_t write_req = 0;
+    uint64_t write_miss = 0;
+    uint64_t prefetch_req = 0;
+    uint64_t uncached_req = 0;
+    uint64_t cmo_req = 0;
+    uint64_t refills = 0;
+    uint64_t evictions = 0;
+    uint64_t writebacks = 0;
+    uint64_t write_throughs = 0;
+    uint64_t mshr_hits = 0;
+    uint64_t mshr_full = 0;
+    uint64_t mshr_stall_cycles = 0;
+};
+
+class hpdcache_fast_sim
+{
+public:
+    hpdcache_fast_sim(const fast_sim_config& cfg)
+      : cfg(cfg)
+      , now(0)
+    {
+        if (cfg.policy == "plru") {
+            dir.reset(new GenericCacheDirectoryPlru("dir", cfg.ways, cfg.sets, cfg.line_bytes));
+        } else if (cfg.policy == "lru") {
+            dir.reset(new GenericCacheDirectoryLru("dir", cfg.ways, cfg.sets, cfg.line_bytes));
+        } else if (cfg.policy == "random") {
+            dir.reset(new GenericCacheDirectoryRandom("dir", cfg.ways, cfg.sets, cfg.line_bytes));
+        } else {
+            std::cout << "error: unknown replacement policy " << cfg.policy << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        dir->reset();
+
+        dirty.assign(cfg.sets * cfg.ways, false);
+        wback.assign(cfg.sets * cfg.ways, false);
+        ready.assign(cfg.sets * cfg.ways, 0);
+        mshr.resize(cfg.mshr_sets);
+    }
+
+    const fast_sim_stats& get_stats() const { return stats; }
+
+    uint64_t get_cycles() const { return now; }
+
+    void access(const trace_record_t& r)
+    {
+        stats.nb_records++;
+        now += r.delay + 1;
+
+        const unsigned op = r.op;
+        const unsigned hint = r.full ? ((r.attr >> 3) & 0x7) : HPDCACHE_TRACE_WR_POLICY_AUTO;
+        size_t way, set;
+
+        //  aborted requests are not executed by the cache
+        if (r.full && (r.attr & 0x4)) {
+            return;
+        }
+
+        if ((op >= HPDCACHE_TRACE_OP_CMO_FENCE) && (op != HPDCACHE_TRACE_OP_CMO_PREFETCH)) {
+            cmo(r);
+            return;
+        }
+
+        if (r.uncacheable) {
+            //  a cached copy of the line is flushed (if dirty) and invalidated
+            stats.uncached_req++;
+            if (dir->hit(r.addr, &way, &set)) {
+                flush(way, set);
+                dir->inval(way, set);
+            }
+            return;
+        }
+
+        if ((op >= HPDCACHE_TRACE_OP_AMO_LR) && (op <= HPDCACHE_TRACE_OP_AMO_MINU)) {
+            //  AMOs are executed by the memory, the cached copy is flushed (if dirty) first
+            stats.uncached_req++;
+            if (dir->access(r.addr, &way, &set)) {
+                flush(way, set);
+            }
+            return;
+        }
+
+        if (op == HPDCACHE_TRACE_OP_STORE) {
+            store(r.addr, hint);
+        } else {
+            load(r.addr, hint, op == HPDCACHE_TRACE_OP_CMO_PREFETCH);
+        }
+    }
+
+private:
+    fast_sim_config cfg;
+    fast_sim_stats stats;
+    std::unique_ptr<GenericCacheDirectoryBase> dir;
+
+    //  per-cacheline state, same indexing than the directory
+    std::vector<bool> dirty;
+    std::vector<bool> wback;
+    std::vector<uint64_t> ready;
+
+    //  refill completion times of the pending misses, per MSHR set
+    std::vector<std::vector<uint64_t>> mshr;
+    uint64_t now;
+
+    inline size_t idx(size_t way, size_t set) const { return way * cfg.sets + set; }
+
+    //  resolve the write policy of a request (auto follows the state of the line, if any)
+    inline bool is_wb(unsigned hint, bool hit_wback) const
+    {
+        bool wb;
+        if (hint == HPDCACHE_TRACE_WR_POLICY_WB) {
+            wb = true;
+        } else if (hint == HPDCACHE_TRACE_WR_POLICY_WT) {
+            wb = false;
+        } else {
+            wb = hit_wback;
+        }
+        return (wb && cfg.wb_enable) || !cfg.wt_enable;
+    }
+
+    //  write back a dirty cacheline to the memory
+    inline void flush(size_t way, size_t set)
+    {
+        if (dirty[idx(way, set)]) {
+            stats.writebacks++;
+            dirty[idx(way, set)] = false;
+        }
+    }
+
+    //  the target cacheline is being refilled: the request waits for the refill (MSHR hit)
+    inline void wait_refill(size_t way, size_t set)
+    {
+        if (ready[idx(way, set)] > now) {
+            stats.mshr_hits++;
+        }
+    }
+
+    //  allocate a MSHR entry for a new miss. When the MSHR set is full, the request waits for
+    //  the first pending refill of that set
+    void mshr_alloc(uint64_t nline)
+    {
+        if (cfg.miss_latency == 0) {
+            return;
+        }
+
+        std::vector<uint64_t>& s = mshr[nline % cfg.mshr_sets];
+        size_t n = 0;
+        for (size_t i = 0; i < s.size(); i++) {
+            if (s[i] > now) s[n++] = s[i];
+        }
+        s.resize(n);
+
+        if (s.size() >= cfg.mshr_ways) {
+            uint64_t first = s[0];
+            size_t first_i = 0;
+            for (size_t i = 1; i < s.size(); i++) {
+                if (s[i] < first) {
+                    first = s[i];
+                    first_i = i;
+                }
+            }
+            stats.mshr_full++;
+            stats.mshr_stall_cycles += first - now;
+            now = first;
+            s.erase(s.begin() + first_i);
+        }
+        s.push_back(now + cfg.miss_latency);
+    }
+
+    //  select a victim cacheline and refill it with the target cacheline
+    void refill(uint64_t addr, bool wb)
+    {
+        uint64_t victim_tag;
+        size_t way, set;
+
+        mshr_alloc(dir->getNline(addr));
+        if (dir->alloc(addr, &way, &set, &victim_tag)) {
+            stats.evictions++;
+            flush(way, set);
+        }
+        stats.refills++;
+        dirty[idx(way, set)] = false;
+        wback[idx(way, set)] = wb;
+        ready[idx(way, set)] = now + cfg.miss_latency;
+    }
+
+    void load(uint64_t addr, unsigned hint, bool prefetch)
+    {
+        size_t way, set;
+
+        if (prefetch) {
+            stats.prefetch_req++;
+        } else {
+            stats.read_req++;
+        }
+
+        //  prefetches do not update the replacement state on hits (cfg_prefetch_updt_plru is
+        //  not set by the testbench)
+        if (dir->access(addr, &way, &set, !prefetch)) {
+            wait_refill(way, set);
+
+            //  the write policy hint changes the state of the cacheline
+            const size_t i = idx(way, set);
+            if ((hint == HPDCACHE_TRACE_WR_POLICY_WT) && wback[i]) {
+                flush(way, set);
+                wback[i] = false;
+            } else if ((hint == HPDCACHE_TRACE_WR_POLICY_WB) && !wback[i]) {
+                wback[i] = true;
+            }
+            return;
+        }
+
+        if (!prefetch) {
+            stats.read_miss++;
+        }
+        refill(addr, is_wb(hint, cfg.default_wb));
+    }
+
+    void store(uint64_t addr, unsigned hint)
+    {
+        size_t way, set;
+
+        stats.write_req++;
+        if (dir->hit(addr, &way, &set)) {
+            const size_t i = idx(way, set);
+            wait_refill(way, set);
+            dir->replUpdate(way, set);
+            if (is_wb(hint, wback[i])) {
+                dirty[i] = true;
+                wback[i] = true;
+            } else {
+                //  a dirty cacheline is flushed before being written through
+                flush(way, set);
+                wback[i] = false;
+                stats.write_throughs++;
+            }
+            return;
+        }
+
+        stats.write_miss++;
+        if (is_wb(hint, cfg.default_wb)) {
+            //  write-allocate
+            refill(addr, true);
+            dir->hit(addr, &way, &set);
+            dirty[idx(way, set)] = true;
+        } else {
+            stats.write_throughs++;
+        }
+    }
+
+    void cmo(const trace_record_t& r)
+    {
+        bool all, do_flush, do_inval;
+        size_t way, set;
+
+        stats.cmo_req++;
+        switch (r.op) {
+            case HPDCACHE_TRACE_OP_CMO_INVAL_NLINE:
+                all = false, do_flush = false, do_inval = true;
+                break;
+            case HPDCACHE_TRACE_OP_CMO_INVAL_ALL:
+                all = true, do_flush = false, do_inval = true;
+                break;
+            case HPDCACHE_TRACE_OP_CMO_FLUSH_NLINE:
+                all = false, do_flush = true, do_inval = false;
+                break;
+            case HPDCACHE_TRACE_OP_CMO_FLUSH_ALL:
+                all = true, do_flush = true, do_inval = false;
+                break;
+            case HPDCACHE_TRACE_OP_CMO_FLUSH_INVAL_NLINE:
+                all = false, do_flush = true, do_inval = true;
+                break;
+            case HPDCACHE_TRACE_OP_CMO_FLUSH_INVAL_ALL:
+                all = true, do_flush = true, do_inval = true;
+                break;
+            default:
+                //  fences do not change the content of the cache
+                return;
+        }
+
+        if (all) {
+            for (set = 0; set < cfg.sets; set++) {
+                for (way = 0; way < cfg.ways; way++) {
+                    if (!dir->getCacheValid(way, set)) continue;
+                    if (do_flush) flush(way, set);
+                    if (do_inval) dir->inval(way, set);
+                }
+            }
+        } else if (dir->hit(r.addr, &way, &set)) {
+            if (do_flush) flush(way, set);
+            if (do_inval) dir->inval(way, set);
+        }
+    }
+};
+
+static void
+print_usage(const char* prog)
+{
+    std::cout << "usage: " << prog << " -f <trace> [options]" << std::endl
+              << "  -f, --trace <file>        trace to replay" << std::endl
+              << "  -s, --sets <n>            nb of sets (" << HPDCACHE_SETS << ")" << std::endl
+              << "  -w, --ways <n>            nb of ways (" << HPDCACHE_WAYS << ")" << std::endl
+              << "  -b, --line-bytes <n>      bytes per cacheline ("
+              << (HPDCACHE_CL_WORDS * HPDCACHE_WORD_WIDTH) / 8 << ")" << std::endl
+              << "  -p, --policy <name>       replacement policy: plru, lru or random (plru)"
+              << std::endl
+              << "  -d, --default-wb          write-back policy by default (write-through)"
+              << std::endl
+              << "  -m, --mshr-sets <n>       nb of MSHR sets (" << HPDCACHE_MSHR_SETS << ")"
+              << std::endl
+              << "  -M, --mshr-ways <n>       nb of MSHR ways (" << HPDCACHE_MSHR_WAYS << ")"
+              << std::endl
+              << "  -l, --miss-latency <n>    cycles to refill a cacheline ("
+              << FAST_SIM_MISS_LATENCY << ", 0: no MSHR model)" << std::endl
+              << "  -o, --trace-roi <i>       replay only the given region of interest"
+              << std::endl
+              << "  -k, --trace-skip <n>      nb of records to skip" << std::endl
+              << "  -n, --max-records <n>     stop after n records" << std::endl
+              << "  -P, --perf-file <file>    write the miss rates in the given file"
+              << std::endl;
+}
+
+int
+main(int argc, char** argv)
+{
+    fast_sim_config cfg;
+    std::string trace_name;
+    std::string perf_name;
+    int trace_roi = -1;
+    uint64_t trace_skip = 0;
+    uint64_t max_records = UINT64_MAX;
+
+    for (;;) {
+        static struct option long_options[] = { { "trace", required_argument, 0, 'f' },
+                                                { "sets", required_argument, 0, 's' },
+                                                { "ways", required_argument, 0, 'w' },
+                                                { "line-bytes", required_argument, 0, 'b' },
+                                                { "policy", required_argument, 0, 'p' },
+                                                { "default-wb", no_argument, 0, 'd' },
+                                                { "mshr-sets", required_argument, 0, 'm' },
+                                                { "mshr-ways", required_argument, 0, 'M' },
+                                                { "miss-latency", required_argument, 0, 'l' },
+                                                { "trace-roi", required_argument, 0, 'o' },
+                                                { "trace-skip", required_argument, 0, 'k' },
+                                                { "max-records", required_argument, 0, 'n' },
+                                                { "perf-file", required_argument, 0, 'P' },
+                                                { "help", no_argument, 0, 'h' },
+                                                { 0, 0, 0, 0 } };
+        int option_index = 0;
+        int c = getopt_long(
+          argc, argv, "f:s:w:b:p:dm:M:l:o:k:n:P:h", long_options, &option_index);
+        if (c == -1) break;
+
+        switch (c) {
+            case 'f':
+                trace_name = optarg;
+                break;
+            case 's':
+                cfg.sets = strtoul(optarg, NULL, 0);
+                break;
+            case 'w':
+                cfg.ways = strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                cfg.line_bytes = strtoul(optarg, NULL, 0);
+                break;
+            case 'p':
+                cfg.policy = optarg;
+                break;
+            case 'd':
+                cfg.default_wb = true;
+                break;
+            case 'm':
+                cfg.mshr_sets = strtoul(optarg, NULL, 0);
+                break;
+            case 'M':
+                cfg.mshr_ways = strtoul(optarg, NULL, 0);
+                break;
+            case 'l':
+                cfg.miss_latency = strtoul(optarg, NULL, 0);
+                break;
+            case 'o':
+                trace_roi = atoi(optarg);
+                break;
+            case 'k':
+                trace_skip = strtoull(optarg, NULL, 0);
+                break;
+            case 'n':
+                max_records = strtoull(optarg, NULL, 0);
+                break;
+            case 'P':
+                perf_name = optarg;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (trace_name.empty()) {
+        std::cout << "error: a trace is needed (-f option)" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if ((cfg.sets == 0) || (cfg.ways == 0) || (cfg.line_bytes == 0) || (cfg.mshr_sets == 0) ||
+        (cfg.mshr_ways == 0))
+    {
+        std::cout << "error: the geometry of the cache and of the MSHR shall not be zero"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    hpdcache_fast_sim sim(cfg);
+    trace_prefetcher trace(trace_name, trace_roi, trace_skip);
+    trace_record_t r;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t n = 0; (n < max_records) && trace.pop(r); n++) {
+        sim.access(r);
+    }
+    auto end = std::chrono::steady_clock::now();
+    trace.my_close();
+    if (trace.has_failed()) {
+        std::cout << "error: " << trace.get_error() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const fast_sim_stats& s = sim.get_stats();
+    const double read_miss_rate = s.read_req > 0 ? (double)s.read_miss / s.read_req : 0;
+    const double write_miss_rate = s.write_req > 0 ? (double)s.write_miss / s.write_req : 0;
+    const double sec = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "FAST SIMULATOR STATISTICS" << std::endl
+              << "Configuration" << std::endl
+              << "--------------------------------------------------" << std::endl
+              << "Sets x ways x bytes      : " << cfg.sets << " x " << cfg.ways << " x "
+              << cfg.line_bytes << std::endl
+              << "Replacement policy      : " << cfg.policy << std::endl
+              << "Default write policy    : " << (cfg.default_wb ? "write-back" : "write-through")
+              << std::endl
+              << "MSHR sets x ways        : " << cfg.mshr_sets << " x " << cfg.mshr_ways
+              << std::endl
+              << "Miss latency            : " << cfg.miss_latency << std::endl
+              << std::endl
+
+              << "Instrumentation" << std::endl
+              << "--------------------------------------------------" << std::endl
+              << "SIM.NB_RECORDS          : " << s.nb_records << std::endl
+              << "SIM.NB_CYCLES           : " << sim.get_cycles() << std::endl
+              << "SIM.REFILLS             : " << s.refills << std::endl
+              << "SIM.EVICTIONS           : " << s.evictions << std::endl
+              << "SIM.WRITEBACKS          : " << s.writebacks << std::endl
+              << "SIM.WRITE_THROUGHS      : " << s.write_throughs << std::endl
+              << "SIM.MSHR_HITS           : " << s.mshr_hits << std::endl
+              << "SIM.MSHR_FULL           : " << s.mshr_full << std::endl
+              << "SIM.MSHR_STALL_CYCLES   : " << s.mshr_stall_cycles << std::endl
+              << "CACHE.WRITE_MISSES      : " << s.write_miss << std::endl
+              << "CACHE.READ_MISSES       : " << s.read_miss << std::endl
+              << "CACHE.UNCACHED_REQUESTS : " << s.uncached_req << std::endl
+              << "CACHE.CMO_REQUESTS      : " << s.cmo_req << std::endl
+              << "CACHE.WRITE_REQUESTS    : " << s.write_req << std::endl
+              << "CACHE.READ_REQUESTS     : " << s.read_req << std::endl
+              << "CACHE.PREFETCH_REQUESTS : " << s.prefetch_req << std::endl
+              << std::endl
+
+              << "Computed values" << std::endl
+              << "---------------" << std::endl
+              << "Read miss rate          : " << read_miss_rate << std::endl
+              << "Write miss rate         : " << write_miss_rate << std::endl
+              << std::fixed << std::setprecision(3)
+              << "Wall time               : " << sec << " s" << std::endl
+              << std::setprecision(0)
+              << "Records/s               : " << (sec > 0 ? s.nb_records / sec : 0) << std::endl;
+
+    if (!perf_name.empty()) {
+        std::ofstream perf(perf_name);
+        if (!perf) {
+            std::cout << "error: cannot create " << perf_name << std::endl;
+            return EXIT_FAILURE;
+        }
+        perf << "cycles=" << sim.get_cycles() << std::endl
+             << "read_miss_rate=" << read_miss_rate << std::endl
+             << "write_miss_rate=" << write_miss_rate << std::endl;
+    }
+
+    return 0;
+}
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker
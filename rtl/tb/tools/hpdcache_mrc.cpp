@@ -0,0 +1,556 @@
+/**
+ *  Copyright 2026 Inria, Universite Grenoble-Alpes, TIMA
+ *
+ *  SPDX-License-Identifier: Apache-2.0 WITH SHL-2.1
+ */
+/**
+ *  Date       : October, 2026
+ *  Description: One-pass miss ratio curve (MRC) generator. It computes the
+ *               LRU stack distances of the accesses of a trace (see
+ *               hpdcache_trace_format.h) and, in a single pass, derives the
+ *               miss ratio of every number of sets and ways for the cacheline
+ *               sizes of the given configurations (configs/<name>.mk)
+ */
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "hpdcache_test_defs.h"
+#include "hpdcache_test_trace_reader.h"
+
+//  Largest legal nb of sets (see HPDCACHE_TEST_DEFS_LOG2)
+#define MRC_MAX_SETS 16384
+
+//  Default largest nb of ways
+#define MRC_MAX_WAYS 32
+
+//  Sets are always simulated when there are at most this nb of sets, whatever the sampling rate
+#define MRC_MIN_SAMPLED_SETS 64
+
+//  Resolution of the sampling thresholds
+#define MRC_HASH_BITS 24
+
+//  Mix the bits of a value (SplitMix64 finalizer), used to select the sampled sets and lines
+static inline uint64_t
+mrc_hash(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static inline unsigned
+mrc_log2(uint64_t x)
+{
+    unsigned n = 0;
+    while (x > 1) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+}
+
+//  Geometry of a configuration of the testbench
+struct mrc_config
+{
+    std::string name;
+    size_t sets;
+    size_t ways;
+    size_t line_bytes;
+};
+
+//  Histograms of the stack distances of the read and write accesses. The last bucket counts
+//  the accesses that miss in the deepest modelled cache (including the cold misses)
+struct mrc_histogram
+{
+    std::vector<uint64_t> rd;
+    std::vector<uint64_t> wr;
+
+    void resize(size_t n)
+    {
+        rd.assign(n + 1, 0);
+        wr.assign(n + 1, 0);
+    }
+
+    inline void add(size_t bucket, bool is_write)
+    {
+        if (is_write) {
+            wr[bucket]++;
+        } else {
+            rd[bucket]++;
+        }
+    }
+
+    //  nb of accesses whose bucket is greater or equal to b
+    uint64_t misses(const std::vector<uint64_t>& h, size_t b) const
+    {
+        uint64_t n = 0;
+        for (size_t i = b; i < h.size(); i++) n += h[i];
+        return n;
+    }
+
+    uint64_t total(const std::vector<uint64_t>& h) const { return misses(h, 0); }
+};
+
+/**
+ * @class mrc_set_assoc
+ * @brief Per-set LRU stacks of a cache with a given nb of sets. Thanks to the inclusion property
+ *        of LRU, the depth in its set of each access gives at once whether it hits or misses for
+ *        any nb of ways. When the cache has many sets, only a sample of the sets is simulated
+ *        (set sampling), the sets are independent so the miss ratio is unbiased
+ */
+class mrc_set_assoc
+{
+public:
+    mrc_set_assoc(size_t sets, size_t max_ways, double rate)
+      : sets(sets)
+      , set_bits(mrc_log2(sets))
+      , depth(max_ways)
+    {
+        const double r = std::max(rate, std::min(1.0, (double)MRC_MIN_SAMPLED_SETS / sets));
+        const uint64_t threshold = (uint64_t)(r * (1ULL << MRC_HASH_BITS));
+
+        slot.assign(sets, -1);
+        size_t n = 0;
+        for (size_t s = 0; s < sets; s++) {
+            if ((mrc_hash(s) & ((1ULL << MRC_HASH_BITS) - 1)) < threshold) {
+                slot[s] = n++;
+            }
+        }
+        stack.assign(n * depth, 0);
+        count.assign(n, 0);
+        hist.resize(depth);
+    }
+
+    inline void access(uint64_t nline, bool is_write)
+    {
+        const int64_t k = slot[nline & (sets - 1)];
+        if (k < 0) {
+            return;
+        }
+
+        //  tags are stored plus one, so that zero marks an empty entry
+        const uint64_t tag = (nline >> set_bits) + 1;
+        uint64_t* st = &stack[k * depth];
+        uint32_t& cnt = count[k];
+
+        size_t d = 0;
+        while ((d < cnt) && (st[d] != tag)) d++;
+        hist.add((d < cnt) ? d : depth, is_write);
+
+        //  move (or insert) the line on the top of the stack
+        if (d == cnt) {
+            if (cnt < depth) cnt++;
+            d = cnt - 1;
+        }
+        for (; d > 0; d--) st[d] = st[d - 1];
+        st[0] = tag;
+    }
+
+    size_t get_sets() const { return sets; }
+
+    const mrc_histogram& get_histogram() const { return hist; }
+
+private:
+    size_t sets;
+    unsigned set_bits;
+    size_t depth;
+    std::vector<int64_t> slot;
+    std::vector<uint64_t> stack;
+    std::vector<uint32_t> count;
+    mrc_histogram hist;
+};
+
+/**
+ * @class mrc_fully_assoc
+ * @brief Stack distances of a fully associative LRU cache of unbounded size. The distance of an
+ *        access is the nb of distinct lines accessed since the previous access to the same line.
+ *        It is counted with a Fenwick tree that marks the time of the last access of each line.
+ *        When the sampling rate is lower than 1, only the lines whose hash is below a threshold
+ *        are considered, and the distances are scaled by the inverse of the rate (SHARDS)
+ */
+class mrc_fully_assoc
+{
+public:
+    mrc_fully_assoc(double rate)
+      : rate(rate)
+      , threshold((uint64_t)(rate * (1ULL << MRC_HASH_BITS)))
+      , now(0)
+    {
+        tree.assign(1 << 16, 0);
+        hist.resize(64);
+    }
+
+    inline void access(uint64_t nline, bool is_write)
+    {
+        if ((mrc_hash(nline) & ((1ULL << MRC_HASH_BITS) - 1)) >= threshold) {
+            return;
+        }
+
+        if (now + 1 >= tree.size()) {
+            compact();
+        }
+        now++;
+
+        auto it = last.find(nline);
+        if (it == last.end()) {
+            hist.add(64, is_write);
+            last.emplace(nline, now);
+        } else {
+            //  nb of lines whose last access is after the previous access to this line
+            const uint64_t d = prefix(now - 1) - prefix(it->second);
+            const uint64_t scaled = (uint64_t)(d / rate);
+            hist.add(bit_length(scaled), is_write);
+            update(it->second, -1);
+            it->second = now;
+        }
+        update(now, 1);
+    }
+
+    //  the bucket of a distance d is its bit length: d < 2^k iff bucket <= k
+    const mrc_histogram& get_histogram() const { return hist; }
+
+private:
+    double rate;
+    uint64_t threshold;
+    uint64_t now;
+    std::vector<int32_t> tree;
+    std::unordered_map<uint64_t, uint64_t> last;
+    mrc_histogram hist;
+
+    static inline size_t bit_length(uint64_t x)
+    {
+        size_t n = 0;
+        while (x) {
+            x >>= 1;
+            n++;
+        }
+        return std::min(n, (size_t)63);
+    }
+
+    inline void update(uint64_t i, int32_t v)
+    {
+        for (; i < tree.size(); i += i & -i) tree[i] += v;
+    }
+
+    inline uint64_t prefix(uint64_t i) const
+    {
+        int64_t s = 0;
+        for (; i > 0; i -= i & -i) s += tree[i];
+        return s;
+    }
+
+    //  renumber the last access times in their order, and grow the tree if needed
+    void compact()
+    {
+        std::vector<std::pair<uint64_t, uint64_t>> order;
+        order.reserve(last.size());
+        for (auto& e : last) order.emplace_back(e.second, e.first);
+        std::sort(order.begin(), order.end());
+
+        size_t sz = tree.size();
+        while (sz < 2 * (order.size() + 1)) sz <<= 1;
+        tree.assign(sz, 0);
+
+        now = 0;
+        for (auto& e : order) {
+            last[e.second] = ++now;
+            update(now, 1);
+        }
+    }
+};
+
+//  All the analyses of a given cacheline size
+struct mrc_line_size
+{
+    size_t line_bytes;
+    std::vector<std::unique_ptr<mrc_set_assoc>> set_assoc;
+    std::unique_ptr<mrc_fully_assoc> fully_assoc;
+};
+
+static bool
+read_config(const std::string& file_name, mrc_config& cfg)
+{
+    std::ifstream f(file_name);
+    if (!f) {
+        return false;
+    }
+
+    std::map<std::string, size_t> values;
+    std::string line;
+    while (std::getline(f, line)) {
+        const size_t eq = line.find('=');
+        if ((eq == std::string::npos) || (line.compare(0, 14, "CONF_HPDCACHE_") != 0)) {
+            continue;
+        }
+        values[line.substr(0, eq)] = strtoul(line.c_str() + eq + 1, NULL, 0);
+    }
+
+    const size_t base = file_name.find_last_of('/') + 1;
+    cfg.name = file_name.substr(base, file_name.rfind(".mk") - base);
+    cfg.sets = values["CONF_HPDCACHE_SETS"];
+    cfg.ways = values["CONF_HPDCACHE_WAYS"];
+    cfg.line_bytes = (values["CONF_HPDCACHE_CL_WORDS"] * values["CONF_HPDCACHE_WORD_WIDTH"]) / 8;
+    return (cfg.sets > 0) && (cfg.ways > 0) && (cfg.line_bytes > 0);
+}
+
+static void
+print_usage(const char* prog)
+{
+    std::cout << "usage: " << prog << " -f <trace> [-c <config.mk> ...] [options]" << std::endl
+              << "  -f, --trace <file>        trace to analyze" << std::endl
+              << "  -c, --config <file>       configuration (configs/*.mk) to evaluate. Its "
+                 "cacheline size is swept"
+              << std::endl
+              << "  -b, --line-bytes <n>      additional cacheline size to sweep" << std::endl
+              << "  -S, --max-sets <n>        largest nb of sets (" << MRC_MAX_SETS << ")"
+              << std::endl
+              << "  -W, --max-ways <n>        largest nb of ways (" << MRC_MAX_WAYS << ")"
+              << std::endl
+              << "  -R, --rate <r>            sampling rate of sets and lines (1.0: exact)"
+              << std::endl
+              << "  -L, --loads-only          ignore the stores (write-through, no allocation)"
+              << std::endl
+              << "  -x, --csv <file>          write the curves in a CSV file" << std::endl
+              << "  -o, --trace-roi <i>       analyze only the given region of interest"
+              << std::endl
+              << "  -k, --trace-skip <n>      nb of records to skip" << std::endl;
+}
+
+int
+main(int argc, char** argv)
+{
+    std::string trace_name;
+    std::string csv_name;
+    std::vector<mrc_config> configs;
+    std::vector<size_t> line_sizes;
+    size_t max_sets = MRC_MAX_SETS;
+    size_t max_ways = MRC_MAX_WAYS;
+    double rate = 1.0;
+    bool loads_only = false;
+    int trace_roi = -1;
+    uint64_t trace_skip = 0;
+
+    for (;;) {
+        static struct option long_options[] = { { "trace", required_argument, 0, 'f' },
+                                                { "config", required_argument, 0, 'c' },
+                                                { "line-bytes", required_argument, 0, 'b' },
+                                                { "max-sets", required_argument, 0, 'S' },
+                                                { "max-ways", required_argument, 0, 'W' },
+                                                { "rate", required_argument, 0, 'R' },
+                                                { "loads-only", no_argument, 0, 'L' },
+                                                { "csv", required_argument, 0, 'x' },
+                                                { "trace-roi", required_argument, 0, 'o' },
+                                                { "trace-skip", required_argument, 0, 'k' },
+                                                { "help", no_argument, 0, 'h' },
+                                                { 0, 0, 0, 0 } };
+        int option_index = 0;
+        int c = getopt_long(argc, argv, "f:c:b:S:W:R:Lx:o:k:h", long_options, &option_index);
+        if (c == -1) break;
+
+        mrc_config cfg;
+        switch (c) {
+            case 'f':
+                trace_name = optarg;
+                break;
+            case 'c':
+                if (!read_config(optarg, cfg)) {
+                    std::cout << "error: cannot read the geometry of the cache in " << optarg
+                              << std::endl;
+                    return EXIT_FAILURE;
+                }
+                configs.push_back(cfg);
+                break;
+            case 'b':
+                line_sizes.push_back(strtoul(optarg, NULL, 0));
+                break;
+            case 'S':
+                max_sets = strtoul(optarg, NULL, 0);
+                break;
+            case 'W':
+                max_ways = strtoul(optarg, NULL, 0);
+                break;
+            case 'R':
+                rate = atof(optarg);
+                break;
+            case 'L':
+                loads_only = true;
+                break;
+            case 'x':
+                csv_name = optarg;
+                break;
+            case 'o':
+                trace_roi = atoi(optarg);
+                break;
+            case 'k':
+                trace_skip = strtoull(optarg, NULL, 0);
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (trace_name.empty()) {
+        std::cout << "error: a trace is needed (-f option)" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if ((rate <= 0) || (rate > 1)) {
+        std::cout << "error: the sampling rate shall be in (0, 1]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if ((max_ways == 0) || (max_sets == 0) || (max_sets > MRC_MAX_SETS) ||
+        (max_sets & (max_sets - 1)))
+    {
+        std::cout << "error: the nb of sets shall be a power of 2 (up to " << MRC_MAX_SETS
+                  << "), and the nb of ways shall not be zero" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    //  the configurations shall fit in the sweep
+    for (const mrc_config& cfg : configs) {
+        line_sizes.push_back(cfg.line_bytes);
+        max_sets = std::max(max_sets, cfg.sets);
+        max_ways = std::max(max_ways, cfg.ways);
+    }
+    if (line_sizes.empty()) {
+        line_sizes.push_back((HPDCACHE_CL_WORDS * HPDCACHE_WORD_WIDTH) / 8);
+    }
+    std::sort(line_sizes.begin(), line_sizes.end());
+    line_sizes.erase(std::unique(line_sizes.begin(), line_sizes.end()), line_sizes.end());
+
+    std::vector<mrc_line_size> analyses(line_sizes.size());
+    for (size_t i = 0; i < line_sizes.size(); i++) {
+        analyses[i].line_bytes = line_sizes[i];
+        for (size_t sets = 1; sets <= max_sets; sets <<= 1) {
+            analyses[i].set_assoc.emplace_back(new mrc_set_assoc(sets, max_ways, rate));
+        }
+        analyses[i].fully_assoc.reset(new mrc_fully_assoc(rate));
+    }
+
+    //  single pass on the trace
+    trace_prefetcher trace(trace_name, trace_roi, trace_skip);
+    trace_record_t r;
+    uint64_t nb_records = 0;
+    uint64_t nb_accesses = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (trace.pop(r)) {
+        nb_records++;
+
+        //  only the cacheable loads, stores and prefetches allocate lines in the cache
+        const bool is_write = (r.op == HPDCACHE_TRACE_OP_STORE);
+        if (r.uncacheable || (r.full && (r.attr & 0x4)) || (is_write && loads_only) ||
+            ((r.op != HPDCACHE_TRACE_OP_LOAD) && !is_write &&
+             (r.op != HPDCACHE_TRACE_OP_CMO_PREFETCH)))
+        {
+            continue;
+        }
+        nb_accesses++;
+
+        for (mrc_line_size& a : analyses) {
+            const uint64_t nline = r.addr / a.line_bytes;
+            for (auto& sa : a.set_assoc) {
+                sa->access(nline, is_write);
+            }
+            a.fully_assoc->access(nline, is_write);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    trace.my_close();
+    if (trace.has_failed()) {
+        std::cout << "error: " << trace.get_error() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    //  miss ratios of all the points of the curves
+    std::stringstream csv;
+    csv << "model,line_bytes,sets,ways,capacity_bytes,read_miss_ratio,write_miss_ratio,"
+        << "miss_ratio,configs" << std::endl;
+
+    auto ratio = [](uint64_t n, uint64_t d) { return d > 0 ? (double)n / d : 0.0; };
+    auto print_point = [&](const char* model,
+                           size_t line_bytes,
+                           size_t sets,
+                           size_t ways,
+                           const mrc_histogram& h,
+                           size_t bucket) {
+        const uint64_t rd = h.total(h.rd), wr = h.total(h.wr);
+        const uint64_t rd_miss = h.misses(h.rd, bucket), wr_miss = h.misses(h.wr, bucket);
+        std::string names;
+        for (const mrc_config& cfg : configs) {
+            if ((cfg.line_bytes == line_bytes) && (cfg.sets == sets) && (cfg.ways == ways) &&
+                (model[0] == 's'))
+            {
+                names += (names.empty() ? "" : " ") + cfg.name;
+            }
+        }
+        csv << model << "," << line_bytes << "," << sets << "," << ways << ","
+            << sets * ways * line_bytes << "," << ratio(rd_miss, rd) << ","
+            << ratio(wr_miss, wr) << "," << ratio(rd_miss + wr_miss, rd + wr) << "," << names
+            << std::endl;
+    };
+
+    for (const mrc_line_size& a : analyses) {
+        for (const auto& sa : a.set_assoc) {
+            for (size_t ways = 1; ways <= max_ways; ways++) {
+                print_point("set_assoc", a.line_bytes, sa->get_sets(), ways,
+                            sa->get_histogram(), ways);
+            }
+        }
+        for (size_t k = 0; (1ULL << k) <= max_sets * max_ways; k++) {
+            print_point("fully_assoc", a.line_bytes, 1, 1ULL << k,
+                        a.fully_assoc->get_histogram(), k + 1);
+        }
+    }
+
+    //  summary of the given configurations
+    const double sec = std::chrono::duration<double>(end - start).count();
+    std::cout << "MISS RATIO CURVES" << std::endl
+              << "--------------------------------------------------" << std::endl
+              << "Records                 : " << nb_records << std::endl
+              << "Cacheable accesses      : " << nb_accesses << std::endl
+              << "Sampling rate           : " << rate << std::endl;
+    for (const mrc_config& cfg : configs) {
+        for (const mrc_line_size& a : analyses) {
+            if (a.line_bytes != cfg.line_bytes) continue;
+            const mrc_histogram& h = a.set_assoc[mrc_log2(cfg.sets)]->get_histogram();
+            std::cout << std::left << std::setw(24) << cfg.name << ": " << cfg.sets << " x "
+                      << cfg.ways << " x " << cfg.line_bytes << " bytes, miss ratio "
+                      << ratio(h.misses(h.rd, cfg.ways) + h.misses(h.wr, cfg.ways),
+                               h.total(h.rd) + h.total(h.wr))
+                      << std::endl;
+        }
+    }
+    std::cout << std::fixed << std::setprecision(3) << "Wall time               : " << sec
+              << " s" << std::endl
+              << std::setprecision(0)
+              << "Records/s               : " << (sec > 0 ? nb_records / sec : 0) << std::endl;
+
+    if (csv_name.empty()) {
+        std::cout << std::endl << csv.str();
+    } else {
+        std::ofstream f(csv_name);
+        if (!f) {
+            std::cout << "error: cannot create " << csv_name << std::endl;
+            return EXIT_FAILURE;
+        }
+        f << csv.str();
+    }
+
+    return 0;
+}
+// vim: ts=4 : sts=4 : sw=4 : et : tw=100 : spell : spelllang=en : fdm=marker